@@ -13,6 +13,8 @@ SUBDIRS= \
 	buildfiles/unprocessed_raw.pro \
 	buildfiles/4channels.pro  \
 	buildfiles/rawtextdump.pro  \
+	buildfiles/io_trace.pro  \
+	buildfiles/model_index_check.pro  \
 	buildfiles/openbayer_sample.pro  
 
 CONFIG-=qt
@@ -15,7 +15,7 @@ HEADERS=../libraw/libraw.h \
 	../internal/libraw_internal_funcs.h \
 	../internal/dcraw_defs.h ../internal/dcraw_fileio_defs.h \
 	../internal/dmp_include.h ../internal/libraw_cxx_defs.h \
-	../internal/x3f_tools.h 
+	../internal/x3f_tools.h ../internal/libraw_model_aliases.h 
 
 CONFIG +=precompiled_headers
 
@@ -58,7 +58,8 @@ SOURCES+= ../src/libraw_datastream.cpp ../src/decoders/canon_600.cpp \
 	../src/preprocessing/ext_preprocess.cpp ../src/preprocessing/raw2image.cpp \
 	../src/preprocessing/subtract_black.cpp ../src/tables/cameralist.cpp \
 	../src/tables/colorconst.cpp ../src/tables/colordata.cpp \
-	../src/tables/wblists.cpp ../src/utils/curves.cpp \
+	../src/tables/wblists.cpp ../src/utils/async.cpp ../src/utils/batch.cpp \
+	../src/utils/curves.cpp \
 	../src/utils/decoder_info.cpp ../src/utils/init_close_utils.cpp \
 	../src/utils/open.cpp ../src/utils/phaseone_processing.cpp \
 	../src/utils/read_utils.cpp ../src/utils/thumb_utils.cpp \
@@ -170,6 +170,9 @@ it under the terms of the one of two licenses as you choose:
 	void        packed_dng_load_raw();
     void        uncompressed_fp_dng_load_raw();
 	void        lossy_dng_load_raw();
+	int         lossy_dng_load_tiles(ushort cur[3][256]);
+	INT64       dng_tile_ranges(INT64 table, std::vector<INT64> &toffs,
+	                            std::vector<INT64> &tsizes, INT64 maxtile);
 //void        adobe_dng_load_raw_nc();
 
 // Pentax
@@ -241,6 +244,7 @@ it under the terms of the one of two licenses as you choose:
 #endif
 	unsigned    pana_data (int nb, unsigned *bytes);
 	void        panasonic_load_raw();
+	int         panasonic_load_raw_paged();
 //	void        panasonic_16x10_load_raw();
 	void        olympus_load_raw();
 //	void        olympus_cseries_load_raw();
@@ -356,6 +360,8 @@ it under the terms of the one of two licenses as you choose:
 	void ahd_interpolate_r_and_b_and_convert_to_cielab(int top, int left, ushort (*inout_rgb)[LIBRAW_AHD_TILE][LIBRAW_AHD_TILE][3], short (*out_lab)[LIBRAW_AHD_TILE][LIBRAW_AHD_TILE][3]);
 	void ahd_interpolate_build_homogeneity_map(int top, int left, short (*lab)[LIBRAW_AHD_TILE][LIBRAW_AHD_TILE][3], char (*out_homogeneity_map)[LIBRAW_AHD_TILE][2]);
 	void ahd_interpolate_combine_homogeneous_pixels(int top, int left, ushort (*rgb)[LIBRAW_AHD_TILE][LIBRAW_AHD_TILE][3], char (*homogeneity_map)[LIBRAW_AHD_TILE][2]);
+	void ahd_interpolate_rows(int chunk, int nchunks, char *buffer, volatile int *terminate_flag);
+	static void ahd_interpolate_task(void *, int);
 
 	void init_fuji_compr(struct fuji_compressed_params* info);
 	void init_fuji_block(struct fuji_compressed_block* info, const struct fuji_compressed_params *params, INT64 raw_offset, unsigned dsize);
@@ -0,0 +1,845 @@
+/* -*- C++ -*-
+ * File: internal/libraw_model_aliases.h
+ * Copyright 2019-2021 LibRaw LLC (info@libraw.org)
+
+LibRaw is free software; you can redistribute it and/or modify
+it under the terms of the one of two licenses as you choose:
+
+1. GNU LESSER GENERAL PUBLIC LICENSE version 2.1
+   (See file LICENSE.LGPL provided in LibRaw distribution archive for details).
+
+2. COMMON DEVELOPMENT AND DISTRIBUTION LICENSE (CDDL) Version 1.0
+   (See file LICENSE.CDDL provided in LibRaw distribution archive for details).
+
+ */
+
+/*
+   Model alias, unique id and per-maker rule tables used by
+   GetNormalizedModel() and the alias/id lookup indexes. Also included by
+   samples/model_index_check.cpp
+ */
+
+#ifndef LIBRAW_MODEL_ALIASES_H
+#define LIBRAW_MODEL_ALIASES_H
+
+#include <string.h>
+#include <algorithm>
+#include <utility>
+#include <vector>
+#include "libraw_cameraids.h"
+
+#if defined(LIBRAW_WIN32_CALLS) && !defined(strcasecmp)
+#define strcasecmp stricmp
+#endif
+#if defined(LIBRAW_WIN32_CALLS) && !defined(strncasecmp)
+#define strncasecmp strnicmp
+#endif
+
+struct model_id_t
+{
+  unsigned long long id;
+  char t_model[20];
+};
+
+/*
+   Sorted index over a { id, model } table: lookup by id is a binary search,
+   first table entry wins for duplicate ids.
+ */
+class model_id_index_t
+{
+  std::vector<std::pair<unsigned long long, int> > ids;
+  const model_id_t *table;
+
+public:
+  template <size_t N>
+  model_id_index_t(const model_id_t (&t)[N]) : ids(N), table(t)
+  {
+    for (size_t i = 0; i < N; i++)
+      ids[i] = std::make_pair(t[i].id, int(i));
+    std::sort(ids.begin(), ids.end());
+  }
+  const model_id_t *find(unsigned long long id) const
+  {
+    std::vector<std::pair<unsigned long long, int> >::const_iterator it =
+        std::lower_bound(ids.begin(), ids.end(), std::make_pair(id, -1));
+    return (it != ids.end() && it->first == id) ? &table[it->second] : NULL;
+  }
+};
+
+/*
+   Alias tables are lists of "@canonical", "alias", "alias", ... groups.
+   All names are sorted once (case-insensitively, ties in table order) and
+   looked up by binary search; the first matching entry in table order
+   wins, as with a linear scan. Canonical names always match exactly,
+   aliases exactly or (nocase_aliases) case-insensitively.
+ */
+class model_alias_index_t
+{
+  struct entry_t
+  {
+    const char *name, *canonical;
+    int pos;
+  };
+  std::vector<entry_t> entries;
+  int nocase;
+
+  static bool entry_less(const entry_t &a, const entry_t &b)
+  {
+    int r = strcasecmp(a.name, b.name);
+    return r < 0 || (r == 0 && a.pos < b.pos);
+  }
+  static bool name_less(const entry_t &a, const char *name)
+  {
+    return strcasecmp(a.name, name) < 0;
+  }
+
+public:
+  template <size_t N, size_t L>
+  model_alias_index_t(const char (&table)[N][L], int nocase_aliases = 0)
+      : nocase(nocase_aliases)
+  {
+    const char *canonical = NULL;
+    for (size_t i = 0; i < N; i++)
+    {
+      entry_t e;
+      if (table[i][0] == '@')
+        canonical = e.name = table[i] + 1;
+      else
+        e.name = table[i];
+      e.canonical = canonical;
+      e.pos = int(i);
+      if (canonical)
+        entries.push_back(e);
+    }
+    std::sort(entries.begin(), entries.end(), entry_less);
+  }
+
+  /*
+     Returns the canonical name for t_model or NULL if not found;
+     *alias is set to 1 if an alias (not a canonical name) matched.
+   */
+  const char *find(const char *t_model, int *alias,
+                   int aliases_only = 0) const
+  {
+    std::vector<entry_t>::const_iterator it =
+        std::lower_bound(entries.begin(), entries.end(), t_model, name_less);
+    for (; it != entries.end() && !strcasecmp(it->name, t_model); ++it)
+    {
+      int is_alias = it->name != it->canonical;
+      if (!is_alias && aliases_only)
+        continue;
+      if ((is_alias && nocase) || !strcmp(it->name, t_model))
+      {
+        *alias = is_alias;
+        return it->canonical;
+      }
+    }
+    return NULL;
+  }
+};
+
+static const model_id_t unique[] =
+// clang-format off
+  {
+    { CanonID_EOS_M50,           "EOS M50"}, // Kiss M
+    { CanonID_EOS_M6_Mark_II,    "EOS M6 Mark II"},
+    { CanonID_EOS_M200,          "EOS M200"},
+    { CanonID_EOS_D30,           "EOS D30"},
+    { CanonID_EOS_D60,           "EOS D60"},
+    { CanonID_EOS_M3,            "EOS M3"},
+    { CanonID_EOS_M10,           "EOS M10"},
+    { CanonID_EOS_M5,            "EOS M5"},
+    { CanonID_EOS_M100,          "EOS M100"},
+    { CanonID_EOS_M6,            "EOS M6"},
+    { CanonID_EOS_1D,            "EOS-1D"},
+    { CanonID_EOS_1Ds,           "EOS-1Ds"},
+    { CanonID_EOS_10D,           "EOS 10D"},
+    { CanonID_EOS_1D_Mark_III,   "EOS-1D Mark III"},
+    { CanonID_EOS_300D,          "EOS 300D"}, // Digital Rebel / Kiss Digital
+    { CanonID_EOS_1D_Mark_II,    "EOS-1D Mark II"},
+    { CanonID_EOS_20D,           "EOS 20D"},
+    { CanonID_EOS_450D,          "EOS 450D"}, // Digital Rebel XSi / Kiss X2
+    { CanonID_EOS_1Ds_Mark_II,   "EOS-1Ds Mark II"},
+    { CanonID_EOS_350D,          "EOS 350D"}, // Digital Rebel XT / Kiss Digital N
+    { CanonID_EOS_40D,           "EOS 40D"},
+    { CanonID_EOS_5D,            "EOS 5D"},
+    { CanonID_EOS_1Ds_Mark_III,  "EOS-1Ds Mark III"},
+    { CanonID_EOS_5D_Mark_II,    "EOS 5D Mark II"},
+    { CanonID_EOS_1D_Mark_II_N,  "EOS-1D Mark II N"},
+    { CanonID_EOS_30D,           "EOS 30D"},
+    { CanonID_EOS_400D,          "EOS 400D"}, // Digital Rebel XTi / Kiss Digital X
+    { CanonID_EOS_7D,            "EOS 7D"},
+    { CanonID_EOS_500D,          "EOS 500D"},   // Rebel T1i / Kiss X3
+    { CanonID_EOS_1000D,         "EOS 1000D"}, // Digital Rebel XS / Kiss F
+    { CanonID_EOS_50D,           "EOS 50D"},
+    { CanonID_EOS_1D_X,          "EOS-1D X"},
+    { CanonID_EOS_550D,          "EOS 550D"}, // Rebel T2i / Kiss X4
+    { CanonID_EOS_1D_Mark_IV,    "EOS-1D Mark IV"},
+    { CanonID_EOS_5D_Mark_III,   "EOS 5D Mark III"},
+    { CanonID_EOS_600D,          "EOS 600D"}, // Rebel T3i / Kiss X5
+    { CanonID_EOS_60D,           "EOS 60D"},
+    { CanonID_EOS_1100D,         "EOS 1100D"}, // Rebel T3 / Kiss X50
+    { CanonID_EOS_7D_Mark_II,    "EOS 7D Mark II"},
+    { CanonID_EOS_650D,          "EOS 650D"}, // Rebel T4i / Kiss X6i
+    { CanonID_EOS_6D,            "EOS 6D"},
+    { CanonID_EOS_1D_C,          "EOS-1D C"},
+    { CanonID_EOS_70D,           "EOS 70D"},
+    { CanonID_EOS_700D,          "EOS 700D"},   // Rebel T5i / Kiss X7i
+    { CanonID_EOS_1200D,         "EOS 1200D"}, // Rebel T5 / Kiss X70 / Hi
+    { CanonID_EOS_1D_X_Mark_II,  "EOS-1D X Mark II"},
+    { CanonID_EOS_M,             "EOS M"},
+    { CanonID_EOS_100D,          "EOS 100D"}, // Rebel SL1 / Kiss X7
+    { CanonID_EOS_760D,          "EOS 760D"}, // Rebel T6s / 8000D
+    { CanonID_EOS_5D_Mark_IV,    "EOS 5D Mark IV"},
+    { CanonID_EOS_80D,           "EOS 80D"},
+    { CanonID_EOS_M2,            "EOS M2"},
+    { CanonID_EOS_5DS,           "EOS 5DS"},
+    { CanonID_EOS_750D,          "EOS 750D"}, // Rebel T6i / Kiss X8i
+    { CanonID_EOS_5DS_R,         "EOS 5DS R"},
+    { CanonID_EOS_1300D,         "EOS 1300D"}, // Rebel T6 / Kiss X80
+    { CanonID_EOS_800D,          "EOS 800D"},   // Rebel T7i / Kiss X9i
+    { CanonID_EOS_6D_Mark_II,    "EOS 6D Mark II"},
+    { CanonID_EOS_77D,           "EOS 77D"},     // 9000D
+    { CanonID_EOS_200D,          "EOS 200D"},   // Rebel SL2 / Kiss X9
+    { CanonID_EOS_R5,            "EOS R5"},
+    { CanonID_EOS_3000D,         "EOS 3000D"}, // Rebel T100 / 4000D
+    { CanonID_EOS_R,             "EOS R"},
+    { CanonID_EOS_1D_X_Mark_III, "EOS-1D X Mark III"},
+    { CanonID_EOS_1500D,         "EOS 1500D"}, // Rebel T7 / 2000D / Kiss X90
+    { CanonID_EOS_RP,            "EOS RP"},
+    { CanonID_EOS_850D,          "EOS 850D"},  // EOS Rebel T8i / X10i
+    { CanonID_EOS_250D,          "EOS 250D"}, // Rebel SL3 / 200D II / Kiss X10
+    { CanonID_EOS_90D,           "EOS 90D"},
+    { CanonID_EOS_R6,            "EOS R6"},
+  },
+#if 0
+  olyque[] = {
+    { OlyID_E_20,            "E-20"},
+    { OlyID_E_20,            "E-20,E-20N,E-20P"},
+    { OlyID_E_1,             "E-1"},
+    { OlyID_E_300,           "E-300"},
+    { OlyID_SP_550UZ,        "SP-550UZ"},
+    { OlyID_SP_550UZ,        "SP550UZ"},
+    { OlyID_SP_510UZ,        "SP-510UZ"},
+    { OlyID_SP_510UZ,        "SP510UZ"},
+    { OlyID_SP_560UZ,        "SP-560UZ"},
+    { OlyID_SP_560UZ,        "SP560UZ"},
+    { OlyID_SP_570UZ,        "SP-570UZ"},
+    { OlyID_SP_570UZ,        "SP570UZ"},
+    { OlyID_SP_565UZ,        "SP-565UZ"},
+    { OlyID_SP_565UZ,        "SP565UZ"},
+    { OlyID_XZ_1,            "XZ-1"},
+    { OlyID_XZ_2,            "XZ-2"},
+    { OlyID_XZ_10,           "XZ-10"},
+    { OlyID_STYLUS_1,        "Stylus 1"},
+    { OlyID_STYLUS_1,        "STYLUS1"},
+    { OlyID_STYLUS_1,        "STYLUS1,1s"},
+    { OlyID_SH_2,            "SH-2"},
+    { OlyID_TG_4,            "TG-4"},
+    { OlyID_TG_5,            "TG-5"},
+    { OlyID_TG_6,            "TG-6"},
+    { OlyID_E_10,            "E-10"},
+    { OlyID_AIR_A01,         "AIR A01"},
+    { OlyID_AIR_A01,         "AIR-A01"},
+    { OlyID_E_330,           "E-330"},
+    { OlyID_E_500,           "E-500"},
+    { OlyID_E_400,           "E-400"},
+    { OlyID_E_510,           "E-510"},
+    { OlyID_E_3,             "E-3"},
+    { OlyID_E_410,           "E-410"},
+    { OlyID_E_420,           "E-420"},
+    { OlyID_E_30,            "E-30"},
+    { OlyID_E_520,           "E-520"},
+    { OlyID_E_P1,            "E-P1"},
+    { OlyID_E_620,           "E-620"},
+    { OlyID_E_P2,            "E-P2"},
+    { OlyID_E_PL1,           "E-PL1"},
+    { OlyID_E_450,           "E-450"},
+    { OlyID_E_600,           "E-600"},
+    { OlyID_E_P3,            "E-P3"},
+    { OlyID_E_5,             "E-5"},
+    { OlyID_E_PL2,           "E-PL2"},
+    { OlyID_E_M5,            "E-M5"},
+    { OlyID_E_PL3,           "E-PL3"},
+    { OlyID_E_PM1,           "E-PM1"},
+    { OlyID_E_PL1s,          "E-PL1s"},
+    { OlyID_E_PL5,           "E-PL5"},
+    { OlyID_E_PM2,           "E-PM2"},
+    { OlyID_E_P5,            "E-P5"},
+    { OlyID_E_PL6,           "E-PL6"},
+    { OlyID_E_PL7,           "E-PL7"},
+    { OlyID_E_M1,            "E-M1"},
+    { OlyID_E_M10,           "E-M10"},
+    { OlyID_E_M5_Mark_II,    "E-M5 Mark II"},
+    { OlyID_E_M5_Mark_II,    "E-M5MarkII"},
+    { OlyID_E_M5_Mark_II,    "E-M5_M2"},
+    { OlyID_E_M10_Mark_II,   "E-M10 Mark II"}, // Clauss piX 5oo
+    { OlyID_E_M10_Mark_II,   "E-M10MarkII"},
+    { OlyID_E_M10_Mark_II,   "E-M10_M2"},
+    { OlyID_PEN_F,           "PEN-F"},
+    { OlyID_E_PL8,           "E-PL8"},
+    { OlyID_E_M1_Mark_II,    "E-M1 Mark II"},
+    { OlyID_E_M1_Mark_II,    "E-M1MarkII"},
+    { OlyID_E_M1_Mark_II,    "E-M1_M2"},
+    { OlyID_E_M10_Mark_III,  "E-M10 Mark III"},
+    { OlyID_E_M10_Mark_III,  "E-M10_M3"},
+    { OlyID_E_PL9,           "E-PL9"},
+    { OlyID_E_M1X,           "E-M1X"},
+    { OlyID_E_PL10,          "E-PL10"},
+    { OlyID_E_M10_Mark_IV,   "E-M10 Mark IV"},
+    { OlyID_E_M10_Mark_IV,   "E-M10MarkIV"},
+    { OlyID_E_M10_Mark_IV,   "E-M10_M4"},
+    { OlyID_E_M5_Mark_III,   "E-M5 Mark III"},
+    { OlyID_E_M5_Mark_III,   "E-M5MarkIII"},
+    { OlyID_E_M5_Mark_III,   "E-M5_M3"},
+    { OlyID_E_M1_Mark_III,   "E-M1 Mark III"},
+    { OlyID_E_M1_Mark_III,   "E-M1MarkIII"},
+    { OlyID_E_M1_Mark_III,   "E-M1_M3"},
+    { OlyID_C_3030Z,         "C-3030Z"},
+    { OlyID_C_3030Z,         "C3030Z"},
+    { OlyID_C_5050Z,         "C-5050Z"},
+    { OlyID_C_5050Z,         "C5050Z"},
+    { OlyID_C_350Z,          "C-350Z"},
+    { OlyID_C_350Z,          "X200,D560Z,C350Z"},
+    { OlyID_C_740UZ,         "C-740UZ"},
+    { OlyID_C_740UZ,         "C740UZ"},
+    { OlyID_C_5060WZ,        "C-5060WZ"},
+    { OlyID_C_5060WZ,        "C5060WZ"},
+    { OlyID_C_8080WZ,        "C-8080WZ"},
+    { OlyID_C_8080WZ,        "C8080WZ"},
+    { OlyID_C_770UZ,         "C-770UZ"},
+    { OlyID_C_770UZ,         "C770UZ"},
+    { OlyID_C_7070WZ,        "C-7070WZ"},
+    { OlyID_C_7070WZ,        "C7070WZ"},
+    { OlyID_C_7000Z,         "C-7000Z"},
+    { OlyID_C_7000Z,         "C70Z,C7000Z"},
+    { OlyID_SP_500UZ,        "SP-500UZ"},
+    { OlyID_SP_500UZ,        "SP500UZ"},
+    { OlyID_SP_310,          "SP-310"},
+    { OlyID_SP_310,          "SP310"},
+    { OlyID_SP_350,          "SP-350"},
+    { OlyID_SP_350,          "SP350"},
+    { OlyID_SP_320,          "SP-320"},
+    { OlyID_SP_320,          "SP320"},
+  },
+
+  penique[] = {
+    { PentaxID_Optio_S,      "Optio S"},
+    { PentaxID_Optio_S_V101, "Optio S V1.01"},
+    { PentaxID_staristD,     "*istD"},
+    { PentaxID_staristD,     "*ist D"},
+    { PentaxID_Optio_33WR,   "Optio 33WR"},
+    { PentaxID_Optio_S4,     "Optio S4"},
+    { PentaxID_Optio_750Z,   "Optio 750Z"},
+    { PentaxID_staristDS,    "*istDS"},
+    { PentaxID_staristDS,    "*ist DS"},
+    { PentaxID_staristDL,    "*istDL"},
+    { PentaxID_staristDL,    "*ist DL"},
+    { PentaxID_staristDS2,   "*istDS2"},
+    { PentaxID_staristDS2,   "*ist DS2"},
+    { PentaxID_GX_1S,        "GX-1S"},       // Samsung
+    { PentaxID_staristDL2,   "*istDL2"},
+    { PentaxID_staristDL2,   "*ist DL2"},
+    { PentaxID_GX_1L,        "GX-1L"},       // Samsung
+    { PentaxID_K100D,        "K100D"},
+    { PentaxID_K110D,        "K110D"},
+    { PentaxID_K100D_Super,  "K100D Super"},
+    { PentaxID_K10D,         "K10D"},
+    { PentaxID_GX10,         "GX10"},        // Samsung
+    { PentaxID_GX10,         "GX-10"},       // Samsung
+    { PentaxID_K20D,         "K20D"},
+    { PentaxID_GX20,         "GX20"},        // Samsung
+    { PentaxID_GX20,         "GX-20"},       // Samsung
+    { PentaxID_K200D,        "K200D"},
+    { PentaxID_K2000,        "K2000"},
+    { PentaxID_K_m,          "K-m"},
+    { PentaxID_K_7,          "K-7"},
+    { PentaxID_K_x,          "K-x"},
+    { PentaxID_645D,         "645D"},
+    { PentaxID_K_r,          "K-r"},
+    { PentaxID_K_5,          "K-5"},
+    { PentaxID_Q,            "Q"},
+    { PentaxID_K_01,         "K-01"},
+    { PentaxID_K_30,         "K-30"},
+    { PentaxID_Q10,          "Q10"},
+    { PentaxID_K_5_II,       "K-5 II"},
+    { PentaxID_K_5_II_s,     "K-5 II s"},
+    { PentaxID_Q7,           "Q7"},
+    { PentaxID_MX_1,         "MX-1"},
+    { PentaxID_K_50,         "K-50"},
+    { PentaxID_K_3,          "K-3"},
+    { PentaxID_K_500,        "K-500"},
+    { PentaxID_645Z,         "645Z"},
+    { PentaxID_K_S1,         "K-S1"},
+    { PentaxID_K_S2,         "K-S2"},        // Ricoh
+    { PentaxID_Q_S1,         "Q-S1"},
+    { PentaxID_K_1,          "K-1"},         // Ricoh
+    { PentaxID_K_3_II,       "K-3 II"},      // Ricoh
+    { PentaxID_GR_III,       "GR III"},      // Ricoh
+    { PentaxID_K_70,         "K-70"},        // Ricoh
+    { PentaxID_KP,           "KP"},          // Ricoh
+    { PentaxID_K_1_Mark_II,  "K-1 Mark II"}, // Ricoh
+  },
+#endif
+  sonique[] = {
+    { SonyID_DSC_R1,         "DSC-R1"},
+    { SonyID_DSLR_A100,      "DSLR-A100"},
+    { SonyID_DSLR_A900,      "DSLR-A900"},
+    { SonyID_DSLR_A700,      "DSLR-A700"},
+    { SonyID_DSLR_A200,      "DSLR-A200"},
+    { SonyID_DSLR_A350,      "DSLR-A350"},
+    { SonyID_DSLR_A300,      "DSLR-A300"},
+    { SonyID_DSLR_A900_APSC, "DSLR-A900"},
+    { SonyID_DSLR_A380,      "DSLR-A380"},    // DSLR-A390
+    { SonyID_DSLR_A330,      "DSLR-A330"},
+    { SonyID_DSLR_A230,      "DSLR-A230"},
+    { SonyID_DSLR_A290,      "DSLR-A290"},
+    { SonyID_DSLR_A850,      "DSLR-A850"},
+    { SonyID_DSLR_A850_APSC, "DSLR-A850"},
+    { SonyID_DSLR_A550,      "DSLR-A550"},
+    { SonyID_DSLR_A500,      "DSLR-A500"},
+    { SonyID_DSLR_A450,      "DSLR-A450"},
+    { SonyID_NEX_5,          "NEX-5"},
+    { SonyID_NEX_3,          "NEX-3"},
+    { SonyID_SLT_A33,        "SLT-A33"},
+    { SonyID_SLT_A55,        "SLT-A55"},      // SLT-A55V
+    { SonyID_DSLR_A560,      "DSLR-A560"},
+    { SonyID_DSLR_A580,      "DSLR-A580"},
+    { SonyID_NEX_C3,         "NEX-C3"},
+    { SonyID_SLT_A35,        "SLT-A35"},
+    { SonyID_SLT_A65,        "SLT-A65"},      // SLT-A65V
+    { SonyID_SLT_A77,        "SLT-A77"},      // SLT-A77V
+    { SonyID_NEX_5N,         "NEX-5N"},
+    { SonyID_NEX_7,          "NEX-7"},        // Hasselblad Lunar
+    { SonyID_NEX_VG20,       "NEX-VG20"},
+    { SonyID_SLT_A37,        "SLT-A37"},
+    { SonyID_SLT_A57,        "SLT-A57"},
+    { SonyID_NEX_F3,         "NEX-F3"},
+    { SonyID_SLT_A99,        "SLT-A99"},      // SLT-A99V / Hasselblad HV
+    { SonyID_NEX_6,          "NEX-6"},
+    { SonyID_NEX_5R,         "NEX-5R"},
+    { SonyID_DSC_RX100,      "DSC-RX100"},    // Hasselblad Stellar
+    { SonyID_DSC_RX1,        "DSC-RX1"},
+    { SonyID_NEX_VG900,      "NEX-VG900"},
+    { SonyID_NEX_VG30,       "NEX-VG30"},
+    { SonyID_ILCE_3000,      "ILCE-3000"},    // ILCE-3500
+    { SonyID_SLT_A58,        "SLT-A58"},
+    { SonyID_NEX_3N,         "NEX-3N"},
+    { SonyID_ILCE_7,         "ILCE-7"},
+    { SonyID_NEX_5T,         "NEX-5T"},
+    { SonyID_DSC_RX100M2,    "DSC-RX100M2"},  // Hasselblad Stellar II
+    { SonyID_DSC_RX10,       "DSC-RX10"},
+    { SonyID_DSC_RX1R,       "DSC-RX1R"},
+    { SonyID_ILCE_7R,        "ILCE-7R"},      // Hasselblad Lusso
+    { SonyID_ILCE_6000,      "ILCE-6000"},
+    { SonyID_ILCE_5000,      "ILCE-5000"},
+    { SonyID_DSC_RX100M3,    "DSC-RX100M3"},
+    { SonyID_ILCE_7S,        "ILCE-7S"},
+    { SonyID_ILCA_77M2,      "ILCA-77M2"},
+    { SonyID_ILCE_5100,      "ILCE-5100"},
+    { SonyID_ILCE_7M2,       "ILCE-7M2"},
+    { SonyID_DSC_RX100M4,    "DSC-RX100M4"},
+    { SonyID_DSC_RX10M2,     "DSC-RX10M2"},
+    { SonyID_DSC_RX1RM2,     "DSC-RX1RM2"},
+    { SonyID_ILCE_QX1,       "ILCE-QX1"},
+    { SonyID_ILCE_7RM2,      "ILCE-7RM2"},
+    { SonyID_ILCE_7SM2,      "ILCE-7SM2"},
+    { SonyID_ILCA_68,        "ILCA-68"},
+    { SonyID_ILCA_99M2,      "ILCA-99M2"},
+    { SonyID_DSC_RX10M3,     "DSC-RX10M3"},
+    { SonyID_DSC_RX100M5,    "DSC-RX100M5"},
+    { SonyID_ILCE_6300,      "ILCE-6300"},
+    { SonyID_ILCE_9,         "ILCE-9"},
+    { SonyID_ILCE_6500,      "ILCE-6500"},
+    { SonyID_ILCE_7RM3,      "ILCE-7RM3"},
+    { SonyID_ILCE_7M3,       "ILCE-7M3"},
+    { SonyID_DSC_RX0,        "DSC-RX0"},
+    { SonyID_DSC_RX10M4,     "DSC-RX10M4"},
+    { SonyID_DSC_RX100M6,    "DSC-RX100M6"},
+    { SonyID_DSC_HX99,       "DSC-HX99"},
+    { SonyID_DSC_RX100M5A,   "DSC-RX100M5A"},
+    { SonyID_ILCE_6400,      "ILCE-6400"},
+    { SonyID_DSC_RX0M2,      "DSC-RX0M2"},
+    { SonyID_DSC_RX100M7,    "DSC-RX100M7"},
+    { SonyID_ILCE_7RM4,      "ILCE-7RM4"},
+    { SonyID_ILCE_9M2,       "ILCE-9M2"},
+    { SonyID_ILCE_6600,      "ILCE-6600"},
+    { SonyID_ILCE_6100,      "ILCE-6100"},
+    { SonyID_ZV_1,           "ZV-1"},
+    { SonyID_ILCE_7C,        "ILCE-7C"},
+    { SonyID_ILCE_7SM3,      "ILCE-7SM3"},
+  };
+
+static const char fujialias[][16] = {
+  "@DBP for GX680", "DX-2000",
+  "@F500EXR", "F505EXR",
+  "@F600EXR", "F605EXR",
+  "@F770EXR", "F775EXR",
+  "@HS10", "HS10 HS11",
+  "@HS20EXR", "HS22EXR",
+  "@HS30EXR", "HS33EXR", "HS35EXR",
+  "@S5100", "S5500",
+  "@S5200", "S5600",
+  "@S6000fd", "S6500fd",
+  "@S9000", "S9500",
+  "@S9100", "S9600",
+  "@S200EXR", "S205EXR",
+  "@X-T1 IR", "X-T1IR",
+};
+
+static const char kodakalias[][16] = {
+  "@DCS Pro 14N", "Camerz ZDS 14", // Camerz rebadge make: "Photo Control"
+  "@DCS720X", "SCS2000",
+  "@DCS520C", "EOS D2000C", "EOS D2000", // EOS rebadge make: Canon
+  "@DCS560C", "EOS D6000C", "EOS D6000", // EOS rebadge make: Canon
+  "@DCS460M", "DCS460A", // 'A' was supposed to stand for 'achromatic', marketing changed it to 'M'
+  "@DCS460",  "DCS460C", "DCS460D",
+  "@DCS465",  "DCS465C", "DCS465D",
+  "@EOSDCS1", "EOSDCS1B", "EOSDCS1C",
+  "@EOSDCS3", "EOSDCS3B", "EOSDCS3C",
+};
+
+static const char leafalias[][16] = {
+    // Leaf re-badged to Mamiya
+  "@Aptus-II 5",  "DM22",
+  "@Aptus-II 6",  "DM28",
+  "@Aptus-II 7",  "DM33",
+  "@Aptus-II 8",  "DM40",
+  "@Aptus-II 10", "DM56",
+};
+
+static const char KonicaMinolta_aliases[][24] = {
+  "@DG-5D", "DYNAX 5D", "MAXXUM 5D", "ALPHA-5 DIGITAL", "ALPHA SWEET DIGITAL",
+  "@DG-7D", "DYNAX 7D", "MAXXUM 7D", "ALPHA-7 DIGITAL",
+};
+
+static const char nikonalias[][16] = {
+    "@COOLPIX 2100",  "E2100",         "@COOLPIX 2500",  "E2500",
+    "@COOLPIX 3200",  "E3200",         "@COOLPIX 3700",  "E3700",
+    "@COOLPIX 4300",  "E4300",         "@COOLPIX 4500",  "E4500",
+    "@COOLPIX 5000",  "E5000",         "@COOLPIX 5400",  "E5400",
+    "@COOLPIX 5700",  "E5700",         "@COOLPIX 8400",  "E8400",
+    "@COOLPIX 8700",  "E8700",         "@COOLPIX 8800",  "E8800",
+    "@COOLPIX 700",   "E700",          "@COOLPIX 800",   "E800",
+    "@COOLPIX 880",   "E880",          "@COOLPIX 900",   "E900",
+    "@COOLPIX 950",   "E950",          "@COOLPIX 990",   "E990",
+    "@COOLPIX 995",   "E995",          "@COOLPIX P7700", "COOLPIX Deneb",
+    "@COOLPIX P7800", "COOLPIX Kalon",
+};
+
+static const char olyalias[][32] = { // Olympus
+  "@AIR A01", "AIR-A01",
+  "@C-3030Z", "C3030Z",
+  "@C-5050Z", "C5050Z",
+  "@C-5060WZ", "C5060WZ",
+  "@C-7000Z", "C7000Z", "C70Z,C7000Z", "C70Z",
+  "@C-7070WZ", "C7070WZ",
+  "@C-8080WZ", "C8080WZ",
+  "@C-350Z", "C350Z", "X200,D560Z,C350Z", "X200", "D560Z",
+  "@C-740UZ", "C740UZ",
+  "@C-770UZ", "C770UZ",
+  "@E-20", "E-20,E-20N,E-20P", "E-20N", "E-20P",
+  "@E-M10 Mark II", "E-M10MarkII", "E-M10_M2", "piX 5oo",
+  "@E-M10 Mark III", "E-M10MarkIII", "E-M10_M3",
+  "@E-M10 Mark IV", "E-M10MarkIV", "E-M10_M4",
+  "@E-M1 Mark II", "E-M1MarkII", "E-M1_M2",
+  "@E-M1 Mark III", "E-M1MarkIII", "E-M1_M3",
+  "@E-M5 Mark II", "E-M5MarkII", "E-M5_M2",
+  "@E-M5 Mark III", "E-M5MarkIII", "E-M5_M3",
+  "@SH-2", "SH-3",
+  "@SP-310", "SP310",
+  "@SP-320", "SP320",
+  "@SP-350", "SP350",
+  "@SP-500UZ", "SP500UZ",
+  "@SP-510UZ", "SP510UZ",
+  "@SP-550UZ", "SP550UZ",
+  "@SP-560UZ", "SP560UZ",
+  "@SP-565UZ", "SP565UZ",
+  "@SP-570UZ", "SP570UZ",
+  "@Stylus 1", "STYLUS1", "STYLUS1s", "STYLUS1,1s",
+};
+
+static const char panalias[][16] = { // Panasonic, PanaLeica
+// fixed lens
+  "@DMC-FX150", "DMC-FX180",
+  "@DC-FZ1000M2", "DC-FZ10002", "V-Lux 5",
+  "@DMC-FZ1000", "V-LUX (Typ 114)",
+  "@DMC-FZ2500", "DMC-FZ2000", "DMC-FZH1",
+  "@DMC-FZ100", "V-LUX 2",
+  "@DMC-FZ150", "V-LUX 3",
+  "@DMC-FZ200", "V-LUX 4",
+  "@DMC-FZ300", "DMC-FZ330",
+  "@DMC-FZ35", "DMC-FZ38",
+  "@DMC-FZ40", "DMC-FZ42", "DMC-FZ45", "DC-FZ40", "DC-FZ42", "DC-FZ45",
+  "@DMC-FZ50", "V-LUX 1", "V-LUX1",
+  "@DMC-FZ70", "DMC-FZ72",
+  "@DC-FZ80", "DC-FZ81", "DC-FZ82", "DC-FZ83", "DC-FZ85",
+  "@DMC-LC1", "DIGILUX 2", "Digilux 2", "DIGILUX2",
+  "@DMC-LF1", "C (Typ 112)",
+  "@DC-LX100M2", "D-Lux 7",
+  "@DMC-LX100", "D-LUX (Typ 109)", "D-Lux (Typ 109)",
+  "@DMC-LX1", "D-Lux2", "D-LUX2", "D-LUX 2",
+  "@DMC-LX2", "D-LUX 3", "D-LUX3",
+  "@DMC-LX3", "D-LUX 4",
+  "@DMC-LX5", "D-LUX 5",
+  "@DMC-LX7", "D-LUX 6",
+  "@DMC-LX9", "DMC-LX10", "DMC-LX15",
+  "@DMC-ZS100", "DMC-ZS110", "DMC-TZ100", "DMC-TZ101", "DMC-TZ110", "DMC-TX1",
+  "@DC-ZS200", "DC-ZS220", "DC-TZ200", "DC-TZ202", "DC-TZ220", "DC-TX2", "C-Lux", "CAM-DC25",
+  "@DMC-ZS40", "DMC-TZ60", "DMC-TZ61",
+  "@DMC-ZS50", "DMC-TZ70", "DMC-TZ71",
+  "@DMC-ZS60", "DMC-TZ80", "DMC-TZ81", "DMC-TZ82", "DMC-TZ85",
+  "@DC-ZS70", "DC-TZ90", "DC-TZ91", "DC-TZ92", "DC-TZ93",
+  "@DC-ZS80", "DC-TZ95", "DC-TZ96", "DC-TZ97",
+
+// interchangeable lens
+  "@DC-G100",  "DC-G110",
+  "@DC-G99",   "DC-G90",   "DC-G91",  "DC-G95",
+  "@DMC-G7",   "DMC-G70",
+  "@DMC-G8",   "DMC-G80",  "DMC-G81", "DMC-G85",
+  "@DMC-GH4",  "AG-GH4",   "CGO4",
+  "@DC-GF10",  "DC-GF90",  "DC-GX880",
+  "@DC-GF9",   "DC-GX850", "DC-GX800",
+  "@DMC-GM1",  "DMC-GM1S",
+  "@DMC-GX85", "DMC-GX80", "DMC-GX7MK2",
+  "@DC-GX9",   "DC-GX7MK3",
+  "@DMC-L1",   "DIGILUX 3", "DIGILUX3", // full 4/3 mount, not m43
+};
+
+static const char phase1alias[][16] = {
+  "@H20",  "H 20",
+  "@H25",  "H 25",
+  "@P20+", "P 20+",
+  "@P20",  "P 20",
+  "@P21+", "P 21+", "M18", // "Mamiya M18"
+  "@P21",  "P 21",
+  "@P25+", "P 25+", "M22", // "Mamiya M22"
+  "@P25",  "P 25",
+  "@P30+", "P 30+", "M31", // "Mamiya M31"
+  "@P30",  "P 30",
+  "@P40+", "P 40+",
+  "@P40",  "P 40",
+  "@P45+", "P 45+",
+  "@P45",  "P 45",
+  "@P65+", "P 65+",
+  "@P65",  "P 65",
+};
+
+static const char SamsungPentax_aliases[][16] = {
+  "@*istDL2", "*ist DL2", "GX-1L",
+  "@*istDS2", "*ist DS2", "GX-1S",
+  "@*istDL",  "*ist DL",
+  "@*istDS",  "*ist DS",
+  "@*istD",   "*ist D",
+  "@K10D", "GX10", "GX-10",
+  "@K20D", "GX20", "GX-20",
+  "@K-m", "K2000",
+};
+
+static const char samsungalias[][64] = {
+  "@EX1", "TL500",
+  "@NX U", "EK-GN100", "EK-GN110", "EK-GN120", "EK-KN120", "Galaxy NX",
+  "@NX mini", "NXF1",
+  "@WB2000", "TL350",
+    //    "@WB5000", "WB5000/HZ25W", // no spaces around the slash separating names
+    //    "@WB5500", "WB5500 / VLUU WB5500 / SAMSUNG HZ50W",
+    //    "@WB500", "WB510 / VLUU WB500 / SAMSUNG HZ10W",
+    //    "@WB550", "WB560 / VLUU WB550 / SAMSUNG HZ15W",
+    //    "@WB650", "SAMSUNG WB650 / VLUU WB650 / SAMSUNG WB660" aka HZ35W
+};
+// clang-format on
+
+/*
+   Per-maker model rules. A rule matches if the model starts with match
+   (LIBRAW_MR_NOCASE: case-insensitively), equals it (LIBRAW_MR_EXACT) or
+   contains it (LIBRAW_MR_SUBSTR), and if the model characters also match
+   chars, where '?' is any character. Rules are tried in table order, the
+   first matching rule for the maker wins.
+ */
+#define LIBRAW_MR_NOCASE 1
+#define LIBRAW_MR_EXACT 2
+#define LIBRAW_MR_SUBSTR 4
+#define LIBRAW_MR_MODEL 8     /* test model, not normalized_model */
+#define LIBRAW_MR_SONY_DSC 16 /* also set imSony.CameraType */
+
+static inline int model_rule_match(const char *t_model, const char *match,
+                                   unsigned flags, const char *chars = NULL)
+{
+  if (flags & LIBRAW_MR_SUBSTR)
+  {
+    if (!strstr(t_model, match))
+      return 0;
+  }
+  else if (flags & LIBRAW_MR_EXACT)
+  {
+    if (strcmp(t_model, match))
+      return 0;
+  }
+  else if ((flags & LIBRAW_MR_NOCASE)
+               ? strncasecmp(t_model, match, strlen(match))
+               : strncmp(t_model, match, strlen(match)))
+    return 0;
+  for (int i = 0; chars && chars[i]; i++)
+    if (chars[i] != '?' && t_model[i] != chars[i])
+      return 0;
+  return 1;
+}
+
+/* make changes for models re-badged by other makers */
+struct model_rebadge_t
+{
+  unsigned maker;
+  const char *match;
+  unsigned flags;
+  unsigned new_maker;
+};
+
+/* model renames applied before alias lookup */
+struct model_rename_t
+{
+  unsigned maker;
+  const char *match;
+  unsigned flags;
+  const char *t_model;
+};
+
+/* camera mount and format for files without this info in makernotes,
+   0 leaves the value as is */
+struct model_mount_t
+{
+  unsigned maker;
+  const char *match;
+  unsigned flags;
+  const char *chars;
+  unsigned short format, mount, lens_format, focal;
+};
+
+/* Ricoh GXR modules, by LensID or by lens name keyword */
+struct gxr_module_t
+{
+  int id;
+  const char *lens;
+  char t_model[16];
+  unsigned short format, mount, focal;
+};
+
+// clang-format off
+static const model_rebadge_t model_rebadges[] = {
+  // don't use unique_id here because ids for Monochrome models are unknown
+  { LIBRAW_CAMERAMAKER_Canon,        "EOS D2000",     0,                LIBRAW_CAMERAMAKER_Kodak },
+  { LIBRAW_CAMERAMAKER_Canon,        "EOS D6000",     0,                LIBRAW_CAMERAMAKER_Kodak },
+  { LIBRAW_CAMERAMAKER_Canon,        "EOSDCS",        0,                LIBRAW_CAMERAMAKER_Kodak },
+  { LIBRAW_CAMERAMAKER_PhotoControl, "Camerz ZDS 14", LIBRAW_MR_NOCASE, LIBRAW_CAMERAMAKER_Kodak },
+};
+
+static const model_id_t pentax_optio_ids[] = {
+  { PentaxID_Optio_S,      "Optio S"},
+  { PentaxID_Optio_S_V101, "Optio S V1.01"},
+  { PentaxID_Optio_S4,     "Optio S4"},
+  { PentaxID_Optio_750Z,   "Optio 750Z"},
+  { PentaxID_Optio_33WR,   "Optio 33WR"},
+};
+
+static const model_id_t oly_uz_ids[] = {
+  { OlyID_C_740UZ, "C-740UZ"},
+  { OlyID_C_770UZ, "C-770UZ"},
+};
+
+static const model_rename_t model_renames[] = {
+  { LIBRAW_CAMERAMAKER_Samsung, "WB5500", LIBRAW_MR_SUBSTR, "WB5500" },
+  { LIBRAW_CAMERAMAKER_Samsung, "HZ50W",  LIBRAW_MR_SUBSTR, "WB5500" },
+  { LIBRAW_CAMERAMAKER_Samsung, "WB5000", LIBRAW_MR_SUBSTR, "WB5000" },
+  { LIBRAW_CAMERAMAKER_Samsung, "HZ25W",  LIBRAW_MR_SUBSTR, "WB5000" },
+  { LIBRAW_CAMERAMAKER_Samsung, "WB550",  LIBRAW_MR_SUBSTR, "WB550" },
+  { LIBRAW_CAMERAMAKER_Samsung, "HZ15W",  LIBRAW_MR_SUBSTR, "WB550" },
+  { LIBRAW_CAMERAMAKER_Samsung, "WB500",  LIBRAW_MR_SUBSTR, "WB500" },
+  { LIBRAW_CAMERAMAKER_Samsung, "HZ10W",  LIBRAW_MR_SUBSTR, "WB500" },
+  { LIBRAW_CAMERAMAKER_Kodak,   "DC25",   LIBRAW_MR_SUBSTR, "DC25" },
+  { LIBRAW_CAMERAMAKER_Kodak,   "40",     LIBRAW_MR_EXACT,  "DC40" },
+  { LIBRAW_CAMERAMAKER_Kodak,   "DC50",   LIBRAW_MR_SUBSTR, "DC50" },
+  { LIBRAW_CAMERAMAKER_Kodak,   "DC120",  LIBRAW_MR_SUBSTR, "DC120" },
+};
+
+static const gxr_module_t gxr_modules[] = {
+  { 1, "50mm", "GXR A12 50mm",  LIBRAW_FORMAT_APSC,        LIBRAW_MOUNT_RicohModule, LIBRAW_FT_PRIME_LENS }, // GR Lens A12 50mm F2.5 Macro
+  { 2, "S10",  "GXR S10",       LIBRAW_FORMAT_1div1p7INCH, LIBRAW_MOUNT_RicohModule, LIBRAW_FT_ZOOM_LENS },
+  { 3, "P10",  "GXR P10",       LIBRAW_FORMAT_1div2p3INCH, LIBRAW_MOUNT_RicohModule, LIBRAW_FT_ZOOM_LENS }, // Ricoh Lens P10 28-300mm F3.5-5.6 VC
+  { 5, "28mm", "GXR A12 28mm",  LIBRAW_FORMAT_APSC,        LIBRAW_MOUNT_RicohModule, LIBRAW_FT_PRIME_LENS }, // GR Lens A12 28mm F2.5
+  { 6, "A16",  "GXR A16",       LIBRAW_FORMAT_APSC,        LIBRAW_MOUNT_RicohModule, LIBRAW_FT_ZOOM_LENS },  // Ricoh Lens A16 24-85mm F3.5-5.5
+  { 8, NULL,   "GXR Mount A12", LIBRAW_FORMAT_APSC,        LIBRAW_MOUNT_Leica_M,     0 }, // Leica M lenses
+};
+
+static const model_mount_t model_mounts[] = {
+  { LIBRAW_CAMERAMAKER_Canon,     "EOS",  0, NULL, 0, 0, 0, 0 },
+  { LIBRAW_CAMERAMAKER_Canon,     "",     0, NULL, 0, LIBRAW_MOUNT_FixedLens, 0, 0 },
+
+  { LIBRAW_CAMERAMAKER_Nikon,     "D",    0, NULL, 0, LIBRAW_MOUNT_Nikon_F, 0, 0 },
+  { LIBRAW_CAMERAMAKER_Nikon,     "",     0, NULL, 0, LIBRAW_MOUNT_FixedLens, 0, 0 },
+
+  { LIBRAW_CAMERAMAKER_Panasonic, "DC-S",   0, NULL, LIBRAW_FORMAT_FF, LIBRAW_MOUNT_LPS_L, 0, 0 },
+  { LIBRAW_CAMERAMAKER_Panasonic, "DMC-L1", 0, NULL, LIBRAW_FORMAT_FT, LIBRAW_FORMAT_FT, 0, 0 },
+  { LIBRAW_CAMERAMAKER_Panasonic, "",       0, "??-G",  LIBRAW_FORMAT_FT, LIBRAW_MOUNT_mFT, 0, 0 },
+  { LIBRAW_CAMERAMAKER_Panasonic, "",       0, "???-G", LIBRAW_FORMAT_FT, LIBRAW_MOUNT_mFT, 0, 0 },
+  { LIBRAW_CAMERAMAKER_Panasonic, "",       0, "??-LX100",  LIBRAW_FORMAT_FT, LIBRAW_MOUNT_FixedLens, LIBRAW_FORMAT_FT, LIBRAW_FT_ZOOM_LENS }, // DC-LX100M2
+  { LIBRAW_CAMERAMAKER_Panasonic, "",       0, "???-LX100", LIBRAW_FORMAT_FT, LIBRAW_MOUNT_FixedLens, LIBRAW_FORMAT_FT, LIBRAW_FT_ZOOM_LENS }, // DMC-LX100
+  { LIBRAW_CAMERAMAKER_Panasonic, "DMC-CM1", 0, NULL, 0, LIBRAW_MOUNT_FixedLens, 0, LIBRAW_FT_PRIME_LENS },
+  { LIBRAW_CAMERAMAKER_Panasonic, "",       0, NULL, 0, LIBRAW_MOUNT_FixedLens, 0, LIBRAW_FT_ZOOM_LENS },
+
+  { LIBRAW_CAMERAMAKER_Fujifilm,  "GFX ",   0, NULL, LIBRAW_FORMAT_CROP645, LIBRAW_MOUNT_Fuji_GF, 0, 0 },
+  { LIBRAW_CAMERAMAKER_Fujifilm,  "X-S10",  0, NULL, LIBRAW_FORMAT_APSC, LIBRAW_MOUNT_Fuji_X, 0, 0 },
+  { LIBRAW_CAMERAMAKER_Fujifilm,  "X-S1",   0, NULL, 0, LIBRAW_MOUNT_FixedLens, 0, 0 },
+  { LIBRAW_CAMERAMAKER_Fujifilm,  "X-",     0, NULL, LIBRAW_FORMAT_APSC, LIBRAW_MOUNT_Fuji_X, 0, 0 },
+  { LIBRAW_CAMERAMAKER_Fujifilm,  "",       0, "S?P", LIBRAW_FORMAT_APSC, LIBRAW_MOUNT_Nikon_F, 0, 0 }, // S2Pro, S3Pro, S5Pro
+  { LIBRAW_CAMERAMAKER_Fujifilm,  "IS Pro", LIBRAW_MR_NOCASE, NULL, LIBRAW_FORMAT_APSC, LIBRAW_MOUNT_Nikon_F, 0, 0 },
+  { LIBRAW_CAMERAMAKER_Fujifilm,  "DBP",    0, NULL, LIBRAW_FORMAT_68, LIBRAW_MOUNT_Fuji_GX, 0, 0 },
+  { LIBRAW_CAMERAMAKER_Fujifilm,  "",       0, NULL, 0, LIBRAW_MOUNT_FixedLens, 0, 0 },
+
+  // DNG converters delete makernotes
+  { LIBRAW_CAMERAMAKER_Samsung,   "NXF1",   0, NULL, LIBRAW_FORMAT_1INCH, LIBRAW_MOUNT_Samsung_NX_M, 0, 0 },
+  { LIBRAW_CAMERAMAKER_Samsung,   "NX",     0, NULL, LIBRAW_FORMAT_APSC, LIBRAW_MOUNT_Samsung_NX, 0, 0 },
+  { LIBRAW_CAMERAMAKER_Samsung,   "",       0, NULL, 0, LIBRAW_MOUNT_FixedLens, 0, 0 },
+
+  { LIBRAW_CAMERAMAKER_Kodak,     "DCS465",        0, NULL, 0, LIBRAW_MOUNT_DigitalBack, 0, 0 },
+  { LIBRAW_CAMERAMAKER_Kodak,     "DCS5",          0, NULL, 0, LIBRAW_MOUNT_Canon_EF, 0, 0 },
+  { LIBRAW_CAMERAMAKER_Kodak,     "DCS Pro SLR/c", 0, NULL, 0, LIBRAW_MOUNT_Canon_EF, 0, 0 },
+  { LIBRAW_CAMERAMAKER_Kodak,     "DCS",           0, NULL, 0, LIBRAW_MOUNT_Nikon_F, 0, 0 },
+  { LIBRAW_CAMERAMAKER_Kodak,     "EOS",           0, NULL, 0, LIBRAW_MOUNT_Canon_EF, 0, 0 },
+  { LIBRAW_CAMERAMAKER_Kodak,     "NC2000",        0, NULL, 0, LIBRAW_MOUNT_Nikon_F, 0, 0 }, // AP "News Camera"
+  { LIBRAW_CAMERAMAKER_Kodak,     "Pixpro S-1",    0, NULL, 0, LIBRAW_MOUNT_mFT, 0, 0 },
+  { LIBRAW_CAMERAMAKER_Kodak,     "ProBack",       0, NULL, 0, LIBRAW_MOUNT_DigitalBack, 0, 0 },
+  { LIBRAW_CAMERAMAKER_Kodak,     "SCS1000",       0, NULL, 0, LIBRAW_MOUNT_Canon_EF, 0, 0 },
+  { LIBRAW_CAMERAMAKER_Kodak,     "",              0, NULL, 0, LIBRAW_MOUNT_FixedLens, 0, 0 },
+
+  { LIBRAW_CAMERAMAKER_Minolta,   "DG-5D",  LIBRAW_MR_EXACT,  NULL, LIBRAW_FORMAT_APSC, LIBRAW_MOUNT_Minolta_A, 0, 0 },
+  { LIBRAW_CAMERAMAKER_Minolta,   "DG-7D",  LIBRAW_MR_EXACT,  NULL, LIBRAW_FORMAT_APSC, LIBRAW_MOUNT_Minolta_A, 0, 0 },
+  { LIBRAW_CAMERAMAKER_Minolta,   "DiMAGE", LIBRAW_MR_NOCASE, NULL, 0, LIBRAW_MOUNT_FixedLens, 0, 0 },
+
+  { LIBRAW_CAMERAMAKER_Casio,     "",       0, NULL, 0, LIBRAW_MOUNT_FixedLens, 0, 0 },
+  { LIBRAW_CAMERAMAKER_Creative,  "",       0, NULL, 0, LIBRAW_MOUNT_FixedLens, 0, 0 },
+
+  { LIBRAW_CAMERAMAKER_Sigma,     "fp",     0, NULL, LIBRAW_FORMAT_FF, LIBRAW_MOUNT_LPS_L, 0, 0 },
+  { LIBRAW_CAMERAMAKER_Sigma,     "SD1",    LIBRAW_MR_EXACT,  NULL,           LIBRAW_FORMAT_SigmaMerrill, LIBRAW_MOUNT_Sigma_X3F, 0, 0 },
+  { LIBRAW_CAMERAMAKER_Sigma,     "SD",     LIBRAW_MR_NOCASE, "????M",        LIBRAW_FORMAT_SigmaMerrill, LIBRAW_MOUNT_Sigma_X3F, 0, 0 },
+  { LIBRAW_CAMERAMAKER_Sigma,     "SD",     LIBRAW_MR_NOCASE, "???????????H", LIBRAW_FORMAT_SigmaAPSH, LIBRAW_MOUNT_Sigma_X3F, 0, 0 }, // 'sd Quattro H'
+  { LIBRAW_CAMERAMAKER_Sigma,     "SD",     LIBRAW_MR_NOCASE, "????Q",        LIBRAW_FORMAT_APSC, LIBRAW_MOUNT_Sigma_X3F, 0, 0 },      // 'sd Quattro'
+  { LIBRAW_CAMERAMAKER_Sigma,     "SD",     LIBRAW_MR_NOCASE, NULL,           LIBRAW_FORMAT_SigmaAPSC, LIBRAW_MOUNT_Sigma_X3F, 0, 0 },
+  { LIBRAW_CAMERAMAKER_Sigma,     "DP",     LIBRAW_MR_NOCASE, "????M",        LIBRAW_FORMAT_SigmaMerrill, LIBRAW_MOUNT_FixedLens, 0, 0 },
+  { LIBRAW_CAMERAMAKER_Sigma,     "DP",     LIBRAW_MR_NOCASE, "????Q",        LIBRAW_FORMAT_APSC, LIBRAW_MOUNT_FixedLens, 0, 0 },
+  { LIBRAW_CAMERAMAKER_Sigma,     "DP",     LIBRAW_MR_NOCASE, NULL,           LIBRAW_FORMAT_SigmaAPSC, LIBRAW_MOUNT_FixedLens, 0, 0 },
+
+  { LIBRAW_CAMERAMAKER_Konica,    "KD-",    LIBRAW_MR_MODEL, NULL, 0, LIBRAW_MOUNT_FixedLens, 0, 0 }, // Konica KD-400Z, KD-510Z
+
+  { LIBRAW_CAMERAMAKER_Mamiya,    "ZD",     0, NULL, LIBRAW_FORMAT_3648, LIBRAW_MOUNT_Mamiya645, 0, 0 },
+
+  { LIBRAW_CAMERAMAKER_Sony,      "XCD-",     0, NULL, 0, LIBRAW_MOUNT_C, 0, 0 },
+  { LIBRAW_CAMERAMAKER_Sony,      "DSC-V3",   LIBRAW_MR_SONY_DSC, NULL, 0, LIBRAW_MOUNT_FixedLens, 0, 0 },
+  { LIBRAW_CAMERAMAKER_Sony,      "DSC-F828", LIBRAW_MR_SONY_DSC, NULL, 0, LIBRAW_MOUNT_FixedLens, 0, 0 },
+
+  { LIBRAW_CAMERAMAKER_Polaroid,  "x530",     0, NULL, 0, LIBRAW_MOUNT_FixedLens, 0, 0 },
+  { LIBRAW_CAMERAMAKER_Rollei,    "d530flex", 0, NULL, 0, LIBRAW_MOUNT_FixedLens, 0, 0 },
+  { LIBRAW_CAMERAMAKER_Pentax,    "Optio",    0, NULL, 0, LIBRAW_MOUNT_FixedLens, 0, 0 },
+  { LIBRAW_CAMERAMAKER_Epson,     "R-D1",     0, NULL, LIBRAW_FORMAT_APSC, LIBRAW_MOUNT_Leica_M, 0, 0 },
+};
+// clang-format on
+
+#endif
@@ -110,6 +110,11 @@ extern "C"
   DllDef int libraw_open_buffer(libraw_data_t *, const void *buffer, size_t size);
   DllDef int libraw_unpack(libraw_data_t *);
   DllDef int libraw_unpack_thumb(libraw_data_t *);
+  DllDef int libraw_unpack_thumb_ex(libraw_data_t *, int);
+  DllDef int libraw_thumb_to_buffer(libraw_data_t *, int, void *buffer,
+                                    size_t bufsize);
+  DllDef int libraw_thumb_direct_data(libraw_data_t *, int, const void **data,
+                                      size_t *size);
   DllDef void libraw_recycle_datastream(libraw_data_t *);
   DllDef void libraw_recycle(libraw_data_t *);
   DllDef void libraw_close(libraw_data_t *);
@@ -133,6 +138,8 @@ extern "C"
                                            void *datap);
   DllDef void libraw_set_progress_handler(libraw_data_t *, progress_callback cb,
                                           void *datap);
+  DllDef void libraw_set_executor(libraw_data_t *, libraw_executor_callback cb,
+                                  void *datap);
 #ifndef LIBRAW_NO_CONFIGURABLE_TIFF_METADATA
   class tiff_header;
   DllDef void libraw_set_export_metadata_handler(
@@ -155,6 +162,10 @@ extern "C"
                                           const char *filename);
   DllDef int libraw_dcraw_thumb_writer(libraw_data_t *lr, const char *fname);
   DllDef int libraw_dcraw_process(libraw_data_t *lr);
+  DllDef int libraw_begin_render_session(libraw_data_t *lr);
+  DllDef void libraw_end_render_session(libraw_data_t *lr);
+  DllDef int libraw_set_output_buffer(libraw_data_t *lr,
+                                      libraw_output_buffer_t *buf);
   DllDef libraw_processed_image_t *
   libraw_dcraw_make_mem_image(libraw_data_t *lr, int *errc);
   DllDef libraw_processed_image_t *
@@ -183,12 +194,43 @@ extern "C"
   DllDef libraw_lensinfo_t *libraw_get_lensinfo(libraw_data_t *lr);
   DllDef libraw_imgother_t *libraw_get_imgother(libraw_data_t *lr);
 
+  /* batch processing */
+  DllDef libraw_batch_t *libraw_batch_init(unsigned int flags);
+  DllDef libraw_output_params_t *libraw_batch_params(libraw_batch_t *b);
+  DllDef libraw_raw_unpack_params_t *libraw_batch_rawparams(libraw_batch_t *b);
+  DllDef void libraw_batch_set_options(libraw_batch_t *b, unsigned stages,
+                                       int workers, int threads);
+  DllDef void libraw_batch_set_callback(libraw_batch_t *b,
+                                        libraw_batch_callback cb, void *data);
+  DllDef int libraw_batch_add(libraw_batch_t *b, const char *input,
+                              const char *output);
+  DllDef int libraw_batch_run(libraw_batch_t *b);
+  DllDef int libraw_batch_count(libraw_batch_t *b);
+  DllDef const libraw_batch_result_t *libraw_batch_result(libraw_batch_t *b,
+                                                          int index);
+  DllDef void libraw_batch_cancel(libraw_batch_t *b);
+  DllDef void libraw_batch_close(libraw_batch_t *b);
+
+  /* asynchronous unpack/process */
+  DllDef void libraw_set_async_launcher(libraw_data_t *,
+                                        libraw_async_launcher cb, void *data);
+  DllDef libraw_async_t *libraw_start_async(libraw_data_t *, unsigned stages);
+  DllDef libraw_async_t *libraw_unpack_async(libraw_data_t *);
+  DllDef libraw_async_t *libraw_dcraw_process_async(libraw_data_t *);
+  DllDef int libraw_async_wait(libraw_async_t *a, int msec);
+  DllDef int libraw_async_result(libraw_async_t *a);
+  DllDef void libraw_async_cancel(libraw_async_t *a);
+  DllDef void libraw_async_status(libraw_async_t *a, libraw_async_status_t *st);
+  DllDef void libraw_async_close(libraw_async_t *a);
+
 #ifdef __cplusplus
 }
 #endif
 
 #ifdef __cplusplus
 
+class LibRaw_async;
+
 class DllDef LibRaw
 {
 public:
@@ -223,6 +265,11 @@ public:
   void recycle_datastream();
   int unpack(void);
   int unpack_thumb(void);
+  /* imgdata.thumbs_list entries: switch to and load one as unpack_thumb()
+     does, copy stored JPEG bytes, or point into memory-backed input */
+  int unpack_thumb_ex(int idx);
+  int thumb_to_buffer(int idx, void *buffer, size_t bufsize);
+  int thumb_direct_data(int idx, const void **data, size_t *size);
   int thumbOK(INT64 maxsz = -1);
   int adjust_sizes_info_only(void);
   int subtract_black();
@@ -257,6 +304,36 @@ public:
     callbacks.export_modify_metadata_cb = cb;
     callbacks.export_modify_metadata_cb_data = data;
   }
+  void set_executor(libraw_executor_callback cb, void *data)
+  {
+    callbacks.executor_data = data;
+    callbacks.executor_cb = cb;
+  }
+  void set_async_launcher(libraw_async_launcher cb, void *data)
+  {
+    callbacks.async_data = data;
+    callbacks.async_cb = cb;
+  }
+  /* start unpack()/dcraw_process()/both (LIBRAW_ASYNC_* bits) in the
+     background; returns NULL if the job cannot be started. Delete the
+     handle when done, the object must not be used until then */
+  LibRaw_async *start_async(unsigned stages);
+  LibRaw_async *unpack_async() { return start_async(LIBRAW_ASYNC_UNPACK); }
+  LibRaw_async *dcraw_process_async()
+  {
+    return start_async(LIBRAW_ASYNC_PROCESS);
+  }
+  /* thread budgets: rawparams.max_threads / params.max_threads limited by
+     omp_get_max_threads(). Without OpenMP: the limit itself, if not set
+     raw_threads() is 1 and process_threads() is 0 (no limit) */
+  int raw_threads();
+  int process_threads();
+  /* runs task(data, i) for i in [0, count) on the executor (if set) or on
+     at most nthreads OpenMP threads. Tasks must not throw. */
+  void run_parallel(int count, int nthreads, libraw_task_function task,
+                    void *data);
+  /* number of tasks run_parallel() may run at once */
+  int parallel_width(int count, int nthreads);
 
   static const char* cameramakeridx2maker(unsigned maker);
   int setMakeFromIndex(unsigned index);
@@ -275,6 +352,13 @@ public:
   int dcraw_ppm_tiff_writer(const char *filename);
   int dcraw_thumb_writer(const char *fname);
   int dcraw_process(void);
+  /* render session: cache interpolated image, repeated dcraw_process()
+     calls re-run only white balance and later stages */
+  int begin_render_session();
+  void end_render_session();
+  /* write processed image directly into caller's buffer,
+     NULL to unregister */
+  int set_output_buffer(libraw_output_buffer_t *buf);
   /* information calls */
   int is_fuji_rotated()
   {
@@ -299,6 +383,8 @@ public:
 
   /* free all internal data structures */
   void recycle();
+  /* recycle() and restore parameters and callbacks to constructor defaults */
+  void reset(unsigned int flags = LIBRAW_OPTIONS_NONE);
   virtual ~LibRaw(void);
 
   int COLOR(int row, int col)
@@ -364,6 +450,9 @@ protected:
 
   int is_curve_linear();
   void checkCancel();
+  /* checkCancel() for parallel tasks: does not throw nor clear the flag,
+     checkCancel() should follow the parallel loop */
+  int cancelRequested();
   void cam_xyz_coeff(float _rgb_cam[3][4], double cam_xyz[4][3]);
   void phase_one_allocate_tempbuffer();
   void phase_one_free_tempbuffer();
@@ -373,6 +462,15 @@ protected:
   virtual void copy_fuji_uncropped(unsigned short cblack[4],
                                    unsigned short *dmaxp);
   virtual void copy_bayer(unsigned short cblack[4], unsigned short *dmaxp);
+  unsigned short copy_fuji_uncropped_row(int row, unsigned short cblack[4]);
+  unsigned short copy_bayer_row(int row, unsigned short cblack[4]);
+  static void copy_fuji_uncropped_task(void *, int);
+  static void copy_bayer_task(void *, int);
+  virtual void copy_bayer_binned(unsigned short cblack[4],
+                                 unsigned short *dmaxp);
+  unsigned short copy_bayer_binned_row(int row, unsigned short cblack[4]);
+  static void copy_bayer_binned_task(void *, int);
+  int preview_bin_factor();
   virtual void fuji_rotate();
   virtual void convert_to_rgb_loop(float out_cam[3][4]);
   virtual void lin_interpolate_loop(int *code, int size);
@@ -384,11 +482,16 @@ protected:
                    INT64 *offsets, unsigned *sizes, uchar *q_bases);
   void fuji_decode_strip(struct fuji_compressed_params *info_common,
                          int cur_block, INT64 raw_offset, unsigned size, uchar *q_bases);
+  static void fuji_decode_strip_task(void *, int);
+  /* Sony ARW2 decoder public interface (to make parallel decoder) */
+  virtual void sony_arw2_decode_loop(uchar *data, int row_start, int rows);
   /* CR3 decoder public interface to make parallel decoder */
   virtual void crxLoadDecodeLoop(void *, int);
   int crxDecodePlane(void *, uint32_t planeNumber);
   virtual void crxLoadFinalizeLoopE3(void *, int);
   void crxConvertPlaneLineDf(void *, int);
+  static void crxDecodePlaneTask(void *, int);
+  static void crxConvertPlaneLineTask(void *, int);
 
   int FCF(int row, int col)
   {
@@ -422,18 +525,30 @@ protected:
   tiff_ifd_t tiff_ifd[LIBRAW_IFD_MAXCOUNT];
   libraw_memmgr memmgr;
   libraw_callbacks_t callbacks;
+  friend class LibRaw_async; /* chains progress_cb while the job runs */
+  friend struct AAHD;        /* checkCancel() in the row loops */
 
   void (LibRaw::*write_thumb)();
   void (LibRaw::*write_fun)();
   void (LibRaw::*load_raw)();
   void (LibRaw::*thumb_load_raw)();
+  /* identify() choice, restored by unpack_thumb_ex() */
+  void (LibRaw::*default_write_thumb)();
+  void (LibRaw::*default_thumb_load_raw)();
   void (LibRaw::*pentax_component_load_raw)();
 
   void kodak_thumb_loader();
+  int add_thumbnail(enum LibRaw_thumbnail_formats fmt, INT64 offset,
+                    unsigned length, ushort width, ushort height,
+                    unsigned misc);
+  void list_tiff_thumbnail(int ifd);
+  void list_default_thumbnail();
+  int select_thumbnail(int idx);
   void write_thumb_ppm_tiff(FILE *);
 #ifdef USE_X3FTOOLS
   void x3f_thumb_loader();
   INT64 x3f_thumb_size();
+  void x3f_set_input(LibRaw_abstract_datastream *stream);
 #endif
 
   int own_filtering_supported() { return 0; }
@@ -444,7 +559,16 @@ protected:
   void write_ppm_tiff();
   void convert_to_rgb();
   void remove_zeroes();
+  void set_masked_areas();
   void crop_masked_pixels();
+  /* rawparams.roi: raw area to decode, cropbox with margin to process */
+  void set_decode_roi();
+  void decode_roi_rows(unsigned *row0, unsigned *row1);
+  int decode_roi_skip(unsigned row, unsigned col, unsigned rows,
+                      unsigned cols);
+  int decode_roi_covers();
+  int process_cropbox(unsigned box[4]);
+  void crop_roi_margin();
 #ifndef NO_LCMS
   void apply_profile(const char *, const char *);
 #endif
@@ -467,7 +591,21 @@ protected:
   void subtract(const char *);
   void hat_transform(float *temp, float *base, int st, int size, int sc);
   void wavelet_denoise();
+  static void wavelet_denoise_task(void *, int);
+  void wavelet_denoise_band(void *task, int band);
   void scale_colors();
+  int scale_colors_auto_wb_needed();
+  void scale_colors_auto_wb(float auto_mul[4]);
+  void scale_colors_multipliers(const float auto_mul[4], float scale_mul[4]);
+  int render_cache_matches();
+  int dcraw_process_cached();
+  void dcraw_process_finish();
+  int dcraw_process_result();
+  int output_buffer_fits();
+  int output_buffer_linear();
+  void convert_to_rgb_output(float out_cam[3][4]);
+  void write_output_buffer();
+  void output_gamma_curve();
   void median_filter();
   void blend_highlights();
   void recover_highlights();
@@ -489,6 +627,9 @@ protected:
   void gamma_curve(double pwr, double ts, int mode, int imax);
   void cubic_spline(const int *x_, const int *y_, const int len);
 
+  libraw_render_cache_t *render_cache;
+  void init_default_params(unsigned int flags);
+
   /* RawSpeed data */
   void *_rawspeed_camerameta;
   void *_rawspeed_decoder;
@@ -518,6 +659,136 @@ protected:
 #endif
 };
 
+/*
+   Keeps constructed LibRaw objects for reuse by short-lived jobs.
+   acquire() returns an object in its just-constructed state; release()
+   resets it (LibRaw::reset()) and keeps up to max_idle objects idle.
+   Thread-safe unless LIBRAW_NOTHREADS is defined.
+ */
+class DllDef LibRaw_pool
+{
+public:
+  LibRaw_pool(unsigned max_idle = 16, unsigned int flags = LIBRAW_OPTIONS_NONE);
+  virtual ~LibRaw_pool();
+  LibRaw *acquire();
+  void release(LibRaw *lr);
+  /* construct idle objects in advance, up to min(count, max_idle) */
+  void reserve(unsigned count);
+  unsigned idle_count();
+
+protected:
+  /* override to pool objects of a LibRaw-derived class */
+  virtual LibRaw *create() { return new LibRaw(flags); }
+  void lock();
+  void unlock();
+  LibRaw **idle;
+  unsigned nidle, maxidle;
+  unsigned int flags;
+  void *mutex;
+
+private:
+  LibRaw_pool(const LibRaw_pool &);
+  LibRaw_pool &operator=(const LibRaw_pool &);
+};
+
+/* Batch processor
+   Runs open_file(), unpack(), dcraw_process() and dcraw_ppm_tiff_writer()
+   (as selected by stages) over a list of files on a pool of worker threads.
+   Larger files are scheduled first; idle workers steal queued files from
+   busy ones. Files below small_image raw pixels are processed with one
+   OpenMP thread, larger ones with the thread budget divided between the
+   workers still running. Without threads support files are processed
+   sequentially by the calling thread.
+ */
+class DllDef LibRaw_batch
+{
+public:
+  LibRaw_batch(unsigned int flags = LIBRAW_OPTIONS_NONE);
+  virtual ~LibRaw_batch();
+
+  libraw_output_params_t params;      /* copied to each worker's imgdata */
+  libraw_raw_unpack_params_t rawparams;
+  unsigned stages;      /* LIBRAW_BATCH_* bits, open_file() is always done */
+  int workers;          /* 0: one per budget thread, limited by file count */
+  int threads;          /* total thread budget, 0: OpenMP/hardware default */
+  unsigned small_image; /* raw pixels, default 4M */
+
+  /* output may be NULL: LIBRAW_BATCH_WRITE is skipped for this file */
+  int add(const char *input, const char *output = NULL);
+  /* called after the last stage, before recycle(); calls are serialized.
+     Nonzero return cancels the batch */
+  void set_callback(libraw_batch_callback cb, void *data)
+  {
+    callback = cb;
+    callback_data = data;
+  }
+  /* returns number of files with status != LIBRAW_SUCCESS */
+  int run();
+  /* may be called from any thread (or callback) while run() is active */
+  void cancel();
+  int count() { return njobs; }
+  const libraw_batch_result_t *result(int idx)
+  {
+    return idx >= 0 && idx < njobs ? &results[idx] : NULL;
+  }
+
+protected:
+  /* override to process files with a LibRaw-derived class */
+  virtual LibRaw *create() { return new LibRaw(flags); }
+  virtual int process_file(LibRaw *lr, int idx);
+  void worker(int w);
+  libraw_batch_result_t *results;
+  INT64 *fsizes;
+  int njobs, maxjobs;
+  unsigned int flags;
+  libraw_batch_callback callback;
+  void *callback_data;
+  void *sched;
+
+private:
+  LibRaw_batch(const LibRaw_batch &);
+  LibRaw_batch &operator=(const LibRaw_batch &);
+};
+
+/* Asynchronous job: unpack() and/or dcraw_process() of an opened LibRaw
+   object. Runs on the launcher set by LibRaw::set_async_launcher(), on a
+   new thread if none (or in start() itself if built with LIBRAW_NOTHREADS).
+   The processor must not be used while the job runs. cancel() stops the
+   job at the next cancellation point (progress reports and per-row checks
+   in decoders and demosaics). The destructor cancels and waits for the job.
+ */
+class DllDef LibRaw_async
+{
+public:
+  LibRaw_async(LibRaw *processor);
+  virtual ~LibRaw_async();
+
+  /* LIBRAW_ASYNC_* bits. LIBRAW_OUT_OF_ORDER_CALL if a job is running */
+  int start(unsigned stages);
+  /* msec < 0: no timeout. Returns 1 if the job is finished, 0 on timeout */
+  int wait(int msec = -1);
+  int finished();
+  /* job return code, LIBRAW_CANCELLED_BY_CALLBACK if cancelled */
+  int result();
+  /* may be called from any thread, including progress callback */
+  void cancel();
+  void status(libraw_async_status_t *st);
+  LibRaw *processor() { return lr; }
+
+protected:
+  /* override to run other steps on the job thread */
+  virtual int run(unsigned stages);
+  static void job(void *data, int);
+  static int progress(void *data, enum LibRaw_progress stage, int iteration,
+                      int expected);
+  LibRaw *lr;
+  void *state;
+
+private:
+  LibRaw_async(const LibRaw_async &);
+  LibRaw_async &operator=(const LibRaw_async &);
+};
+
 #ifdef LIBRAW_LIBRARY_BUILD
 ushort libraw_sget2_static(short _order, uchar *s);
 unsigned libraw_sget4_static(short _order, uchar *s);
@@ -528,14 +799,19 @@ float   libraw_int_to_float (int i);
 
 
 #ifdef LIBRAW_LIBRARY_BUILD
+/* progress report, also a cancellation point for setCancelFlag() */
 #define RUN_CALLBACK(stage, iter, expect)                                      \
-  if (callbacks.progress_cb)                                                   \
+  do                                                                           \
   {                                                                            \
-    int rr = (*callbacks.progress_cb)(callbacks.progresscb_data, stage, iter,  \
-                                      expect);                                 \
-    if (rr != 0)                                                               \
-      throw LIBRAW_EXCEPTION_CANCELLED_BY_CALLBACK;                            \
-  }
+    checkCancel();                                                             \
+    if (callbacks.progress_cb)                                                 \
+    {                                                                          \
+      int rr = (*callbacks.progress_cb)(callbacks.progresscb_data, stage,      \
+                                        iter, expect);                         \
+      if (rr != 0)                                                             \
+        throw LIBRAW_EXCEPTION_CANCELLED_BY_CALLBACK;                          \
+    }                                                                          \
+  } while (0)
 #endif
 
 #endif /* __cplusplus */
@@ -24,6 +24,11 @@ it under the terms of the one of two licenses as you choose:
 #define LIBRAW_MAX_ALLOC_MB_DEFAULT 2048L
 #endif
 
+/* border around rawparams.roi: decoded and demosaiced, then cropped off */
+#ifndef LIBRAW_ROI_MARGIN
+#define LIBRAW_ROI_MARGIN 16
+#endif
+
 /* limit thumbnail size, default is 512Mb*/
 #ifndef LIBRAW_MAX_THUMBNAIL_MB
 #define LIBRAW_MAX_THUMBNAIL_MB 512L
@@ -53,6 +58,7 @@ LIBRAW_MEMPOOL_CHECK define will result in error on pool overflow */
 #define LIBRAW_IFD_MAXCOUNT 10
 #define LIBRAW_CRXTRACKS_MAXCOUNT 16
 #define LIBRAW_AFDATA_MAXCOUNT 4
+#define LIBRAW_THUMBNAIL_MAXCOUNT 8
 
 #define LIBRAW_AHD_TILE 512
 
@@ -576,7 +582,8 @@ enum LibRaw_processing_options
   LIBRAW_RAWOPTIONS_PROVIDE_NONSTANDARD_WB = 1 << 16,
   LIBRAW_RAWOPTIONS_CAMERAWB_FALLBACK_TO_DAYLIGHT = 1 << 17,
   LIBRAW_RAWOPTIONS_CHECK_THUMBNAILS_KNOWN_VENDORS = 1 << 18,
-  LIBRAW_RAWOPTIONS_CHECK_THUMBNAILS_ALL_VENDORS = 1 << 19
+  LIBRAW_RAWOPTIONS_CHECK_THUMBNAILS_ALL_VENDORS = 1 << 19,
+  LIBRAW_RAWOPTIONS_METADATA_ONLY = 1 << 20
 };
 
 enum LibRaw_decoder_flags
@@ -696,6 +703,7 @@ enum LibRaw_errors
   LIBRAW_UNSUPPORTED_THUMBNAIL = -6,
   LIBRAW_INPUT_CLOSED = -7,
   LIBRAW_NOT_IMPLEMENTED = -8,
+  LIBRAW_BAD_OUTPUT_BUFFER = -9,
   LIBRAW_UNSUFFICIENT_MEMORY = -100007,
   LIBRAW_DATA_ERROR = -100008,
   LIBRAW_IO_ERROR = -100009,
@@ -707,6 +715,39 @@ enum LibRaw_errors
 
 #define LIBRAW_FATAL_ERROR(ec) ((ec) < -100000)
 
+enum LibRaw_batch_stages
+{
+  LIBRAW_BATCH_UNPACK = 1,
+  LIBRAW_BATCH_PROCESS = 1 << 1,
+  LIBRAW_BATCH_WRITE = 1 << 2,
+  LIBRAW_BATCH_ALL = LIBRAW_BATCH_UNPACK | LIBRAW_BATCH_PROCESS | LIBRAW_BATCH_WRITE
+};
+
+enum LibRaw_async_stages
+{
+  LIBRAW_ASYNC_UNPACK = 1,
+  LIBRAW_ASYNC_PROCESS = 1 << 1,
+  LIBRAW_ASYNC_ALL = LIBRAW_ASYNC_UNPACK | LIBRAW_ASYNC_PROCESS
+};
+
+/* libraw_output_buffer_t.format: channel layout | sample type */
+enum LibRaw_output_buffer_formats
+{
+  LIBRAW_OUTBUF_RGB = 0,
+  LIBRAW_OUTBUF_BGR = 1,
+  LIBRAW_OUTBUF_RGBA = 2,
+  LIBRAW_OUTBUF_BGRA = 3,
+  LIBRAW_OUTBUF_LAYOUT_MASK = 3,
+  LIBRAW_OUTBUF_8BIT = 0,
+  LIBRAW_OUTBUF_16BIT = 1 << 4,
+  LIBRAW_OUTBUF_FLOAT = 2 << 4,
+  LIBRAW_OUTBUF_SAMPLE_MASK = 3 << 4,
+  /* one plane per channel, each of stride*height bytes */
+  LIBRAW_OUTBUF_PLANAR = 1 << 6,
+  /* FLOAT only: scene-linear, unclipped, no output curve */
+  LIBRAW_OUTBUF_LINEAR = 1 << 7
+};
+
 enum LibRaw_thumbnail_formats
 {
   LIBRAW_THUMBNAIL_UNKNOWN = 0,
@@ -48,6 +48,7 @@ it under the terms of the one of two licenses as you choose:
 #include <fstream>
 #include <memory>
 #include <vector>
+#include <map>
 
 #if defined(_WIN32) && (_MSC_VER) >= 1500
 #define WIN32SECURECALLS
@@ -100,6 +101,17 @@ public:
 #endif
   virtual int jpeg_src(void *);
   virtual void buffering_off() {}
+  /* hint: ranges (tiles/strips) will be read soon, in this order */
+  virtual void read_ahead(int /*count*/, const INT64 * /*offsets*/,
+                          const INT64 * /*lengths*/) {}
+  /* nonzero if read_ahead() is used: callers skip collecting ranges
+     otherwise */
+  virtual int has_read_ahead() { return 0; }
+  /* memory-backed streams: pointer to length bytes at offset, or NULL */
+  virtual const void *mapped(INT64 /*offset*/, INT64 /*length*/)
+  {
+    return NULL;
+  }
   /* reimplement in subclass to use parallel access in xtrans_load_raw() if
    * OpenMP is not used */
   virtual int lock() { return 1; } /* success */
@@ -263,6 +275,7 @@ public:
   virtual INT64 size() { return streamsize; }
   virtual char *gets(char *s, int sz);
   virtual int scanf_one(const char *fmt, void *val);
+  virtual const void *mapped(INT64 offset, INT64 length);
   virtual int get_char()
   {
     if (streampos >= streamsize)   return -1;
@@ -316,6 +329,220 @@ protected:
 #endif
 };
 
+/* Block cache over another datastream, used for metadata parsing: small
+   reads are served from cached blocks, reads of one block or more go
+   directly to the parent stream. Parent stream is not owned. */
+class DllDef LibRaw_prefetch_datastream : public LibRaw_abstract_datastream
+{
+public:
+  LibRaw_prefetch_datastream(LibRaw_abstract_datastream *parent,
+                             int blocksize = 0x10000, int maxblocks = 64,
+                             int headsize = 0x40000);
+  virtual ~LibRaw_prefetch_datastream();
+  virtual int valid();
+#ifdef LIBRAW_OLD_VIDEO_SUPPORT
+  virtual void *make_jas_stream();
+#endif
+  virtual int read(void *ptr, size_t size, size_t nmemb);
+  virtual int eof();
+  virtual int seek(INT64 o, int whence);
+  virtual INT64 tell();
+  virtual INT64 size() { return _fsize; }
+  virtual char *gets(char *s, int sz);
+  virtual int scanf_one(const char *fmt, void *val);
+  virtual int get_char();
+  virtual const char *fname();
+#ifdef LIBRAW_WIN32_UNICODEPATHS
+  virtual const wchar_t *wfname();
+#endif
+  virtual void read_ahead(int count, const INT64 *offsets,
+                          const INT64 *lengths)
+  {
+    parent->read_ahead(count, offsets, lengths);
+  }
+  virtual int has_read_ahead() { return parent->has_read_ahead(); }
+  virtual const void *mapped(INT64 offset, INT64 length)
+  {
+    return parent->mapped(offset, length);
+  }
+  LibRaw_abstract_datastream *parent_stream() { return parent; }
+  /* number of read() calls issued to the parent stream */
+  unsigned parent_reads() { return preads; }
+
+protected:
+  struct cache_block
+  {
+    INT64 start;
+    std::vector<unsigned char> data;
+    unsigned lastuse;
+  };
+  cache_block *find_block(INT64 off);
+  cache_block *load_block(INT64 off);
+  LibRaw_abstract_datastream *parent;
+  std::vector<cache_block> blocks;
+  INT64 _fsize, _fpos;
+  int blocksize, maxblocks, headsize;
+  unsigned usecount, preads;
+};
+
+/* Pass-through wrapper recording every read/seek on parent stream
+   (offset, length, stage set by caller via set_stage()). Used to find
+   which file ranges open/unpack/unpack_thumb actually touch.
+   Parent stream is not owned. */
+class DllDef LibRaw_tracing_datastream : public LibRaw_abstract_datastream
+{
+public:
+  enum trace_event_type
+  {
+    TRACE_READ = 1,
+    TRACE_SEEK = 2,
+    TRACE_JPEG_SRC = 3 /* jpeg_src() at offset, libjpeg reads not seen */
+  };
+  struct trace_event
+  {
+    INT64 offset;
+    INT64 length; /* bytes actually read, 0 for seek */
+    int stage;
+    int type;
+  };
+  struct trace_summary
+  {
+    INT64 bytes_read;   /* sum of all reads */
+    INT64 unique_bytes; /* distinct file bytes touched */
+    unsigned reads;     /* read calls (get_char runs counted once) */
+    unsigned seeks;     /* seeks changing file position */
+    unsigned spans;     /* contiguous ranges covering unique_bytes */
+    unsigned jpeg_srcs; /* jpeg_src() calls */
+  };
+
+  LibRaw_tracing_datastream(LibRaw_abstract_datastream *parent);
+  virtual ~LibRaw_tracing_datastream() {}
+  virtual int valid() { return parent ? parent->valid() : 0; }
+#ifdef LIBRAW_OLD_VIDEO_SUPPORT
+  virtual void *make_jas_stream() { return parent->make_jas_stream(); }
+#endif
+  virtual int read(void *ptr, size_t size, size_t nmemb);
+  virtual int eof() { return parent->eof(); }
+  virtual int seek(INT64 o, int whence);
+  virtual INT64 tell() { return parent->tell(); }
+  virtual INT64 size() { return parent->size(); }
+  virtual char *gets(char *s, int sz);
+  virtual int scanf_one(const char *fmt, void *val);
+  virtual int get_char();
+  virtual const char *fname() { return parent->fname(); }
+#ifdef LIBRAW_WIN32_UNICODEPATHS
+  virtual const wchar_t *wfname() { return parent->wfname(); }
+#endif
+  virtual void read_ahead(int count, const INT64 *offsets,
+                          const INT64 *lengths)
+  {
+    parent->read_ahead(count, offsets, lengths);
+  }
+  virtual int has_read_ahead() { return parent->has_read_ahead(); }
+  virtual int jpeg_src(void *jpegdata);
+  virtual void buffering_off() { parent->buffering_off(); }
+  virtual const void *mapped(INT64 offset, INT64 length);
+  virtual int lock() { return parent->lock(); }
+  virtual void unlock() { parent->unlock(); }
+  LibRaw_abstract_datastream *parent_stream() { return parent; }
+
+  /* following events are attributed to stage 'name' */
+  void set_stage(const char *name);
+  int stage_count() { return int(stages.size()); }
+  const char *stage_name(int stage);
+  const std::vector<trace_event> &events() { return trace; }
+  void clear();
+  /* stage < 0: all stages */
+  trace_summary summary(int stage = -1);
+  /* sorted, merged [start,end) ranges read in stage */
+  std::vector<std::pair<INT64, INT64> > read_spans(int stage = -1);
+  /* per stage and total report: bytes read vs. file size, seeks, spans */
+  void print_summary(FILE *out, int verbose = 0);
+
+protected:
+  void record(int type, INT64 offset, INT64 length);
+  LibRaw_abstract_datastream *parent;
+  std::vector<trace_event> trace;
+  std::vector<std::string> stages;
+  int curstage;
+};
+
+/* Range read callback: read length bytes at offset into buf, return number
+   of bytes read or negative value on error. Should be thread-safe:
+   LibRaw_range_datastream::read_ahead() issues concurrent calls. */
+typedef INT64 (*libraw_range_read_callback)(void *data, INT64 offset,
+                                            INT64 length, void *buf);
+
+/* Input from random-access storage with expensive requests (HTTP range
+   requests to object storage, etc). Data is fetched by user callback in
+   aligned blocks and cached, sequential access grows read-ahead window,
+   ranges passed to read_ahead() are fetched concurrently. */
+class DllDef LibRaw_range_datastream : public LibRaw_abstract_datastream
+{
+public:
+  LibRaw_range_datastream(libraw_range_read_callback cb, void *cbdata,
+                          INT64 fsize, const char *name = NULL,
+                          int blocksize = 0x10000, int maxblocks = 1024);
+  virtual ~LibRaw_range_datastream();
+  virtual int valid();
+#ifdef LIBRAW_OLD_VIDEO_SUPPORT
+  virtual void *make_jas_stream() { return NULL; }
+#endif
+  virtual int read(void *ptr, size_t size, size_t nmemb);
+  virtual int eof() { return _fpos >= _fsize; }
+  virtual int seek(INT64 o, int whence);
+  virtual INT64 tell() { return _fpos; }
+  virtual INT64 size() { return _fsize; }
+  virtual char *gets(char *s, int sz);
+  virtual int scanf_one(const char *fmt, void *val);
+  virtual int get_char();
+  virtual const char *fname() { return name.empty() ? NULL : name.c_str(); }
+  virtual void read_ahead(int count, const INT64 *offsets,
+                          const INT64 *lengths);
+  virtual int has_read_ahead() { return 1; }
+
+  /* sequential read-ahead window, in blocks (defaults: 1 and 16) */
+  void set_read_ahead(int minblocks, int maxblocks);
+  /* statistics: callback calls and bytes fetched */
+  unsigned fetch_count() { return fetches; }
+  INT64 bytes_fetched() { return fetched; }
+
+protected:
+  struct cache_block
+  {
+    std::vector<unsigned char> data;
+    unsigned lastuse;
+  };
+  struct fetch_run
+  {
+    INT64 first; /* block index */
+    int count;   /* blocks */
+  };
+  cache_block *find_block(INT64 bno);
+  cache_block *load_block(INT64 bno);
+  void fetch_runs(std::vector<fetch_run> &runs);
+  void fetch_pending(size_t from);
+  void evict();
+  INT64 fetch(INT64 offset, INT64 length, void *buf);
+
+  libraw_range_read_callback callback;
+  void *cbdata;
+  std::string name;
+  std::map<INT64, cache_block> blocks;
+  cache_block *lastblock;
+  INT64 lastbno;
+  INT64 _fsize, _fpos;
+  int blocksize, maxblocks;
+  /* sequential read-ahead state */
+  int ra_min, ra_max, ra_window;
+  INT64 ra_next;
+  /* ranges from read_ahead() not fetched yet */
+  std::vector<std::pair<INT64, INT64> > pending;
+  size_t pending_next;
+  unsigned usecount, fetches;
+  INT64 fetched;
+};
+
 #ifdef LIBRAW_WIN32_CALLS
 class DllDef LibRaw_windows_datastream : public LibRaw_buffer_datastream
 {
@@ -52,8 +52,12 @@ public:
   uchar jpeg_buffer[4096];
   struct
   {
-    float cbrt[0x10000], xyz_cam[3][4];
+    /* 64K-entry cube root table, allocated and filled on first use by
+       cielab(); it does not depend on the image, so it survives recycle() */
+    float *cbrt, xyz_cam[3][4];
   } ahd_data;
+  LibRaw_TLS() { ahd_data.cbrt = NULL; }
+  ~LibRaw_TLS() { ::free(ahd_data.cbrt); }
   void init()
   {
     getbits.bitbuf = 0;
@@ -61,8 +65,11 @@ public:
     ph1_bits.bitbuf = 0;
     ph1_bits.vbits = 0;
     pana_data.vpos = 0;
-    ahd_data.cbrt[0] = -2.0f;
   }
+
+private:
+  LibRaw_TLS(const LibRaw_TLS &);
+  LibRaw_TLS &operator=(const LibRaw_TLS &);
 };
 
 class LibRaw_constants
@@ -89,10 +96,13 @@ struct internal_data_t
       LibRaw_abstract_datastream *input;
   FILE *output;
   int input_internal;
+  int metadata_only;
   char *meta_data;
   INT64 profile_offset;
   INT64 toffset;
   unsigned pana_black[4];
+  /* thumbs_list entry set up by identify(), -1: not listed */
+  int thumb_default, thumb_default_colors;
 };
 
 #define LIBRAW_HISTOGRAM_SIZE 0x2000
@@ -100,6 +110,8 @@ typedef struct
 {
   int (*histogram)[LIBRAW_HISTOGRAM_SIZE];
   unsigned *oprof;
+  libraw_output_buffer_t *outbuf;
+  float linear_scale;
 } output_data_t;
 
 typedef struct
@@ -172,6 +184,10 @@ typedef struct
 
   unsigned dng_frames[LIBRAW_IFD_MAXCOUNT*2]; /* bits: 0-7: shot_select, 8-15: IFD#, 16-31: low 16 bit of newsubfile type */
   unsigned short raw_stride;
+  /* rawparams.roi with margin at unpack(): top, left, bottom, right; 0: all.
+     Masked areas are decoded too */
+  unsigned roi_box[4];
+  int masked_areas_set;
 } unpacker_data_t;
 
 struct libraw_internal_data_t
@@ -186,6 +202,28 @@ struct libraw_internal_data_t
   unpacker_data_t unpacker_data;
 };
 
+/* Render session: interpolated image and processing state to re-run
+   white balance and later stages without interpolation */
+struct libraw_render_cache_t
+{
+  int building, valid;
+  ushort (*image)[4];
+  libraw_output_params_t params;
+  unsigned roi[4]; /* rawparams.roi */
+  unsigned progress_flags;
+  float auto_mul[4];  /* auto WB multipliers, 0 if not known */
+  float scale_mul[4]; /* multipliers applied to cached image */
+  /* state before scale_colors() */
+  libraw_colordata_t color;
+  libraw_iparams_t iparams;
+  libraw_image_sizes_t sizes;
+  libraw_internal_output_params_t ioparams;
+  /* state after interpolation */
+  libraw_iparams_t iparams_interpolated;
+  libraw_image_sizes_t sizes_interpolated;
+  libraw_internal_output_params_t ioparams_interpolated;
+};
+
 struct decode
 {
   struct decode *branch[2];
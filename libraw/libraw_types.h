@@ -130,6 +130,7 @@ typedef unsigned long long UINT64;
     unsigned zero_is_bad;
     ushort shrink;
     ushort fuji_width;
+    ushort preview_bin;
   } libraw_internal_output_params_t;
 
   typedef void (*memory_callback)(void *data, const char *file,
@@ -152,6 +153,17 @@ typedef unsigned long long UINT64;
   typedef void (*post_identify_callback)(void *ctx);
   typedef void (*process_step_callback)(void *ctx);
   typedef void (*export_image_metadata_callback)(void* libraw_context, void* tiff_header, void* user_data);
+  /* external executor: run task(task_data, i) for every i in [0, count),
+     at most max_parallel at a time (0: no limit), return when all are done */
+  typedef void (*libraw_task_function)(void *task_data, int index);
+  typedef void (*libraw_executor_callback)(void *data, int count,
+                                           int max_parallel,
+                                           libraw_task_function task,
+                                           void *task_data);
+  /* async job launcher: arrange task(task_data, 0) to be called once on
+     some thread, may return before the call */
+  typedef void (*libraw_async_launcher)(void *data, libraw_task_function task,
+                                        void *task_data);
 
   typedef struct
   {
@@ -174,6 +186,10 @@ typedef unsigned long long UINT64;
         post_converttorgb_cb;
     export_image_metadata_callback export_modify_metadata_cb;
     void *export_modify_metadata_cb_data;
+    libraw_executor_callback executor_cb;
+    void *executor_data;
+    libraw_async_launcher async_cb;
+    void *async_data;
   } libraw_callbacks_t;
 
   typedef struct
@@ -184,6 +200,18 @@ typedef unsigned long long UINT64;
     unsigned char data[1];
   } libraw_processed_image_t;
 
+  /* caller-owned buffer filled by dcraw_process() */
+  typedef struct
+  {
+    void *data;
+    INT64 size;      /* bytes available at data */
+    int stride;      /* bytes per output row */
+    unsigned format; /* LibRaw_output_buffer_formats */
+    /* set by dcraw_process() */
+    int width, height;
+    int written;
+  } libraw_output_buffer_t;
+
   typedef struct
   {
     char guard[4];
@@ -779,6 +807,23 @@ typedef unsigned long long UINT64;
     char *thumb;
   } libraw_thumbnail_t;
 
+  /* embedded preview found by open_*(), not loaded */
+  typedef struct
+  {
+    enum LibRaw_thumbnail_formats tformat; /* UNKNOWN: known after load */
+    ushort twidth, theight;
+    unsigned tlength; /* bytes stored in file, 0 if not known */
+    unsigned tmisc;   /* bits per sample | samples << 5 */
+    INT64 toffset;
+  } libraw_thumbnail_item_t;
+
+  typedef struct
+  {
+    int thumbcount;
+    int thumbselected; /* entry loaded by unpack_thumb() */
+    libraw_thumbnail_item_t thumblist[LIBRAW_THUMBNAIL_MAXCOUNT];
+  } libraw_thumbnail_list_t;
+
   typedef struct
   {
     float latitude[3];     /* Deg,min,sec */
@@ -882,6 +927,10 @@ typedef unsigned long long UINT64;
     int no_auto_scale;
     /* Disable intepolation */
     int no_interpolation;
+    /* threads for postprocessing, 0: OpenMP default */
+    int max_threads;
+    /* bin NxN CFA blocks and skip demosaic, 0/1: off */
+    int preview_scale;
   } libraw_output_params_t;
 
   typedef struct  
@@ -899,6 +948,11 @@ typedef unsigned long long UINT64;
       char p4shot_order[5];
       /* Custom camera list */
       char **custom_camera_strings;
+      /* threads for raw data decoding, 0: OpenMP default */
+      int max_threads;
+      /* region of interest: left, top, width, height (cropbox coordinates),
+         zero width or height: full frame */
+      unsigned roi[4];
   }libraw_raw_unpack_params_t;
 
   typedef struct
@@ -1036,10 +1090,39 @@ typedef unsigned long long UINT64;
     libraw_colordata_t color;
     libraw_imgother_t other;
     libraw_thumbnail_t thumbnail;
+    libraw_thumbnail_list_t thumbs_list;
     libraw_rawdata_t rawdata;
     void *parent_class;
   };
 
+  /* per-file result of LibRaw_batch / libraw_batch_run() */
+  typedef struct
+  {
+    const char *input;
+    const char *output;
+    int open_ret, unpack_ret, process_ret, write_ret;
+    int status;  /* first failed stage return code, LIBRAW_SUCCESS if none */
+    int worker;  /* worker index, -1 if file was not processed */
+    int threads; /* OpenMP threads used for unpack/process */
+    double seconds;
+  } libraw_batch_result_t;
+
+  typedef int (*libraw_batch_callback)(void *data, struct libraw_data_t *lr,
+                                       const libraw_batch_result_t *res);
+  typedef struct libraw_batch_handle_t libraw_batch_t;
+
+  /* state of LibRaw_async / libraw_*_async() job */
+  typedef struct
+  {
+    unsigned progress_flags;    /* imgdata.progress_flags */
+    enum LibRaw_progress stage; /* last progress report */
+    int iteration, expected;
+    int finished;
+    int result; /* return code, valid if finished */
+  } libraw_async_status_t;
+
+  typedef struct libraw_async_handle_t libraw_async_t;
+
   struct fuji_q_table
   {
     int8_t *q_table; /* quantization table */
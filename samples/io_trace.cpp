@@ -0,0 +1,113 @@
+/* -*- C++ -*-
+ * File: io_trace.cpp
+ * Copyright 2008-2021 LibRaw LLC (info@libraw.org)
+ *
+ * LibRaw sample
+ * Reports which file ranges are read by open (identify), unpack and
+ * unpack_thumb: bytes read vs. file size, seeks, contiguous spans.
+
+LibRaw is free software; you can redistribute it and/or modify
+it under the terms of the one of two licenses as you choose:
+
+1. GNU LESSER GENERAL PUBLIC LICENSE version 2.1
+   (See file LICENSE.LGPL provided in LibRaw distribution archive for details).
+
+2. COMMON DEVELOPMENT AND DISTRIBUTION LICENSE (CDDL) Version 1.0
+   (See file LICENSE.CDDL provided in LibRaw distribution archive for details).
+
+ */
+#include <stdio.h>
+#include <string.h>
+
+#include "libraw/libraw.h"
+
+#ifdef LIBRAW_WIN32_CALLS
+#define snprintf _snprintf
+#endif
+
+int main(int ac, char *av[])
+{
+  int i, ret;
+  int verbose = 0, do_unpack = 1, do_thumb = 1, metadata_only = 0;
+
+  if (ac < 2)
+  {
+  usage:
+    printf("io_trace - LibRaw %s sample. %d cameras supported\n"
+           "Usage: %s [-v] [-i] [-T] [-m] raw-files....\n"
+           "\t-v - print read spans for each stage\n"
+           "\t-i - open (identify) only, no unpack/unpack_thumb\n"
+           "\t-T - skip unpack, trace unpack_thumb only\n"
+           "\t-m - open with LIBRAW_RAWOPTIONS_METADATA_ONLY (implies -i)\n",
+           LibRaw::version(), LibRaw::cameraCount(), av[0]);
+    return 0;
+  }
+
+  LibRaw *RawProcessor = new LibRaw;
+
+  for (i = 1; i < ac; i++)
+  {
+    if (av[i][0] == '-')
+    {
+      if (av[i][1] == 'v' && av[i][2] == 0)
+        verbose = 1;
+      else if (av[i][1] == 'i' && av[i][2] == 0)
+        do_unpack = do_thumb = 0;
+      else if (av[i][1] == 'T' && av[i][2] == 0)
+        do_unpack = 0;
+      else if (av[i][1] == 'm' && av[i][2] == 0)
+      {
+        metadata_only = 1;
+        do_unpack = do_thumb = 0;
+      }
+      else
+        goto usage;
+      continue;
+    }
+
+    LibRaw_bigfile_datastream file(av[i]);
+    if (!file.valid())
+    {
+      fprintf(stderr, "Cannot open %s\n", av[i]);
+      continue;
+    }
+    LibRaw_tracing_datastream trace(&file);
+
+    if (metadata_only)
+      RawProcessor->imgdata.rawparams.options |=
+          LIBRAW_RAWOPTIONS_METADATA_ONLY;
+    else
+      RawProcessor->imgdata.rawparams.options &=
+          ~LIBRAW_RAWOPTIONS_METADATA_ONLY;
+
+    trace.set_stage("open");
+    if ((ret = RawProcessor->open_datastream(&trace)) != LIBRAW_SUCCESS)
+    {
+      fprintf(stderr, "Cannot open %s: %s\n", av[i], libraw_strerror(ret));
+      RawProcessor->recycle();
+      continue;
+    }
+    if (do_unpack)
+    {
+      trace.set_stage("unpack");
+      if ((ret = RawProcessor->unpack()) != LIBRAW_SUCCESS)
+        fprintf(stderr, "Cannot unpack %s: %s\n", av[i],
+                libraw_strerror(ret));
+    }
+    if (do_thumb)
+    {
+      trace.set_stage("thumb");
+      if ((ret = RawProcessor->unpack_thumb()) != LIBRAW_SUCCESS)
+        fprintf(stderr, "Cannot unpack_thumb %s: %s\n", av[i],
+                libraw_strerror(ret));
+    }
+
+    printf("%s %s\n", RawProcessor->imgdata.idata.make,
+           RawProcessor->imgdata.idata.model);
+    trace.print_summary(stdout, verbose);
+    printf("\n");
+    RawProcessor->recycle();
+  }
+  delete RawProcessor;
+  return 0;
+}
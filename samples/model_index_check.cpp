@@ -0,0 +1,490 @@
+/* -*- C++ -*-
+ * File: model_index_check.cpp
+ * Copyright 2008-2021 LibRaw LLC (info@libraw.org)
+ *
+ * LibRaw sample
+ * Self-check for GetNormalizedModel():
+ * - compares indexed lookups in model alias and unique id tables with
+ *   linear scan over the same tables, for every table name, every supported
+ *   camera model and their case variants;
+ * - runs GetNormalizedModel() for every supported camera, alias table
+ *   entry, some older models and Ricoh GXR lenses (and lower case variants)
+ *   and compares the results with reference output written by an earlier
+ *   build: samples/model_index_check.ref or the file given, -w file writes
+ *   it. The shipped reference was written before the per-maker rules were
+ *   moved to tables.
+
+LibRaw is free software; you can redistribute it and/or modify
+it under the terms of the one of two licenses as you choose:
+
+1. GNU LESSER GENERAL PUBLIC LICENSE version 2.1
+   (See file LICENSE.LGPL provided in LibRaw distribution archive for details).
+
+2. COMMON DEVELOPMENT AND DISTRIBUTION LICENSE (CDDL) Version 1.0
+   (See file LICENSE.CDDL provided in LibRaw distribution archive for details).
+
+ */
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+
+/* GetNormalizedModel() is internal */
+#define LIBRAW_LIBRARY_BUILD
+#include "libraw/libraw.h"
+#include "internal/libraw_model_aliases.h"
+
+#define DEFAULT_REFERENCE "samples/model_index_check.ref"
+
+static int checks = 0, errors = 0;
+
+/* linear scan, as GetNormalizedModel() did before indexing: first matching
+   entry in table order wins */
+template <size_t N, size_t L>
+static const char *linear_find(const char (&table)[N][L], const char *name,
+                               int *alias, int nocase, int aliases_only)
+{
+  const char *canonical = NULL;
+  for (size_t i = 0; i < N; i++)
+  {
+    if (table[i][0] == '@')
+    {
+      canonical = table[i] + 1;
+      if (!aliases_only && !strcmp(name, canonical))
+      {
+        *alias = 0;
+        return canonical;
+      }
+    }
+    else if (canonical && (!strcmp(name, table[i]) ||
+                           (nocase && !strcasecmp(name, table[i]))))
+    {
+      *alias = 1;
+      return canonical;
+    }
+  }
+  return NULL;
+}
+
+template <size_t N>
+static const model_id_t *linear_find(const model_id_t (&table)[N],
+                                     unsigned long long id)
+{
+  for (size_t i = 0; i < N; i++)
+    if (table[i].id == id)
+      return &table[i];
+  return NULL;
+}
+
+template <size_t N, size_t L>
+static void check_aliases(const char *tname, const char (&table)[N][L],
+                          const std::vector<std::string> &names)
+{
+  for (int nocase = 0; nocase < 2; nocase++)
+  {
+    model_alias_index_t index(table, nocase);
+    for (size_t n = 0; n < names.size(); n++)
+      for (int aliases_only = 0; aliases_only < 2; aliases_only++)
+      {
+        int a1 = -1, a2 = -1;
+        const char *r1 = index.find(names[n].c_str(), &a1, aliases_only);
+        const char *r2 =
+            linear_find(table, names[n].c_str(), &a2, nocase, aliases_only);
+        checks++;
+        if (r1 != r2 || (r1 && a1 != a2))
+        {
+          errors++;
+          printf("%s: '%s' (nocase %d, aliases_only %d): index '%s'/%d, "
+                 "linear '%s'/%d\n",
+                 tname, names[n].c_str(), nocase, aliases_only,
+                 r1 ? r1 : "(none)", a1, r2 ? r2 : "(none)", a2);
+        }
+      }
+  }
+}
+
+template <size_t N>
+static void check_ids(const char *tname, const model_id_t (&table)[N])
+{
+  model_id_index_t index(table);
+  for (size_t i = 0; i < N; i++)
+    for (int d = -1; d <= 1; d++)
+    {
+      unsigned long long id = table[i].id + d;
+      const model_id_t *r1 = index.find(id), *r2 = linear_find(table, id);
+      checks++;
+      if (r1 != r2)
+      {
+        errors++;
+        printf("%s: id 0x%llx: index '%s', linear '%s'\n", tname, id,
+               r1 ? r1->t_model : "(none)", r2 ? r2->t_model : "(none)");
+      }
+    }
+}
+
+template <size_t N, size_t L>
+static void add_names(std::vector<std::string> &names,
+                      const char (&table)[N][L])
+{
+  for (size_t i = 0; i < N; i++)
+    names.push_back(table[i][0] == '@' ? table[i] + 1 : table[i]);
+}
+
+class normalize_check_t : public LibRaw
+{
+public:
+  /* identify() state GetNormalizedModel() depends on, for a file with
+     given maker, model, lens name and no makernotes. Strings equal to the
+     input are written as '=' */
+  std::string normalize(unsigned maker, const char *mk, const char *md,
+                        const char *lens)
+  {
+    char line[1024];
+    libraw_iparams_t &id = imgdata.idata;
+    libraw_makernotes_lens_t &ml = imgdata.lens.makernotes;
+    strncpy(id.make, mk, sizeof(id.make) - 1);
+    strncpy(id.model, md, sizeof(id.model) - 1);
+    strncpy(imgdata.lens.Lens, lens, sizeof(imgdata.lens.Lens) - 1);
+    id.maker_index = maker;
+    id.colors = 3;
+    id.filters = 0x94949494;
+    ml.LensID = LIBRAW_LENS_NOT_SET;
+    GetNormalizedModel();
+    snprintf(line, sizeof(line), "%s|%s|%s|%s|%d,%d,%d,%d,%d,%llx,%d,%d,%x,%d",
+             strcmp(id.normalized_make, mk) ? id.normalized_make : "=",
+             strcmp(id.normalized_model, md) ? id.normalized_model : "=",
+             strcmp(id.make, mk) ? id.make : "=",
+             strcmp(id.model, md) ? id.model : "=", ml.CameraMount,
+             ml.CameraFormat, ml.LensMount, ml.LensFormat, ml.FocalType,
+             ml.CamID, int(ml.LensID), id.colors, id.filters,
+             imgdata.makernotes.sony.CameraType);
+    std::string out(line);
+    if (ml.body[0])
+      out += std::string("|body=") + ml.body;
+    if (strcmp(imgdata.lens.Lens, lens))
+      out += std::string("|lens=") + imgdata.lens.Lens;
+    return out;
+  }
+};
+
+struct norm_input_t
+{
+  unsigned maker;
+  std::string make, model, lens;
+};
+
+/* model as is and in lower case */
+static void add_input(std::vector<norm_input_t> &in, std::set<std::string> &seen,
+                      unsigned maker, const char *make, const std::string &model,
+                      const char *lens = "")
+{
+  std::string lower(model);
+  for (size_t c = 0; c < model.size(); c++)
+    lower[c] = tolower((unsigned char)lower[c]);
+  const std::string *v[2] = {&model, &lower};
+  for (int i = 0; i < 2; i++)
+  {
+    std::string key = std::string(make) + "|" + *v[i] + "|" + lens;
+    if (!seen.insert(key).second)
+      continue;
+    norm_input_t n = {maker, make, *v[i], lens};
+    in.push_back(n);
+  }
+}
+
+template <size_t N, size_t L>
+static void add_inputs(std::vector<norm_input_t> &in, std::set<std::string> &seen,
+                       const char (&table)[N][L], const unsigned *makers,
+                       int nmakers)
+{
+  for (int m = 0; m < nmakers; m++)
+    for (size_t i = 0; i < N; i++)
+      add_input(in, seen, makers[m], LibRaw::cameramakeridx2maker(makers[m]),
+                table[i][0] == '@' ? table[i] + 1 : table[i]);
+}
+
+/* camera list entries split into maker (longest maker name prefix) and
+   model, alias table entries with makers GetNormalizedModel() uses them for */
+static void normalize_inputs(std::vector<norm_input_t> &in)
+{
+  std::set<std::string> seen;
+  const char **clist = LibRaw::cameraList();
+  for (int i = 0; clist[i]; i++)
+  {
+    unsigned maker = LIBRAW_CAMERAMAKER_Unknown;
+    size_t len = 0;
+    for (unsigned m = 0; m < LIBRAW_CAMERAMAKER_TheLastOne; m++)
+    {
+      const char *name = LibRaw::cameramakeridx2maker(m);
+      size_t l = name ? strlen(name) : 0;
+      if (l > len && !strncmp(clist[i], name, l) && clist[i][l] == ' ')
+      {
+        maker = m;
+        len = l;
+      }
+    }
+    if (len)
+      add_input(in, seen, maker, LibRaw::cameramakeridx2maker(maker),
+                clist[i] + len + 1);
+    else
+      add_input(in, seen, LIBRAW_CAMERAMAKER_Unknown, "", clist[i]);
+  }
+  static const unsigned fuji[] = {LIBRAW_CAMERAMAKER_Fujifilm},
+                        kodak[] = {LIBRAW_CAMERAMAKER_Kodak},
+                        leaf[] = {LIBRAW_CAMERAMAKER_Leaf,
+                                  LIBRAW_CAMERAMAKER_Mamiya},
+                        km[] = {LIBRAW_CAMERAMAKER_Minolta,
+                                LIBRAW_CAMERAMAKER_Konica},
+                        nikon[] = {LIBRAW_CAMERAMAKER_Nikon},
+                        oly[] = {LIBRAW_CAMERAMAKER_Olympus},
+                        pan[] = {LIBRAW_CAMERAMAKER_Panasonic,
+                                 LIBRAW_CAMERAMAKER_Leica,
+                                 LIBRAW_CAMERAMAKER_Yuneec},
+                        p1[] = {LIBRAW_CAMERAMAKER_PhaseOne,
+                                LIBRAW_CAMERAMAKER_Mamiya},
+                        pentax[] = {LIBRAW_CAMERAMAKER_Pentax},
+                        samsung[] = {LIBRAW_CAMERAMAKER_Samsung};
+  add_inputs(in, seen, fujialias, fuji, 1);
+  add_inputs(in, seen, kodakalias, kodak, 1);
+  add_inputs(in, seen, leafalias, leaf, 2);
+  add_inputs(in, seen, KonicaMinolta_aliases, km, 2);
+  add_inputs(in, seen, nikonalias, nikon, 1);
+  add_inputs(in, seen, olyalias, oly, 1);
+  add_inputs(in, seen, panalias, pan, 3);
+  add_inputs(in, seen, phase1alias, p1, 2);
+  add_inputs(in, seen, SamsungPentax_aliases, pentax, 1);
+  add_inputs(in, seen, samsungalias, samsung, 1);
+
+  /* Ricoh GXR modules are recognized by lens name */
+  static const char *gxr_lenses[] = {
+      "GR LENS A12 50mm F2.5 MACRO", "RICOH LENS S10 24-72mm F2.5-4.4 VC",
+      "RICOH LENS P10 28-300mm F3.5-5.6 VC", "GR LENS A12 28mm F2.5",
+      "RICOH LENS A16 24-85mm F3.5-5.5", "RICOH MOUNT A12"};
+  for (int i = 0; i < int(sizeof(gxr_lenses) / sizeof(gxr_lenses[0])); i++)
+    add_input(in, seen, LIBRAW_CAMERAMAKER_Ricoh, "Ricoh", "GXR",
+              gxr_lenses[i]);
+
+  /* models no longer in the camera list, and names reported by some
+     firmware/converters, to cover the per-maker rules */
+  static const struct
+  {
+    unsigned maker;
+    const char *make, *model;
+  } extra[] = {
+      {LIBRAW_CAMERAMAKER_Sigma, "Sigma", "SD9"},
+      {LIBRAW_CAMERAMAKER_Sigma, "Sigma", "SD14"},
+      {LIBRAW_CAMERAMAKER_Sigma, "Sigma", "SD1"},
+      {LIBRAW_CAMERAMAKER_Sigma, "Sigma", "SD1 Merrill"},
+      {LIBRAW_CAMERAMAKER_Sigma, "Sigma", "sd Quattro"},
+      {LIBRAW_CAMERAMAKER_Sigma, "Sigma", "sd Quattro H"},
+      {LIBRAW_CAMERAMAKER_Sigma, "Sigma", "SDQ Quattro"},
+      {LIBRAW_CAMERAMAKER_Sigma, "Sigma", "DP1"},
+      {LIBRAW_CAMERAMAKER_Sigma, "Sigma", "DP2 Merrill"},
+      {LIBRAW_CAMERAMAKER_Sigma, "Sigma", "dp0 Quattro"},
+      {LIBRAW_CAMERAMAKER_Sigma, "Sigma", "fp L"},
+      {LIBRAW_CAMERAMAKER_Fujifilm, "Fujifilm", "X-S1"},
+      {LIBRAW_CAMERAMAKER_Fujifilm, "Fujifilm", "X-S10"},
+      {LIBRAW_CAMERAMAKER_Fujifilm, "Fujifilm", "S2Pro"},
+      {LIBRAW_CAMERAMAKER_Fujifilm, "Fujifilm", "IS Pro"},
+      {LIBRAW_CAMERAMAKER_Fujifilm, "Fujifilm", "DBP for GX680"},
+      {LIBRAW_CAMERAMAKER_Fujifilm, "Fujifilm", "GFX 50S"},
+      {LIBRAW_CAMERAMAKER_Panasonic, "Panasonic", "DMC-L10"},
+      {LIBRAW_CAMERAMAKER_Panasonic, "Panasonic", "DC-S1"},
+      {LIBRAW_CAMERAMAKER_Panasonic, "Panasonic", "DC-G9"},
+      {LIBRAW_CAMERAMAKER_Panasonic, "Panasonic", "DMC-GX8"},
+      {LIBRAW_CAMERAMAKER_Panasonic, "Panasonic", "DC-LX100M2"},
+      {LIBRAW_CAMERAMAKER_Panasonic, "Panasonic", "DMC-LX100"},
+      {LIBRAW_CAMERAMAKER_Panasonic, "Panasonic", "DMC-CM1"},
+      {LIBRAW_CAMERAMAKER_Panasonic, "Panasonic", "G"},
+      {LIBRAW_CAMERAMAKER_Samsung, "Samsung", "WB5000/HZ25W"},
+      {LIBRAW_CAMERAMAKER_Samsung, "Samsung", "WB510 / VLUU WB500 / SAMSUNG HZ10W"},
+      {LIBRAW_CAMERAMAKER_Samsung, "Samsung", "SAMSUNG HZ50W"},
+      {LIBRAW_CAMERAMAKER_Samsung, "Samsung", "WB560 / VLUU WB550"},
+      {LIBRAW_CAMERAMAKER_Samsung, "Samsung", "NXF1"},
+      {LIBRAW_CAMERAMAKER_Kodak, "Kodak", "40"},
+      {LIBRAW_CAMERAMAKER_Kodak, "Kodak", "DC25"},
+      {LIBRAW_CAMERAMAKER_Kodak, "Kodak", "DC50 ZOOM"},
+      {LIBRAW_CAMERAMAKER_Kodak, "Kodak", "DC120 ZOOM"},
+      {LIBRAW_CAMERAMAKER_Kodak, "Kodak", "DCS465"},
+      {LIBRAW_CAMERAMAKER_Kodak, "Kodak", "DCS460M"},
+      {LIBRAW_CAMERAMAKER_Kodak, "Kodak", "NC2000 F"},
+      {LIBRAW_CAMERAMAKER_Kodak, "Kodak", "DCS Pro SLR/c"},
+      {LIBRAW_CAMERAMAKER_Kodak, "Kodak", "PIXPRO S-1"},
+      {LIBRAW_CAMERAMAKER_Kodak, "Kodak", "PIXPRO AZ901"},
+      {LIBRAW_CAMERAMAKER_Canon, "Canon", "EOS D2000C"},
+      {LIBRAW_CAMERAMAKER_Canon, "Canon", "EOS D6000C"},
+      {LIBRAW_CAMERAMAKER_Canon, "Canon", "EOSDCS1"},
+      {LIBRAW_CAMERAMAKER_PhotoControl, "PhotoControl", "Camerz ZDS 14"},
+      {LIBRAW_CAMERAMAKER_Konica, "Konica", "KD-400Z"},
+      {LIBRAW_CAMERAMAKER_Konica, "Konica", "DiMAGE A2"},
+      {LIBRAW_CAMERAMAKER_Minolta, "Minolta", "DG-5D"},
+      {LIBRAW_CAMERAMAKER_Minolta, "Minolta", "DG-7D"},
+      {LIBRAW_CAMERAMAKER_Minolta, "Minolta", "DiMAGE 7"},
+      {LIBRAW_CAMERAMAKER_Olympus, "Olympus", "C-740UZ"},
+      {LIBRAW_CAMERAMAKER_Olympus, "Olympus", "C-770UZ"},
+      {LIBRAW_CAMERAMAKER_Pentax, "Pentax", "Optio S"},
+      {LIBRAW_CAMERAMAKER_Pentax, "Pentax", "Optio S V1.01"},
+      {LIBRAW_CAMERAMAKER_Pentax, "Pentax", "Optio S4"},
+      {LIBRAW_CAMERAMAKER_Pentax, "Pentax", "Optio 750Z"},
+      {LIBRAW_CAMERAMAKER_Pentax, "Pentax", "Optio 33WR"},
+      {LIBRAW_CAMERAMAKER_Pentax, "Pentax", "GR III"},
+      {LIBRAW_CAMERAMAKER_Sony, "Sony", "DSC-V3"},
+      {LIBRAW_CAMERAMAKER_Sony, "Sony", "DSC-F828"},
+      {LIBRAW_CAMERAMAKER_Sony, "Sony", "XCD-SX910CR"},
+      {LIBRAW_CAMERAMAKER_Mamiya, "Mamiya", "ZD"},
+      {LIBRAW_CAMERAMAKER_Epson, "Epson", "R-D1s"},
+      {LIBRAW_CAMERAMAKER_Polaroid, "Polaroid", "x530"},
+      {LIBRAW_CAMERAMAKER_Rollei, "Rollei", "d530flex"},
+      {LIBRAW_CAMERAMAKER_Nikon, "Nikon", "E5700"},
+  };
+  for (int i = 0; i < int(sizeof(extra) / sizeof(extra[0])); i++)
+    add_input(in, seen, extra[i].maker, extra[i].make, extra[i].model);
+}
+
+/* returns number of mismatches, -1 if reference file cannot be used */
+static int check_normalize(const char *ref, int write, int verbose)
+{
+  std::vector<norm_input_t> in;
+  normalize_inputs(in);
+  std::map<std::string, std::string> expected;
+  FILE *f = fopen(ref, write ? "wb" : "rb");
+  if (!f)
+  {
+    perror(ref);
+    return -1;
+  }
+  if (!write)
+  {
+    char line[2048];
+    while (fgets(line, sizeof(line), f))
+    {
+      char *tab = strchr(line, '\t'), *nl = strchr(line, '\n');
+      if (!tab || !nl)
+        continue;
+      *tab = *nl = 0;
+      expected[line] = tab + 1;
+    }
+  }
+  int mismatches = 0;
+  for (size_t i = 0; i < in.size(); i++)
+  {
+    char key[256];
+    normalize_check_t *lr = new normalize_check_t;
+    std::string out = lr->normalize(in[i].maker, in[i].make.c_str(),
+                                     in[i].model.c_str(), in[i].lens.c_str());
+    delete lr;
+    snprintf(key, sizeof(key), "%s|%s%s%s", in[i].make.c_str(),
+             in[i].model.c_str(), in[i].lens.size() ? "|" : "",
+             in[i].lens.c_str());
+    if (write)
+    {
+      fprintf(f, "%s\t%s\n", key, out.c_str());
+      continue;
+    }
+    std::map<std::string, std::string>::const_iterator e = expected.find(key);
+    if (e == expected.end() || e->second != out)
+    {
+      mismatches++;
+      printf("GetNormalizedModel %s: '%s', reference '%s'\n", key,
+             out.c_str(), e == expected.end() ? "(none)" : e->second.c_str());
+    }
+    else if (verbose > 1)
+      printf("%s: %s\n", key, out.c_str());
+  }
+  fclose(f);
+  printf("model_index_check: GetNormalizedModel() for %d inputs%s, %d mismatches\n",
+         int(in.size()), write ? " written" : "", mismatches);
+  return mismatches;
+}
+
+int main(int ac, char *av[])
+{
+  std::vector<std::string> names;
+  int verbose = 0, write = 0;
+  const char *ref = NULL;
+  for (int i = 1; i < ac; i++)
+    if (!strcmp(av[i], "-v"))
+      verbose++;
+    else if (!strcmp(av[i], "-w"))
+      write = 1;
+    else
+      ref = av[i];
+  if (write)
+  {
+    if (!ref)
+    {
+      printf("Usage: %s [-v] [-w] [reference-file]\n", av[0]);
+      return 2;
+    }
+    return check_normalize(ref, 1, verbose) ? 2 : 0;
+  }
+
+  /* every supported camera: full name and model without maker */
+  const char **clist = LibRaw::cameraList();
+  for (int i = 0; clist[i]; i++)
+  {
+    names.push_back(clist[i]);
+    const char *sp = strchr(clist[i], ' ');
+    if (sp)
+      names.push_back(sp + 1);
+  }
+  add_names(names, fujialias);
+  add_names(names, kodakalias);
+  add_names(names, leafalias);
+  add_names(names, KonicaMinolta_aliases);
+  add_names(names, nikonalias);
+  add_names(names, olyalias);
+  add_names(names, panalias);
+  add_names(names, phase1alias);
+  add_names(names, SamsungPentax_aliases);
+  add_names(names, samsungalias);
+  for (size_t i = 0, n = names.size(); i < n; i++)
+  {
+    std::string lower(names[i]), upper(names[i]);
+    for (size_t c = 0; c < lower.size(); c++)
+    {
+      lower[c] = tolower((unsigned char)lower[c]);
+      upper[c] = toupper((unsigned char)upper[c]);
+    }
+    names.push_back(lower);
+    names.push_back(upper);
+    names.push_back(names[i] + " ");
+    if (names[i].size())
+      names.push_back(names[i].substr(0, names[i].size() - 1));
+  }
+  names.push_back("");
+  if (verbose)
+    printf("%d names, %d cameras\n", int(names.size()), LibRaw::cameraCount());
+
+  check_aliases("fujialias", fujialias, names);
+  check_aliases("kodakalias", kodakalias, names);
+  check_aliases("leafalias", leafalias, names);
+  check_aliases("KonicaMinolta_aliases", KonicaMinolta_aliases, names);
+  check_aliases("nikonalias", nikonalias, names);
+  check_aliases("olyalias", olyalias, names);
+  check_aliases("panalias", panalias, names);
+  check_aliases("phase1alias", phase1alias, names);
+  check_aliases("SamsungPentax_aliases", SamsungPentax_aliases, names);
+  check_aliases("samsungalias", samsungalias, names);
+  check_ids("unique", unique);
+  check_ids("sonique", sonique);
+
+  printf("model_index_check: %d lookups, %d mismatches\n", checks, errors);
+
+  /* default reference is optional: run from source tree root */
+  FILE *f = ref ? NULL : fopen(DEFAULT_REFERENCE, "rb");
+  if (f)
+  {
+    fclose(f);
+    ref = DEFAULT_REFERENCE;
+  }
+  if (!ref)
+    printf("model_index_check: no %s, GetNormalizedModel() not checked\n",
+           DEFAULT_REFERENCE);
+  else if (check_normalize(ref, 0, verbose))
+    errors++;
+  return errors ? 1 : 0;
+}
@@ -91,6 +91,9 @@ int main(int ac, char *av[])
       fprintf(stderr, "Cannot unpack %s: %s\n", av[i], libraw_strerror(ret));
       continue;
     }
+    // cache interpolated image: renderings with same half_size differ only
+    // in WB and flip, so interpolation is not repeated
+    RawProcessor.begin_render_session();
     process_once(RawProcessor, 0, 0, 0, 1, -1, av[i]); // default flip
     process_once(RawProcessor, 1, 0, 1, 2, -1, av[i]);
     process_once(RawProcessor, 1, 1, 0, 3, -1, av[i]); // default flip
@@ -1941,6 +1941,8 @@ int LibRaw::crxDecodePlane(void *p, uint32_t planeNumber)
           return -1;
         for (int i = 0; i < tile->height; ++i)
         {
+          if (cancelRequested())
+            return -1;
           if (crxIdwt53FilterDecode(planeComp, img->levels - 1, tile->qStep) ||
               crxIdwt53FilterTransform(planeComp, img->levels - 1))
             return -1;
@@ -1959,6 +1961,8 @@ int LibRaw::crxDecodePlane(void *p, uint32_t planeNumber)
 
         for (int i = 0; i < tile->height; ++i)
         {
+          if (cancelRequested())
+            return -1;
           if (crxDecodeLine(planeComp->subBands->bandParam, planeComp->subBands->bandBuf))
             return -1;
           int32_t *lineData = (int32_t *)planeComp->subBands->bandBuf;
@@ -2692,33 +2696,63 @@ int crxFreeImageData(CrxImage *img)
 #endif
   return 0;
 }
-void LibRaw::crxLoadDecodeLoop(void *img, int nPlanes)
+struct crx_task_t
 {
-#ifdef LIBRAW_USE_OPENMP
+  LibRaw *self;
+  void *img;
   int results[4]; // nPlanes is always <= 4
-#pragma omp parallel for
-  for (int32_t plane = 0; plane < nPlanes; ++plane)
-    results[plane] = crxDecodePlane(img, plane);
+  LibRaw_exceptions exception;
+};
 
+void LibRaw::crxDecodePlaneTask(void *t, int plane)
+{
+  crx_task_t *task = (crx_task_t *)t;
+  try
+  {
+    task->results[plane] = task->self->crxDecodePlane(task->img, plane);
+  }
+  catch (const LibRaw_exceptions &e)
+  {
+    task->results[plane] = -1;
+    task->exception = e;
+  }
+  catch (...)
+  {
+    task->results[plane] = -1;
+    task->exception = LIBRAW_EXCEPTION_ALLOC;
+  }
+}
+
+void LibRaw::crxLoadDecodeLoop(void *img, int nPlanes)
+{
+  crx_task_t task;
+  task.self = this;
+  task.img = img;
+  task.exception = LIBRAW_EXCEPTION_NONE;
+  run_parallel(nPlanes, raw_threads(), crxDecodePlaneTask, &task);
+
+  checkCancel();
+  if (task.exception != LIBRAW_EXCEPTION_NONE)
+    throw task.exception;
   for (int32_t plane = 0; plane < nPlanes; ++plane)
-    if (results[plane])
-      derror();
-#else
-  for (int32_t plane = 0; plane < nPlanes; ++plane)
-    if (crxDecodePlane(img, plane))
+    if (task.results[plane])
       derror();
-#endif
 }
 
 void LibRaw::crxConvertPlaneLineDf(void *p, int imageRow) { crxConvertPlaneLine((CrxImage *)p, imageRow); }
 
+void LibRaw::crxConvertPlaneLineTask(void *t, int imageRow)
+{
+  crx_task_t *task = (crx_task_t *)t;
+  task->self->crxConvertPlaneLineDf(task->img, imageRow);
+}
+
 void LibRaw::crxLoadFinalizeLoopE3(void *p, int planeHeight)
 {
-#ifdef LIBRAW_USE_OPENMP
-#pragma omp parallel for
-#endif
-  for (int i = 0; i < planeHeight; ++i)
-    crxConvertPlaneLineDf(p, i);
+  crx_task_t task;
+  task.self = this;
+  task.img = p;
+  run_parallel(planeHeight, raw_threads(), crxConvertPlaneLineTask, &task);
 }
 
 void LibRaw::crxLoadRaw()
@@ -846,15 +846,127 @@ void LibRaw::nikon_read_curve()
     }
     for (i = 0; i < csize; i++)
       curve[i * step] = get2();
-    for (i = 0; i < max; i++)
-      curve[i] = (curve[i - i % step] * (step - i % step) +
-                  curve[i - i % step + step] * (i % step)) /
-                 step;
+    /* linear interpolation between knots, one segment at a time */
+    for (i = 0; i < max; i += step)
+    {
+      int lo = curve[i], hi = curve[i + step];
+      for (int j = 0; j < step && i + j < max; j++)
+        curve[i + j] = (lo * (step - j) + hi * j) / step;
+    }
   }
   else if (ver0 != 0x46 && csize <= 0x4001)
     read_shorts(curve, max = csize);
 }
 
+/*
+  Bit reader for nikon_load_raw(): same results as getbithuff(), but the
+  stream is read in blocks and up to 64 bits are kept in a local buffer.
+ */
+struct nikon_bitreader
+{
+  LibRaw_abstract_datastream *input;
+  std::vector<uchar> buf;
+  int pos, len, reset, zero_ff, vbits, errors;
+  UINT64 bitbuf;
+
+  nikon_bitreader(LibRaw_abstract_datastream *in, int zaf)
+      : input(in), buf(0x10000), pos(0), len(0), reset(0), zero_ff(zaf),
+        vbits(0), errors(0), bitbuf(0)
+  {
+  }
+  int next_byte()
+  {
+    if (pos >= len)
+    {
+      pos = 0;
+      len = input->read(&buf[0], 1, (int)buf.size());
+      if (len <= 0)
+      {
+        len = 0;
+        return -1;
+      }
+    }
+    return buf[pos++];
+  }
+  void refill()
+  {
+    int c;
+    while (vbits <= 56 && !reset && (c = next_byte()) >= 0 &&
+           !(reset = zero_ff && c == 0xff && next_byte()))
+    {
+      bitbuf = (bitbuf << 8) | (uchar)c;
+      vbits += 8;
+    }
+  }
+  unsigned peek(int nbits) const
+  {
+    if (vbits <= 0)
+      return 0;
+    if (vbits >= nbits)
+      return unsigned(bitbuf >> (vbits - nbits)) & ((1u << nbits) - 1);
+    return unsigned(bitbuf << (nbits - vbits)) & ((1u << nbits) - 1);
+  }
+  void skip(int nbits)
+  {
+    if ((vbits -= nbits) < 0)
+      errors++;
+  }
+  unsigned read_bits(int nbits)
+  {
+    if (nbits > 25 || nbits == 0 || vbits < 0)
+      return 0;
+    if (vbits < nbits)
+      refill();
+    unsigned c = peek(nbits);
+    skip(nbits);
+    return c;
+  }
+  unsigned read_huff(const ushort *huff)
+  {
+    if (vbits < 0)
+      return 0;
+    if (vbits < huff[0])
+      refill();
+    unsigned c = huff[1 + peek(huff[0])];
+    skip(c >> 8);
+    return (uchar)c;
+  }
+};
+
+#define LIBRAW_NIKON_LUT_BITS 14
+
+static int nikon_diff(int len, int shl, unsigned bits)
+{
+  int diff = ((bits << 1) + 1) << shl >> 1;
+  if (len > 0 && (diff & (1 << (len - 1))) == 0)
+    diff -= (1 << len) - !shl;
+  return diff;
+}
+
+/*
+  Combined table: for every LIBRAW_NIKON_LUT_BITS-bit prefix that holds both
+  a Huffman code and its difference bits, keeps the decoded difference
+  (upper bits) and the number of bits consumed (low byte). Zero means that
+  the prefix is too short and the code is decoded bit by bit.
+ */
+static void nikon_build_lut(const ushort *huff, int *lut)
+{
+  const int maxlen = huff[0];
+  for (unsigned p = 0; p < (1u << LIBRAW_NIKON_LUT_BITS); p++)
+  {
+    lut[p] = 0;
+    if (maxlen > LIBRAW_NIKON_LUT_BITS)
+      continue;
+    ushort h = huff[1 + (p >> (LIBRAW_NIKON_LUT_BITS - maxlen))];
+    int codelen = h >> 8, len = h & 15, shl = (h & 0xff) >> 4;
+    int nbits = len - shl;
+    if (!codelen || nbits < 0 || codelen + nbits > LIBRAW_NIKON_LUT_BITS)
+      continue;
+    unsigned bits = (p >> (LIBRAW_NIKON_LUT_BITS - codelen - nbits)) & ((1u << nbits) - 1);
+    lut[p] = nikon_diff(len, shl, bits) * 256 + codelen + nbits;
+  }
+}
+
 void LibRaw::nikon_load_raw()
 {
   static const uchar nikon_tree[][32] = {
@@ -875,6 +987,7 @@ void LibRaw::nikon_load_raw()
        7, 6, 8, 5, 9, 4, 10, 3, 11, 12, 2, 0, 1, 13, 14}};
   ushort *huff, ver0, ver1, vpred[2][2], hpred[2];
   int i, min, max, tree = 0, split = 0, row, col, len, shl, diff;
+  int *lut;
 
   fseek(ifp, meta_offset, SEEK_SET);
   ver0 = fgetc(ifp);
@@ -898,8 +1011,17 @@ void LibRaw::nikon_load_raw()
   while (max > 2 && (curve[max - 2] == curve[max - 1]))
     max--;
   huff = make_decoder(nikon_tree[tree]);
+  lut = (int *)malloc(sizeof(int) << LIBRAW_NIKON_LUT_BITS);
+  if (!lut)
+    free(huff);
+  merror(lut, "nikon_load_raw()");
+  nikon_build_lut(huff, lut);
   fseek(ifp, data_offset, SEEK_SET);
-  getbits(-1);
+  /*
+     Vertical predictors chain every row to the previous one and the stream
+     has no restart markers, so the frame is decoded by a single thread.
+   */
+  nikon_bitreader bits(ifp, zero_after_ff);
   try
   {
     for (min = row = 0; row < height; row++)
@@ -909,31 +1031,48 @@ void LibRaw::nikon_load_raw()
       {
         free(huff);
         huff = make_decoder(nikon_tree[tree + 1]);
+        nikon_build_lut(huff, lut);
         max += (min = 16) << 1;
       }
+      ushort *dest = raw_image + (INT64)row * raw_width;
       for (col = 0; col < raw_width; col++)
       {
-        i = gethuff(huff);
-        len = i & 15;
-        shl = i >> 4;
-        diff = ((getbits(len - shl) << 1) + 1) << shl >> 1;
-        if (len > 0 && (diff & (1 << (len - 1))) == 0)
-          diff -= (1 << len) - !shl;
+        bits.refill();
+        int e = lut[bits.peek(LIBRAW_NIKON_LUT_BITS)];
+        if ((e & 0xff) && bits.vbits >= (e & 0xff))
+        {
+          bits.vbits -= e & 0xff;
+          diff = e >> 8;
+        }
+        else
+        {
+          i = bits.read_huff(huff);
+          len = i & 15;
+          shl = i >> 4;
+          diff = nikon_diff(len, shl, bits.read_bits(len - shl));
+        }
         if (col < 2)
           hpred[col] = vpred[row & 1][col] += diff;
         else
           hpred[col & 1] += diff;
+        if (bits.errors)
+        {
+          bits.errors = 0;
+          derror();
+        }
         if ((ushort)(hpred[col & 1] + min) >= max)
           derror();
-        RAW(row, col) = curve[LIM((short)hpred[col & 1], 0, 0x3fff)];
+        dest[col] = curve[LIM((short)hpred[col & 1], 0, 0x3fff)];
       }
     }
   }
   catch (...)
   {
+    free(lut);
     free(huff);
     throw;
   }
+  free(lut);
   free(huff);
 }
 
@@ -1113,15 +1252,177 @@ unsigned LibRaw::pana_data(int nb, unsigned *bytes)
 #endif
 }
 
+#define LIBRAW_PANA_PAGE 0x4000
+#define LIBRAW_PANA_BAND_PAGES 64
+
+/* same bit addressing as pana_data(), but over a caller-owned page */
+static inline unsigned pana_page_bits(const uchar *page, int &vpos, int nb)
+{
+  vpos = (vpos - nb) & 0x1ffff;
+  int byte = vpos >> 3 ^ 0x3ff0;
+  return (page[byte] | page[byte + 1] << 8) >> (vpos & 7) & ~((~0u) << nb);
+}
+
+/*
+  Decodes one page of classic (pre-v5) data: 1024 packets, each packet holds
+  14 pixels of one row in 128 bits. Returns -1 if a packet is not 128 bits
+  long (page-parallel decoding is not possible then), otherwise the number
+  of out-of-range pixels inside the visible area.
+ */
+static int pana_decode_page_classic(const uchar *page, ushort *dest, INT64 first, INT64 npix,
+                                    int rwidth, int vwidth, int vheight)
+{
+  int vpos = 0, errors = 0;
+  for (INT64 k = 0; k < npix; k += 14)
+  {
+    int pred[2] = {0, 0}, nonz[2] = {0, 0}, sh = 0, i, j;
+    ushort *out = dest + first + k;
+    for (i = 0; i < 14; i++)
+    {
+      if (i % 3 == 2)
+        sh = 4 >> (3 - pana_page_bits(page, vpos, 2));
+      if (nonz[i & 1])
+      {
+        if ((j = pana_page_bits(page, vpos, 8)))
+        {
+          if ((pred[i & 1] -= 0x80 << sh) < 0 || sh == 4)
+            pred[i & 1] &= ~((~0u) << sh);
+          pred[i & 1] += j << sh;
+        }
+      }
+      else if ((nonz[i & 1] = pana_page_bits(page, vpos, 8)) || i > 11)
+        pred[i & 1] = nonz[i & 1] << 4 | pana_page_bits(page, vpos, 4);
+      out[i] = pred[i & 1];
+    }
+    if (vpos != (int)((0x20000 - (k / 14 + 1) * 128) & 0x1ffff))
+      return -1;
+    int row = int((first + k) / rwidth), col = int((first + k) % rwidth);
+    if (row < vheight)
+      for (i = 0; i < 14; i++)
+        if (out[i] > 4098 && col + i < vwidth)
+          errors++;
+  }
+  return errors;
+}
+
+/* v5 data: 1024 fixed-size 16-byte blocks per page */
+static void pana_decode_page_v5(const uchar *page, ushort *dest, INT64 first, INT64 npix, int bpp)
+{
+  const int enc_blck_size = bpp == 12 ? 10 : 9;
+  for (INT64 k = 0; k < npix; k += enc_blck_size, page += 16)
+  {
+    const uchar *bytes = page;
+    ushort *raw_block_data = dest + first + k;
+    if (bpp == 12)
+    {
+      raw_block_data[0] = ((bytes[1] & 0xF) << 8) + bytes[0];
+      raw_block_data[1] = 16 * bytes[2] + (bytes[1] >> 4);
+      raw_block_data[2] = ((bytes[4] & 0xF) << 8) + bytes[3];
+      raw_block_data[3] = 16 * bytes[5] + (bytes[4] >> 4);
+      raw_block_data[4] = ((bytes[7] & 0xF) << 8) + bytes[6];
+      raw_block_data[5] = 16 * bytes[8] + (bytes[7] >> 4);
+      raw_block_data[6] = ((bytes[10] & 0xF) << 8) + bytes[9];
+      raw_block_data[7] = 16 * bytes[11] + (bytes[10] >> 4);
+      raw_block_data[8] = ((bytes[13] & 0xF) << 8) + bytes[12];
+      raw_block_data[9] = 16 * bytes[14] + (bytes[13] >> 4);
+    }
+    else if (bpp == 14)
+    {
+      raw_block_data[0] = bytes[0] + ((bytes[1] & 0x3F) << 8);
+      raw_block_data[1] = (bytes[1] >> 6) + 4 * (bytes[2]) + ((bytes[3] & 0xF) << 10);
+      raw_block_data[2] = (bytes[3] >> 4) + 16 * (bytes[4]) + ((bytes[5] & 3) << 12);
+      raw_block_data[3] = ((bytes[5] & 0xFC) >> 2) + (bytes[6] << 6);
+      raw_block_data[4] = bytes[7] + ((bytes[8] & 0x3F) << 8);
+      raw_block_data[5] = (bytes[8] >> 6) + 4 * bytes[9] + ((bytes[10] & 0xF) << 10);
+      raw_block_data[6] = (bytes[10] >> 4) + 16 * bytes[11] + ((bytes[12] & 3) << 12);
+      raw_block_data[7] = ((bytes[12] & 0xFC) >> 2) + (bytes[13] << 6);
+      raw_block_data[8] = bytes[14] + ((bytes[15] & 0x3F) << 8);
+    }
+  }
+}
+
+/*
+  Page-parallel variant of panasonic_load_raw(): 0x4000-byte pages are
+  independent if rows hold a whole number of packets/blocks. Pages are read
+  (and un-rotated by load_flags) sequentially in bands, then decoded in
+  parallel. Returns 0 if the data does not fit that layout.
+ */
+int LibRaw::panasonic_load_raw_paged()
+{
+  const int pixperpage = pana_encoding == 5 ? (pana_bpp == 12 ? 10 : 9) * 1024 : 14 * 1024;
+  const INT64 total = (INT64)raw_height * raw_width;
+  const int pages = int((total + pixperpage - 1) / pixperpage);
+  const int rw = raw_width, vw = width, vh = height, bpp = pana_bpp;
+  const int v5 = pana_encoding == 5;
+  const unsigned lf = load_flags;
+  int irregular = 0, errors = 0;
+
+  uchar *band = (uchar *)calloc(LIBRAW_PANA_BAND_PAGES, LIBRAW_PANA_PAGE + 2);
+  merror(band, "panasonic_load_raw()");
+  try
+  {
+    for (int page = 0; page < pages && !irregular; page += LIBRAW_PANA_BAND_PAGES)
+    {
+      checkCancel();
+      const int npages = MIN(LIBRAW_PANA_BAND_PAGES, pages - page);
+      for (int p = 0; p < npages; p++)
+      {
+        uchar *pg = band + p * (LIBRAW_PANA_PAGE + 2);
+        fread(pg + lf, 1, LIBRAW_PANA_PAGE - lf, ifp);
+        fread(pg, 1, lf, ifp);
+      }
+      ushort *dest = raw_image;
+#ifdef LIBRAW_USE_OPENMP
+#pragma omp parallel for schedule(static) reduction(+ : errors) reduction(max : irregular) num_threads(raw_threads())
+#endif
+      for (int p = 0; p < npages; p++)
+      {
+        const uchar *pg = band + p * (LIBRAW_PANA_PAGE + 2);
+        const INT64 first = (INT64)(page + p) * pixperpage;
+        const INT64 npix = MIN((INT64)pixperpage, total - first);
+        if (v5)
+          pana_decode_page_v5(pg, dest, first, npix, bpp);
+        else
+        {
+          int e = pana_decode_page_classic(pg, dest, first, npix, rw, vw, vh);
+          if (e < 0)
+            irregular = 1;
+          else
+            errors += e;
+        }
+      }
+    }
+  }
+  catch (...)
+  {
+    free(band);
+    throw;
+  }
+  free(band);
+  if (irregular)
+    return 0;
+  while (errors-- > 0)
+    derror();
+  return 1;
+}
+
 void LibRaw::panasonic_load_raw()
 {
   int row, col, i, j, sh = 0, pred[2], nonz[2];
   unsigned bytes[16];
   ushort *raw_block_data;
 
+  int enc_blck_size = pana_bpp == 12 ? 10 : 9;
+  if (load_flags < LIBRAW_PANA_PAGE &&
+      raw_width % (pana_encoding == 5 ? enc_blck_size : 14) == 0)
+  {
+    if (panasonic_load_raw_paged())
+      return;
+    fseek(ifp, data_offset, SEEK_SET);
+  }
+
   pana_data(0, 0);
 
-  int enc_blck_size = pana_bpp == 12 ? 10 : 9;
   if (pana_encoding == 5)
   {
     for (row = 0; row < raw_height; row++)
@@ -1450,111 +1751,167 @@ void LibRaw::sony_arw_load_raw()
   }
 }
 
-void LibRaw::sony_arw2_load_raw()
+#define LIBRAW_ARW2_BAND_ROWS 256
+
+enum sony_arw2_modes
+{
+  ARW2_BASE_AND_DELTA = 0,
+  ARW2_BASE_AND_DELTA_TOVALUE,
+  ARW2_BASE_ONLY,
+  ARW2_DELTA_ONLY,
+  ARW2_DELTA_ZEROBASE
+};
+
+/*
+  Each 16-byte block holds 16 pixels of one color (every second column):
+  11-bit max and min, 4-bit positions of max and min, fourteen 7-bit deltas.
+  Deltas are taken from fixed bit positions, so the expansion loop has no
+  data-dependent control flow and compiles into vector code.
+ */
+template <int mode, int le>
+static void sony_arw2_decode_row(const uchar *data, ushort *dest, int rwidth,
+                                 const ushort *tcurve, unsigned tblack, int thr)
 {
-  uchar *data, *dp;
   ushort pix[16];
-  int row, col, val, max, min, imax, imin, sh, bit, i;
+  ushort delta[15];
+  int col = 0;
 
-  data = (uchar *)malloc(raw_width + 1);
-  merror(data, "sony_arw2_load_raw()");
-  try
+  for (const uchar *dp = data; col < rwidth - 30; dp += 16)
   {
-    for (row = 0; row < height; row++)
+    unsigned val = le ? dp[0] | dp[1] << 8 | dp[2] << 16 | (unsigned)dp[3] << 24
+                      : (unsigned)dp[0] << 24 | dp[1] << 16 | dp[2] << 8 | dp[3];
+    int max = 0x7ff & val;
+    int min = 0x7ff & val >> 11;
+    int imax = 0x0f & val >> 22;
+    int imin = 0x0f & val >> 26;
+    int sh, i, j;
+    for (sh = 0; sh < 4 && 0x80 << sh <= max - min; sh++)
+      ;
+
+    if (mode != ARW2_BASE_ONLY)
     {
-      checkCancel();
-      fread(data, 1, raw_width, ifp);
-      for (dp = data, col = 0; col < raw_width - 30; dp += 16)
+      const int base = mode == ARW2_DELTA_ZEROBASE ? 0 : min;
+      /* 15 slots: the last one is used only if imax == imin (broken block) */
+      for (i = 0; i < 15; i++)
       {
-        max = 0x7ff & (val = sget4(dp));
-        min = 0x7ff & val >> 11;
-        imax = 0x0f & val >> 22;
-        imin = 0x0f & val >> 26;
-        for (sh = 0; sh < 4 && 0x80 << sh <= max - min; sh++)
-          ;
-        /* flag checks if outside of loop */
-        if (!(imgdata.rawparams.specials & LIBRAW_RAWSPECIAL_SONYARW2_ALLFLAGS) // no flag set
-            || (imgdata.rawparams.specials & LIBRAW_RAWSPECIAL_SONYARW2_DELTATOVALUE))
-        {
-          for (bit = 30, i = 0; i < 16; i++)
-            if (i == imax)
-              pix[i] = max;
-            else if (i == imin)
-              pix[i] = min;
-            else
-            {
-              pix[i] =
-                  ((sget2(dp + (bit >> 3)) >> (bit & 7) & 0x7f) << sh) + min;
-              if (pix[i] > 0x7ff)
-                pix[i] = 0x7ff;
-              bit += 7;
-            }
-        }
-        else if (imgdata.rawparams.specials & LIBRAW_RAWSPECIAL_SONYARW2_BASEONLY)
-        {
-          for (bit = 30, i = 0; i < 16; i++)
-            if (i == imax)
-              pix[i] = max;
-            else if (i == imin)
-              pix[i] = min;
-            else
-              pix[i] = 0;
-        }
-        else if (imgdata.rawparams.specials & LIBRAW_RAWSPECIAL_SONYARW2_DELTAONLY)
-        {
-          for (bit = 30, i = 0; i < 16; i++)
-            if (i == imax)
-              pix[i] = 0;
-            else if (i == imin)
-              pix[i] = 0;
-            else
-            {
-              pix[i] =
-                  ((sget2(dp + (bit >> 3)) >> (bit & 7) & 0x7f) << sh) + min;
-              if (pix[i] > 0x7ff)
-                pix[i] = 0x7ff;
-              bit += 7;
-            }
-        }
-        else if (imgdata.rawparams.specials & LIBRAW_RAWSPECIAL_SONYARW2_DELTAZEROBASE)
-        {
-          for (bit = 30, i = 0; i < 16; i++)
-            if (i == imax)
-              pix[i] = 0;
-            else if (i == imin)
-              pix[i] = 0;
-            else
-            {
-              pix[i] = ((sget2(dp + (bit >> 3)) >> (bit & 7) & 0x7f) << sh);
-              if (pix[i] > 0x7ff)
-                pix[i] = 0x7ff;
-              bit += 7;
-            }
-        }
+        const int bit = 30 + i * 7;
+        unsigned w = le ? dp[bit >> 3] | dp[(bit >> 3) + 1] << 8
+                        : dp[bit >> 3] << 8 | dp[(bit >> 3) + 1];
+        unsigned v = ((w >> (bit & 7) & 0x7f) << sh) + base;
+        delta[i] = v > 0x7ff ? 0x7ff : v;
+      }
+    }
+    else
+      memset(delta, 0, sizeof(delta));
+
+    const int zero_base = mode == ARW2_DELTA_ONLY || mode == ARW2_DELTA_ZEROBASE;
+    for (i = j = 0; i < 16; i++)
+      if (i == imax)
+        pix[i] = zero_base ? 0 : max;
+      else if (i == imin)
+        pix[i] = zero_base ? 0 : min;
+      else
+        pix[i] = delta[j++];
 
-        if (imgdata.rawparams.specials & LIBRAW_RAWSPECIAL_SONYARW2_DELTATOVALUE)
-        {
-          for (i = 0; i < 16; i++, col += 2)
-          {
-            unsigned slope =
-                pix[i] < 1001 ? 2
-                              : curve[pix[i] << 1] - curve[(pix[i] << 1) - 2];
-            unsigned step = 1 << sh;
-            RAW(row, col) =
-                curve[pix[i] << 1] >
-                        black + imgdata.rawparams.sony_arw2_posterization_thr
-                    ? LIM(((slope * step * 1000) /
-                           (curve[pix[i] << 1] - black)),
-                          0, 10000)
-                    : 0;
-          }
-        }
-        else
-          for (i = 0; i < 16; i++, col += 2)
-            RAW(row, col) = curve[pix[i] << 1];
-        col -= col & 1 ? 1 : 31;
+    if (mode == ARW2_BASE_AND_DELTA_TOVALUE)
+    {
+      for (i = 0; i < 16; i++, col += 2)
+      {
+        unsigned slope = pix[i] < 1001 ? 2 : tcurve[pix[i] << 1] - tcurve[(pix[i] << 1) - 2];
+        unsigned step = 1 << sh;
+        dest[col] = tcurve[pix[i] << 1] > tblack + thr
+                        ? LIM(((slope * step * 1000) / (tcurve[pix[i] << 1] - tblack)), 0, 10000)
+                        : 0;
       }
     }
+    else
+      for (i = 0; i < 16; i++, col += 2)
+        dest[col] = tcurve[pix[i] << 1];
+    col -= col & 1 ? 1 : 31;
+  }
+}
+
+template <int mode>
+static void sony_arw2_decode_row_order(const uchar *data, ushort *dest, int rwidth,
+                                       const ushort *tcurve, unsigned tblack, int thr, short border)
+{
+  if (border == 0x4949)
+    sony_arw2_decode_row<mode, 1>(data, dest, rwidth, tcurve, tblack, thr);
+  else
+    sony_arw2_decode_row<mode, 0>(data, dest, rwidth, tcurve, tblack, thr);
+}
+
+void LibRaw::sony_arw2_decode_loop(uchar *data, int row_start, int rows)
+{
+  const unsigned specials = imgdata.rawparams.specials;
+  int mode;
+  /* flag checks moved out of the decoding loop */
+  if (specials & LIBRAW_RAWSPECIAL_SONYARW2_DELTATOVALUE)
+    mode = ARW2_BASE_AND_DELTA_TOVALUE;
+  else if (!(specials & LIBRAW_RAWSPECIAL_SONYARW2_ALLFLAGS))
+    mode = ARW2_BASE_AND_DELTA;
+  else if (specials & LIBRAW_RAWSPECIAL_SONYARW2_BASEONLY)
+    mode = ARW2_BASE_ONLY;
+  else if (specials & LIBRAW_RAWSPECIAL_SONYARW2_DELTAONLY)
+    mode = ARW2_DELTA_ONLY;
+  else
+    mode = ARW2_DELTA_ZEROBASE;
+
+  const int rw = raw_width;
+  const unsigned tblack = black;
+  const int thr = imgdata.rawparams.sony_arw2_posterization_thr;
+  const short border = order;
+  const ushort *tcurve = curve;
+  ushort *dest = raw_image + (INT64)row_start * raw_width;
+
+#ifdef LIBRAW_USE_OPENMP
+#pragma omp parallel for schedule(static) num_threads(raw_threads())
+#endif
+  for (int row = 0; row < rows; row++)
+  {
+    const uchar *src = data + (INT64)row * rw;
+    ushort *drow = dest + (INT64)row * rw;
+    switch (mode)
+    {
+    case ARW2_BASE_AND_DELTA:
+      sony_arw2_decode_row_order<ARW2_BASE_AND_DELTA>(src, drow, rw, tcurve, tblack, thr, border);
+      break;
+    case ARW2_BASE_AND_DELTA_TOVALUE:
+      sony_arw2_decode_row_order<ARW2_BASE_AND_DELTA_TOVALUE>(src, drow, rw, tcurve, tblack, thr, border);
+      break;
+    case ARW2_BASE_ONLY:
+      sony_arw2_decode_row_order<ARW2_BASE_ONLY>(src, drow, rw, tcurve, tblack, thr, border);
+      break;
+    case ARW2_DELTA_ONLY:
+      sony_arw2_decode_row_order<ARW2_DELTA_ONLY>(src, drow, rw, tcurve, tblack, thr, border);
+      break;
+    default:
+      sony_arw2_decode_row_order<ARW2_DELTA_ZEROBASE>(src, drow, rw, tcurve, tblack, thr, border);
+      break;
+    }
+  }
+}
+
+void LibRaw::sony_arw2_load_raw()
+{
+  uchar *data;
+  int row, rows;
+  const int band = MIN(LIBRAW_ARW2_BAND_ROWS, (int)height);
+
+  /* rows are fixed-size (raw_width bytes), so a band of rows is read at once
+     and decoded in parallel; 16 extra bytes cover reads past the last block */
+  data = (uchar *)malloc((size_t)raw_width * band + 16);
+  merror(data, "sony_arw2_load_raw()");
+  memset(data + (size_t)raw_width * band, 0, 16);
+  try
+  {
+    for (row = 0; row < height; row += rows)
+    {
+      checkCancel();
+      rows = MIN(band, height - row);
+      fread(data, 1, (size_t)raw_width * rows, ifp);
+      sony_arw2_decode_loop(data, row, rows);
+    }
   }
   catch (...)
   {
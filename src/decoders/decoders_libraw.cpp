@@ -27,6 +27,7 @@ void LibRaw::sony_arq_load_raw()
 
   for (row = 0; row < imgdata.sizes.raw_height; row++)
   {
+    checkCancel();
     unsigned short(*rowp)[4] =
         (unsigned short(*)[4]) &
         imgdata.rawdata.raw_image[row * imgdata.sizes.raw_width * 4];
@@ -124,12 +125,15 @@ void LibRaw::hasselblad_full_load_raw()
   int row, col;
 
   for (row = 0; row < S.height; row++)
+  {
+    checkCancel();
     for (col = 0; col < S.width; col++)
     {
       read_shorts(&imgdata.image[row * S.width + col][2], 1); // B
       read_shorts(&imgdata.image[row * S.width + col][1], 1); // G
       read_shorts(&imgdata.image[row * S.width + col][0], 1); // R
     }
+  }
 }
 
 static inline void unpack7bytesto4x16(unsigned char *src, unsigned short *dest)
@@ -191,16 +195,25 @@ void LibRaw::nikon_14bit_load_raw()
   const unsigned pitch = S.raw_pitch ? S.raw_pitch / 2 : S.raw_width;
   unsigned char *buf = (unsigned char *)malloc(linelen);
   merror(buf, "nikon_14bit_load_raw()");
-  for (int row = 0; row < S.raw_height; row++)
+  try
   {
-    unsigned bytesread =
-        libraw_internal_data.internal_data.input->read(buf, 1, linelen);
-    unsigned short *dest = &imgdata.rawdata.raw_image[pitch * row];
-    // swab32arr((unsigned *)buf, bytesread / 4);
-    for (unsigned int sp = 0, dp = 0;
-         dp < pitch - 3 && sp < linelen - 6 && sp < bytesread - 6;
-         sp += 7, dp += 4)
-      unpack7bytesto4x16_nikon(buf + sp, dest + dp);
+    for (int row = 0; row < S.raw_height; row++)
+    {
+      checkCancel();
+      unsigned bytesread =
+          libraw_internal_data.internal_data.input->read(buf, 1, linelen);
+      unsigned short *dest = &imgdata.rawdata.raw_image[pitch * row];
+      // swab32arr((unsigned *)buf, bytesread / 4);
+      for (unsigned int sp = 0, dp = 0;
+           dp < pitch - 3 && sp < linelen - 6 && sp < bytesread - 6;
+           sp += 7, dp += 4)
+        unpack7bytesto4x16_nikon(buf + sp, dest + dp);
+    }
+  }
+  catch (...)
+  {
+    free(buf);
+    throw;
   }
   free(buf);
 }
@@ -212,24 +225,33 @@ void LibRaw::fuji_14bit_load_raw()
   unsigned char *buf = (unsigned char *)malloc(linelen);
   merror(buf, "fuji_14bit_load_raw()");
 
-  for (int row = 0; row < S.raw_height; row++)
+  try
   {
-    unsigned bytesread =
-        libraw_internal_data.internal_data.input->read(buf, 1, linelen);
-    unsigned short *dest = &imgdata.rawdata.raw_image[pitch * row];
-    if (bytesread % 28)
+    for (int row = 0; row < S.raw_height; row++)
     {
-      swab32arr((unsigned *)buf, bytesread / 4);
-      for (unsigned int sp = 0, dp = 0;
-           dp < pitch - 3 && sp < linelen - 6 && sp < bytesread - 6;
-           sp += 7, dp += 4)
-        unpack7bytesto4x16(buf + sp, dest + dp);
+      checkCancel();
+      unsigned bytesread =
+          libraw_internal_data.internal_data.input->read(buf, 1, linelen);
+      unsigned short *dest = &imgdata.rawdata.raw_image[pitch * row];
+      if (bytesread % 28)
+      {
+        swab32arr((unsigned *)buf, bytesread / 4);
+        for (unsigned int sp = 0, dp = 0;
+             dp < pitch - 3 && sp < linelen - 6 && sp < bytesread - 6;
+             sp += 7, dp += 4)
+          unpack7bytesto4x16(buf + sp, dest + dp);
+      }
+      else
+        for (unsigned int sp = 0, dp = 0;
+             dp < pitch - 15 && sp < linelen - 27 && sp < bytesread - 27;
+             sp += 28, dp += 16)
+          unpack28bytesto16x16ns(buf + sp, dest + dp);
     }
-    else
-      for (unsigned int sp = 0, dp = 0;
-           dp < pitch - 15 && sp < linelen - 27 && sp < bytesread - 27;
-           sp += 28, dp += 16)
-        unpack28bytesto16x16ns(buf + sp, dest + dp);
+  }
+  catch (...)
+  {
+    free(buf);
+    throw;
   }
   free(buf);
 }
@@ -311,23 +333,13 @@ void LibRaw::nikon_load_striped_packed_raw()
   }
 }
 
-struct pana_cs6_page_decoder
-{
-  unsigned int pixelbuffer[14], lastoffset, maxoffset;
-  unsigned char current, *buffer;
-  pana_cs6_page_decoder(unsigned char *_buffer, unsigned int bsize)
-      : lastoffset(0), maxoffset(bsize), current(0), buffer(_buffer)
-  {
-  }
-  void read_page(); // will throw IO error if not enough space in buffer
-  unsigned int nextpixel() { return current < 14 ? pixelbuffer[current++] : 0; }
-};
+#define LIBRAW_PANA_CS_ROWSTEP 16
+#define LIBRAW_PANA_CS_BAND_ROWS (LIBRAW_PANA_CS_ROWSTEP * 16)
 
-void pana_cs6_page_decoder::read_page()
+/* 16-byte page: 14 fields, bytes are stored in reverse order */
+static inline void pana_cs6_unpack_page(const unsigned char *page, unsigned int pixelbuffer[14])
 {
-  if (!buffer || (maxoffset - lastoffset < 16))
-    throw LIBRAW_EXCEPTION_IO_EOF;
-#define wbuffer(i) ((unsigned short)buffer[lastoffset + 15 - i])
+#define wbuffer(i) ((unsigned short)page[15 - i])
   pixelbuffer[0] = (wbuffer(0) << 6) | (wbuffer(1) >> 2); // 14 bit
   pixelbuffer[1] =
       (((wbuffer(1) & 0x3) << 12) | (wbuffer(2) << 4) | (wbuffer(3) >> 4)) &
@@ -345,136 +357,170 @@ void pana_cs6_page_decoder::read_page()
   pixelbuffer[12] = (((wbuffer(13) << 2) & 0x3fc) | wbuffer(14) >> 6) & 0x3ff;
   pixelbuffer[13] = ((wbuffer(14) << 4) | (wbuffer(15) >> 4)) & 0x3ff;
 #undef wbuffer
-  current = 0;
-  lastoffset += 16;
 }
 
+/* one row: blocksperrow pages of 11 pixels; rows do not share state */
+static void pana_cs6_decode_row(const unsigned char *page, unsigned short *rowptr, int blocksperrow)
+{
+  int col = 0;
+  for (int rblock = 0; rblock < blocksperrow; rblock++, page += 16)
+  {
+    unsigned int pixelbuffer[14];
+    pana_cs6_unpack_page(page, pixelbuffer);
+    unsigned oddeven[2] = {0, 0}, nonzero[2] = {0, 0};
+    unsigned pmul = 0, pixel_base = 0;
+    /* bases sit at pixelbuffer[2], [6], [10] - ahead of pixels 2, 5, 8 */
+    for (int pix = 0, current = 0; pix < 11; pix++)
+    {
+      if (pix % 3 == 2)
+      {
+        unsigned base = pixelbuffer[current++]; /* 2-bit field */
+        if (base == 3)
+          base = 4;
+        pixel_base = 0x200 << base;
+        pmul = 1 << base;
+      }
+      unsigned epixel = pixelbuffer[current++];
+      if (oddeven[pix % 2])
+      {
+        epixel *= pmul;
+        if (pixel_base < 0x2000 && nonzero[pix % 2] > pixel_base)
+          epixel += nonzero[pix % 2] - pixel_base;
+        nonzero[pix % 2] = epixel;
+      }
+      else
+      {
+        oddeven[pix % 2] = epixel;
+        if (epixel)
+          nonzero[pix % 2] = epixel;
+        else
+          epixel = nonzero[pix % 2];
+      }
+      unsigned spix = epixel - 0xf;
+      if (spix <= 0xffff)
+        rowptr[col++] = spix & 0xffff;
+      else
+      {
+        epixel = (((signed int)(epixel + 0x7ffffff1)) >> 0x1f);
+        rowptr[col++] = epixel & 0x3fff;
+      }
+    }
+  }
+}
+
+static void pana_cs7_decode_row(const unsigned char *bytes, unsigned short *rowptr, int rwidth, int bpp)
+{
+  const int pixperblock = bpp == 14 ? 9 : 10;
+  for (int col = 0; col < rwidth - pixperblock + 1; col += pixperblock, bytes += 16)
+  {
+    if (bpp == 14)
+    {
+      rowptr[col] = bytes[0] + ((bytes[1] & 0x3F) << 8);
+      rowptr[col + 1] =
+          (bytes[1] >> 6) + 4 * (bytes[2]) + ((bytes[3] & 0xF) << 10);
+      rowptr[col + 2] =
+          (bytes[3] >> 4) + 16 * (bytes[4]) + ((bytes[5] & 3) << 12);
+      rowptr[col + 3] = ((bytes[5] & 0xFC) >> 2) + (bytes[6] << 6);
+      rowptr[col + 4] = bytes[7] + ((bytes[8] & 0x3F) << 8);
+      rowptr[col + 5] =
+          (bytes[8] >> 6) + 4 * bytes[9] + ((bytes[10] & 0xF) << 10);
+      rowptr[col + 6] =
+          (bytes[10] >> 4) + 16 * bytes[11] + ((bytes[12] & 3) << 12);
+      rowptr[col + 7] = ((bytes[12] & 0xFC) >> 2) + (bytes[13] << 6);
+      rowptr[col + 8] = bytes[14] + ((bytes[15] & 0x3F) << 8);
+    }
+    else if (bpp == 12) // have not seen in the wild yet
+    {
+      rowptr[col] = ((bytes[1] & 0xF) << 8) + bytes[0];
+      rowptr[col + 1] = 16 * bytes[2] + (bytes[1] >> 4);
+      rowptr[col + 2] = ((bytes[4] & 0xF) << 8) + bytes[3];
+      rowptr[col + 3] = 16 * bytes[5] + (bytes[4] >> 4);
+      rowptr[col + 4] = ((bytes[7] & 0xF) << 8) + bytes[6];
+      rowptr[col + 5] = 16 * bytes[8] + (bytes[7] >> 4);
+      rowptr[col + 6] = ((bytes[10] & 0xF) << 8) + bytes[9];
+      rowptr[col + 7] = 16 * bytes[11] + (bytes[10] >> 4);
+      rowptr[col + 8] = ((bytes[13] & 0xF) << 8) + bytes[12];
+      rowptr[col + 9] = 16 * bytes[14] + (bytes[13] >> 4);
+    }
+  }
+}
+
+/*
+  C6/C7 rows have fixed size and are read in 16-row pages; several pages
+  are read at once and their rows are decoded in parallel.
+ */
 void LibRaw::panasonicC6_load_raw()
 {
-  const int rowstep = 16;
   const int blocksperrow = imgdata.sizes.raw_width / 11;
   const int rowbytes = blocksperrow * 16;
-  unsigned char *iobuf = (unsigned char *)malloc(rowbytes * rowstep);
+  const int pitch = imgdata.sizes.raw_pitch / 2;
+  const int lastrow = imgdata.sizes.raw_height - LIBRAW_PANA_CS_ROWSTEP + 1;
+  unsigned char *iobuf = (unsigned char *)malloc(rowbytes * LIBRAW_PANA_CS_BAND_ROWS);
   merror(iobuf, "panasonicC6_load_raw()");
 
-  for (int row = 0; row < imgdata.sizes.raw_height - rowstep + 1;
-       row += rowstep)
+  try
   {
-    int rowstoread = MIN(rowstep, imgdata.sizes.raw_height - row);
-    if (libraw_internal_data.internal_data.input->read(
-            iobuf, rowbytes, rowstoread) != rowstoread)
-      throw LIBRAW_EXCEPTION_IO_EOF;
-    pana_cs6_page_decoder page(iobuf, rowbytes * rowstoread);
-    for (int crow = 0, col = 0; crow < rowstoread; crow++, col = 0)
+    for (int row = 0; row < lastrow; row += LIBRAW_PANA_CS_BAND_ROWS)
     {
-      unsigned short *rowptr =
-          &imgdata.rawdata
-               .raw_image[(row + crow) * imgdata.sizes.raw_pitch / 2];
-      for (int rblock = 0; rblock < blocksperrow; rblock++)
-      {
-        page.read_page();
-        unsigned oddeven[2] = {0, 0}, nonzero[2] = {0, 0};
-        unsigned pmul = 0, pixel_base = 0;
-        for (int pix = 0; pix < 11; pix++)
-        {
-          if (pix % 3 == 2)
-          {
-            unsigned base = page.nextpixel();
-            if (base > 3)
-              throw LIBRAW_EXCEPTION_IO_CORRUPT; // not possible b/c of 2-bit
-                                                 // field, but....
-            if (base == 3)
-              base = 4;
-            pixel_base = 0x200 << base;
-            pmul = 1 << base;
-          }
-          unsigned epixel = page.nextpixel();
-          if (oddeven[pix % 2])
-          {
-            epixel *= pmul;
-            if (pixel_base < 0x2000 && nonzero[pix % 2] > pixel_base)
-              epixel += nonzero[pix % 2] - pixel_base;
-            nonzero[pix % 2] = epixel;
-          }
-          else
-          {
-            oddeven[pix % 2] = epixel;
-            if (epixel)
-              nonzero[pix % 2] = epixel;
-            else
-              epixel = nonzero[pix % 2];
-          }
-          unsigned spix = epixel - 0xf;
-          if (spix <= 0xffff)
-            rowptr[col++] = spix & 0xffff;
-          else
-          {
-            epixel = (((signed int)(epixel + 0x7ffffff1)) >> 0x1f);
-            rowptr[col++] = epixel & 0x3fff;
-          }
-        }
-      }
+      checkCancel();
+      int pagestoread = (MIN(LIBRAW_PANA_CS_BAND_ROWS, lastrow - row) + LIBRAW_PANA_CS_ROWSTEP - 1) /
+                        LIBRAW_PANA_CS_ROWSTEP;
+      int rowstoread = pagestoread * LIBRAW_PANA_CS_ROWSTEP;
+      int rowsread = libraw_internal_data.internal_data.input->read(iobuf, rowbytes, rowstoread);
+      int rowsok = MAX(0, rowsread) / LIBRAW_PANA_CS_ROWSTEP * LIBRAW_PANA_CS_ROWSTEP;
+      unsigned short *dest = imgdata.rawdata.raw_image + (INT64)row * pitch;
+#ifdef LIBRAW_USE_OPENMP
+#pragma omp parallel for schedule(static) num_threads(raw_threads())
+#endif
+      for (int crow = 0; crow < rowsok; crow++)
+        pana_cs6_decode_row(iobuf + (INT64)crow * rowbytes, dest + (INT64)crow * pitch, blocksperrow);
+      if (rowsread != rowstoread)
+        throw LIBRAW_EXCEPTION_IO_EOF;
     }
   }
+  catch (...)
+  {
+    free(iobuf);
+    throw;
+  }
   free(iobuf);
 }
 
 void LibRaw::panasonicC7_load_raw()
 {
-  const int rowstep = 16;
-  int pixperblock = libraw_internal_data.unpacker_data.pana_bpp == 14 ? 9 : 10;
-  int rowbytes = imgdata.sizes.raw_width / pixperblock * 16;
-  unsigned char *iobuf = (unsigned char *)malloc(rowbytes * rowstep);
+  const int bpp = libraw_internal_data.unpacker_data.pana_bpp;
+  const int pixperblock = bpp == 14 ? 9 : 10;
+  const int rowbytes = imgdata.sizes.raw_width / pixperblock * 16;
+  const int rwidth = imgdata.sizes.raw_width;
+  const int pitch = imgdata.sizes.raw_pitch / 2;
+  const int lastrow = imgdata.sizes.raw_height - LIBRAW_PANA_CS_ROWSTEP + 1;
+  unsigned char *iobuf = (unsigned char *)malloc(rowbytes * LIBRAW_PANA_CS_BAND_ROWS);
   merror(iobuf, "panasonicC7_load_raw()");
-  for (int row = 0; row < imgdata.sizes.raw_height - rowstep + 1;
-       row += rowstep)
+  try
   {
-    int rowstoread = MIN(rowstep, imgdata.sizes.raw_height - row);
-    if (libraw_internal_data.internal_data.input->read(
-            iobuf, rowbytes, rowstoread) != rowstoread)
-      throw LIBRAW_EXCEPTION_IO_EOF;
-    unsigned char *bytes = iobuf;
-    for (int crow = 0; crow < rowstoread; crow++)
+    for (int row = 0; row < lastrow; row += LIBRAW_PANA_CS_BAND_ROWS)
     {
-      unsigned short *rowptr =
-          &imgdata.rawdata
-               .raw_image[(row + crow) * imgdata.sizes.raw_pitch / 2];
-      for (int col = 0; col < imgdata.sizes.raw_width - pixperblock + 1;
-           col += pixperblock, bytes += 16)
-      {
-        if (libraw_internal_data.unpacker_data.pana_bpp == 14)
-        {
-          rowptr[col] = bytes[0] + ((bytes[1] & 0x3F) << 8);
-          rowptr[col + 1] =
-              (bytes[1] >> 6) + 4 * (bytes[2]) + ((bytes[3] & 0xF) << 10);
-          rowptr[col + 2] =
-              (bytes[3] >> 4) + 16 * (bytes[4]) + ((bytes[5] & 3) << 12);
-          rowptr[col + 3] = ((bytes[5] & 0xFC) >> 2) + (bytes[6] << 6);
-          rowptr[col + 4] = bytes[7] + ((bytes[8] & 0x3F) << 8);
-          rowptr[col + 5] =
-              (bytes[8] >> 6) + 4 * bytes[9] + ((bytes[10] & 0xF) << 10);
-          rowptr[col + 6] =
-              (bytes[10] >> 4) + 16 * bytes[11] + ((bytes[12] & 3) << 12);
-          rowptr[col + 7] = ((bytes[12] & 0xFC) >> 2) + (bytes[13] << 6);
-          rowptr[col + 8] = bytes[14] + ((bytes[15] & 0x3F) << 8);
-        }
-        else if (libraw_internal_data.unpacker_data.pana_bpp ==
-                 12) // have not seen in the wild yet
-        {
-          rowptr[col] = ((bytes[1] & 0xF) << 8) + bytes[0];
-          rowptr[col + 1] = 16 * bytes[2] + (bytes[1] >> 4);
-          rowptr[col + 2] = ((bytes[4] & 0xF) << 8) + bytes[3];
-          rowptr[col + 3] = 16 * bytes[5] + (bytes[4] >> 4);
-          rowptr[col + 4] = ((bytes[7] & 0xF) << 8) + bytes[6];
-          rowptr[col + 5] = 16 * bytes[8] + (bytes[7] >> 4);
-          rowptr[col + 6] = ((bytes[10] & 0xF) << 8) + bytes[9];
-          rowptr[col + 7] = 16 * bytes[11] + (bytes[10] >> 4);
-          rowptr[col + 8] = ((bytes[13] & 0xF) << 8) + bytes[12];
-          rowptr[col + 9] = 16 * bytes[14] + (bytes[13] >> 4);
-        }
-      }
+      checkCancel();
+      int pagestoread = (MIN(LIBRAW_PANA_CS_BAND_ROWS, lastrow - row) + LIBRAW_PANA_CS_ROWSTEP - 1) /
+                        LIBRAW_PANA_CS_ROWSTEP;
+      int rowstoread = pagestoread * LIBRAW_PANA_CS_ROWSTEP;
+      int rowsread = libraw_internal_data.internal_data.input->read(iobuf, rowbytes, rowstoread);
+      int rowsok = MAX(0, rowsread) / LIBRAW_PANA_CS_ROWSTEP * LIBRAW_PANA_CS_ROWSTEP;
+      unsigned short *dest = imgdata.rawdata.raw_image + (INT64)row * pitch;
+#ifdef LIBRAW_USE_OPENMP
+#pragma omp parallel for schedule(static) num_threads(raw_threads())
+#endif
+      for (int crow = 0; crow < rowsok; crow++)
+        pana_cs7_decode_row(iobuf + (INT64)crow * rowbytes, dest + (INT64)crow * pitch, rwidth, bpp);
+      if (rowsread != rowstoread)
+        throw LIBRAW_EXCEPTION_IO_EOF;
     }
   }
+  catch (...)
+  {
+    free(iobuf);
+    throw;
+  }
   free(iobuf);
 }
 
@@ -488,11 +534,20 @@ void LibRaw::unpacked_load_raw_fuji_f700s20()
     base_offset = row_size; // in bytes
   }
   unsigned char *buffer = (unsigned char *)malloc(row_size * 2);
-  for (int row = 0; row < imgdata.sizes.raw_height; row++)
+  try
+  {
+    for (int row = 0; row < imgdata.sizes.raw_height; row++)
+    {
+      checkCancel();
+      read_shorts((ushort *)buffer, imgdata.sizes.raw_width * 2);
+      memmove(&imgdata.rawdata.raw_image[row * imgdata.sizes.raw_pitch / 2],
+              buffer + base_offset, row_size);
+    }
+  }
+  catch (...)
   {
-    read_shorts((ushort *)buffer, imgdata.sizes.raw_width * 2);
-    memmove(&imgdata.rawdata.raw_image[row * imgdata.sizes.raw_pitch / 2],
-            buffer + base_offset, row_size);
+    free(buffer);
+    throw;
   }
   free(buffer);
 }
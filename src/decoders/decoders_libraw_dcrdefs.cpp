@@ -31,6 +31,7 @@ void LibRaw::nikon_coolscan_load_raw()
   fseek(ifp, data_offset, SEEK_SET);
   for (int row = 0; row < raw_height; row++)
   {
+    checkCancel();
       if(tiff_bps <=8)
         fread(buf, 1, bufsize, ifp);
       else
@@ -79,6 +80,7 @@ void LibRaw::broadcom_load_raw()
 
   for (row = 0; row < raw_height; row++)
   {
+    checkCancel();
     if (fread(data.data() + raw_stride, 1, raw_stride, ifp) < raw_stride)
       derror();
     FORC(raw_stride) data[c] = data[raw_stride + (c ^ rev)];
@@ -97,6 +99,7 @@ void LibRaw::android_tight_load_raw()
   merror(data, "android_tight_load_raw()");
   for (row = 0; row < raw_height; row++)
   {
+    checkCancel();
     if (fread(data, 1, bwide, ifp) < bwide)
       derror();
     for (dp = data, col = 0; col < raw_width; dp += 5, col += 4)
@@ -116,6 +119,7 @@ void LibRaw::android_loose_load_raw()
   merror(data, "android_loose_load_raw()");
   for (row = 0; row < raw_height; row++)
   {
+    checkCancel();
     if (fread(data, 1, bwide, ifp) < bwide)
       derror();
     for (dp = data, col = 0; col < raw_width; dp += 8, col += 6)
@@ -159,6 +163,7 @@ void LibRaw::rpi_load_raw8()
 	data = (uchar *)malloc(dwide * 2);
 	merror(data, "rpi_load_raw8()");
 	for (row = 0; row < raw_height; row++) {
+		checkCancel();
 		if (fread(data + dwide, 1, dwide, ifp) < dwide) derror();
 		FORC(dwide) data[c] = data[dwide + (c ^ rev)];
 		for (dp = data, col = 0; col < raw_width; dp++, col++)
@@ -191,6 +196,7 @@ void LibRaw::rpi_load_raw12()
 	data = (uchar *)malloc(dwide * 2);
 	merror(data, "rpi_load_raw12()");
 	for (row = 0; row < raw_height; row++) {
+		checkCancel();
 		if (fread(data + dwide, 1, dwide, ifp) < dwide) derror();
 		FORC(dwide) data[c] = data[dwide + (c ^ rev)];
 		for (dp = data, col = 0; col < raw_width; dp += 3, col += 2)
@@ -223,6 +229,7 @@ void LibRaw::rpi_load_raw14()
 	data = (uchar *)malloc(dwide * 2);
 	merror(data, "rpi_load_raw14()");
 	for (row = 0; row < raw_height; row++) {
+		checkCancel();
 		if (fread(data + dwide, 1, dwide, ifp) < dwide) derror();
 		FORC(dwide) data[c] = data[dwide + (c ^ rev)];
 		for (dp = data, col = 0; col < raw_width; dp += 7, col += 4) {
@@ -259,6 +266,7 @@ void LibRaw::rpi_load_raw16()
 	data = (uchar *)malloc(dwide * 2);
 	merror(data, "rpi_load_raw16()");
 	for (row = 0; row < raw_height; row++) {
+		checkCancel();
 		if (fread(data + dwide, 1, dwide, ifp) < dwide) derror();
 		FORC(dwide) data[c] = data[dwide + (c ^ rev)];
 		for (dp = data, col = 0; col < raw_width; dp += 2, col++)
@@ -16,6 +16,7 @@
 
  */
 
+#include <algorithm>
 #include "../../internal/dcraw_defs.h"
 
 void LibRaw::vc5_dng_load_raw_placeholder()
@@ -46,6 +47,58 @@ void LibRaw::adobe_copy_pixel(unsigned row, unsigned col, ushort **rp)
   if (tiff_samples == 2 && shot_select)
     (*rp)--;
 }
+/*
+  Tiled DNG: reads tile offsets table at 'table' and tile byte counts.
+  Tile size is limited by the next tile start (or file end) and by
+  maxtile: this also covers missing or SHORT-typed TileByteCounts.
+  Returns max tile size, 0 if file is not tiled (or single tile).
+*/
+INT64 LibRaw::dng_tile_ranges(INT64 table, std::vector<INT64> &toffs,
+                              std::vector<INT64> &tsizes, INT64 maxtile)
+{
+  toffs.clear();
+  tsizes.clear();
+  if (!tile_width || !tile_length || tile_length >= INT_MAX ||
+      tile_width >= INT_MAX)
+    return 0;
+  unsigned tilesH = (raw_width + tile_width - 1) / tile_width;
+  unsigned tilesV = (raw_height + tile_length - 1) / tile_length;
+  INT64 tiles = INT64(tilesH) * tilesV;
+  if (tiles < 2 || tiles > 1000000)
+    return 0;
+
+  INT64 fsize = ifp->size();
+  toffs.resize(tiles);
+  tsizes.resize(tiles, 0);
+  fseek(ifp, table, SEEK_SET);
+  for (int t = 0; t < tiles; t++)
+    toffs[t] = get4();
+  int iifd = find_ifd_by_offset(table);
+  if (iifd >= 0 && tiff_ifd[iifd].bytes > 0)
+  {
+    fseek(ifp, tiff_ifd[iifd].bytes, SEEK_SET);
+    for (int t = 0; t < tiles; t++)
+      tsizes[t] = get4();
+  }
+
+  std::vector<INT64> sorted(toffs);
+  std::sort(sorted.begin(), sorted.end());
+  INT64 maxsize = 0;
+  for (int t = 0; t < tiles; t++)
+  {
+    std::vector<INT64>::iterator next =
+        std::upper_bound(sorted.begin(), sorted.end(), toffs[t]);
+    INT64 gap = toffs[t] < fsize
+                    ? (next == sorted.end() ? fsize : MIN(*next, fsize)) - toffs[t]
+                    : 0;
+    if (tsizes[t] > 0)
+      gap = MIN(gap, tsizes[t]);
+    tsizes[t] = MIN(gap, maxtile);
+    maxsize = MAX(maxsize, tsizes[t]);
+  }
+  return maxsize;
+}
+
 void LibRaw::lossless_dng_load_raw()
 {
   unsigned save, trow = 0, tcol = 0, jwide, jrow, jcol, row, col, i, j;
@@ -55,10 +108,43 @@ void LibRaw::lossless_dng_load_raw()
   int ss = shot_select;
   shot_select = libraw_internal_data.unpacker_data.dng_frames[LIM(ss,0,(LIBRAW_IFD_MAXCOUNT*2-1))] & 0xff;
 
+  if (ifp->has_read_ahead())
+  {
+    /* tile data read-ahead hint for range/remote streams */
+    INT64 save = ftell(ifp);
+    std::vector<INT64> toffs, tsizes;
+    if (dng_tile_ranges(save, toffs, tsizes,
+                        INT64(tile_width) * tile_length * MAX(tiff_samples, 1) * 4 +
+                            0x10000) > 0)
+    {
+      /* only tiles intersecting decode ROI are read */
+      unsigned tilesH = (raw_width + tile_width - 1) / tile_width;
+      size_t n = 0;
+      for (size_t t = 0; t < toffs.size(); t++)
+        if (!decode_roi_skip(unsigned(t / tilesH) * tile_length,
+                             unsigned(t % tilesH) * tile_width, tile_length,
+                             tile_width))
+        {
+          toffs[n] = toffs[t];
+          tsizes[n++] = tsizes[t];
+        }
+      ifp->read_ahead(int(n), toffs.data(), tsizes.data());
+    }
+    fseek(ifp, save, SEEK_SET);
+  }
+
   while (trow < raw_height)
   {
     checkCancel();
     save = ftell(ifp);
+    if (tile_length < INT_MAX &&
+        decode_roi_skip(trow, tcol, tile_length, tile_width))
+    {
+      fseek(ifp, save + 4, SEEK_SET);
+      if ((tcol += tile_width) >= raw_width)
+        trow += tile_length + (tcol = 0);
+      continue;
+    }
     if (tile_length < INT_MAX)
       fseek(ifp, get4(), SEEK_SET);
     if (!ljpeg_start(&jh, 0))
@@ -137,9 +223,19 @@ void LibRaw::packed_dng_load_raw()
 
   pixel = (ushort *)calloc(raw_width, tiff_samples * sizeof *pixel);
   merror(pixel, "packed_dng_load_raw()");
+
+  /* rows are byte aligned: rows above decode ROI are skipped */
+  unsigned row0 = 0, row1 = raw_height;
+  decode_roi_rows(&row0, &row1);
+  if (tiff_bps == 16 || !zero_after_ff)
+    fseek(ifp,
+          INT64(row0) * ((INT64(raw_width) * tiff_samples * tiff_bps + 7) / 8),
+          SEEK_CUR);
+  else
+    row0 = 0;
   try
   {
-    for (row = 0; row < raw_height; row++)
+    for (row = row0; row < row1; row++)
     {
       checkCancel();
       if (tiff_bps == 16)
@@ -172,6 +268,134 @@ static void jpegErrorExit_d(j_common_ptr cinfo)
   throw LIBRAW_EXCEPTION_DECODE_JPEG;
 }
 
+static void lossy_dng_decode_tile(j_decompress_ptr cinfo, ushort (*img)[4],
+                                  unsigned twidth, unsigned theight,
+                                  unsigned trow, unsigned tcol,
+                                  ushort cur[3][256])
+{
+  JSAMPARRAY buf;
+  JSAMPLE(*pixel)[3];
+  unsigned row, col, c;
+
+  jpeg_read_header(cinfo, TRUE);
+  jpeg_start_decompress(cinfo);
+  buf = (*cinfo->mem->alloc_sarray)((j_common_ptr)cinfo, JPOOL_IMAGE,
+                                    cinfo->output_width * 3, 1);
+  while (cinfo->output_scanline < cinfo->output_height &&
+         (row = trow + cinfo->output_scanline) < theight)
+  {
+    jpeg_read_scanlines(cinfo, buf, 1);
+    pixel = (JSAMPLE(*)[3])buf[0];
+    for (col = 0; col < cinfo->output_width && tcol + col < twidth; col++)
+    {
+      FORC3 img[row * twidth + tcol + col][c] = cur[c][pixel[col][c]];
+    }
+  }
+  jpeg_abort_decompress(cinfo);
+}
+
+/*
+  Tiled lossy DNG: tile bytes are read one tile at a time, JPEG decoding
+  runs in parallel with one decompress struct per thread.
+  Returns 0 if the file layout is not suitable, caller should use
+  sequential decoder in this case.
+*/
+int LibRaw::lossy_dng_load_tiles(ushort cur[3][256])
+{
+  std::vector<INT64> toffs, tsizes;
+  INT64 maxsize = dng_tile_ranges(
+      data_offset, toffs, tsizes, INT64(tile_width) * tile_length * 12 + 0x10000);
+  if (maxsize < 1)
+    return 0;
+  INT64 tiles = INT64(toffs.size());
+  unsigned tilesH = (raw_width + tile_width - 1) / tile_width;
+  ifp->read_ahead(int(tiles), toffs.data(), tsizes.data());
+
+  LibRaw_abstract_datastream *input = libraw_internal_data.internal_data.input;
+  /* shared by all threads: 0 - ok, else exception to throw when done */
+  int stop = LIBRAW_EXCEPTION_NONE;
+#ifdef LIBRAW_USE_OPENMP
+  int nthreads = MAX(1, MIN(raw_threads(), int(tiles)));
+#pragma omp parallel num_threads(nthreads) shared(stop)
+#endif
+  {
+    struct jpeg_decompress_struct cinfo;
+    struct jpeg_error_mgr pub;
+    std::vector<uchar> tbuf;
+    bool ready = false;
+    cinfo.err = jpeg_std_error(&pub);
+    pub.error_exit = jpegErrorExit_d;
+    try
+    {
+      jpeg_create_decompress(&cinfo);
+      ready = true;
+      tbuf.resize(maxsize);
+    }
+    catch (...)
+    {
+#ifdef LIBRAW_USE_OPENMP
+#pragma omp atomic write
+#endif
+      stop = LIBRAW_EXCEPTION_DECODE_JPEG;
+    }
+
+#ifdef LIBRAW_USE_OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+    for (int t = 0; t < tiles; t++)
+    {
+      int stopped;
+#ifdef LIBRAW_USE_OPENMP
+#pragma omp atomic read
+#endif
+      stopped = stop;
+      if (!ready || stopped)
+        continue;
+      try
+      {
+        checkCancel();
+      }
+      catch (...)
+      {
+#ifdef LIBRAW_USE_OPENMP
+#pragma omp atomic write
+#endif
+        stop = LIBRAW_EXCEPTION_CANCELLED_BY_CALLBACK;
+        continue;
+      }
+      int got;
+#ifdef LIBRAW_USE_OPENMP
+#pragma omp critical
+#endif
+      {
+        input->seek(toffs[t], SEEK_SET);
+        got = input->read(tbuf.data(), 1, tsizes[t]);
+      }
+      try
+      {
+        jpeg_mem_src(&cinfo, tbuf.data(), MAX(got, 0));
+        lossy_dng_decode_tile(&cinfo, image, width, height,
+                              (t / tilesH) * tile_length,
+                              (t % tilesH) * tile_width, cur);
+      }
+      catch (...)
+      {
+        jpeg_abort_decompress(&cinfo);
+#ifdef LIBRAW_USE_OPENMP
+#pragma omp atomic write
+#endif
+        stop = LIBRAW_EXCEPTION_DECODE_JPEG;
+      }
+    }
+    if (ready)
+      jpeg_destroy_decompress(&cinfo);
+  }
+
+  if (stop != LIBRAW_EXCEPTION_NONE)
+    throw (LibRaw_exceptions)stop;
+  return 1;
+}
+
 void LibRaw::lossy_dng_load_raw()
 {
   if (!image)
@@ -222,6 +446,12 @@ void LibRaw::lossy_dng_load_raw()
     FORC3 memcpy(cur[c], curve, sizeof cur[0]);
   }
 
+  if (lossy_dng_load_tiles(cur))
+  {
+    maximum = 0xffff;
+    return;
+  }
+
   struct jpeg_error_mgr pub;
   cinfo.err = jpeg_std_error(&pub);
   pub.error_exit = jpegErrorExit_d;
@@ -93,8 +93,64 @@ inline unsigned int __DNG_FP24ToFloat(const unsigned char *input)
   return (uint32_t)((sign << 31) | (exponent << 23) | mantissa);
 }
 
+#if !LibRawBigEndian
+/* Bytewise add of two 64-bit words without carry between bytes */
+static inline UINT64 DeltaAddBytes(UINT64 a, UINT64 b)
+{
+  const UINT64 H = 0x8080808080808080ULL;
+  return ((a & ~H) + (b & ~H)) ^ ((a ^ b) & H);
+}
+
+/* Horizontal predictor, 8 bytes at once. Handles channels 1, 2, 4 and
+   multiples of 8, returns false for other channel counts */
+static bool DecodeDeltaWords(unsigned char *bytePtr, int cols, int channels)
+{
+  size_t bytes = size_t(cols) * channels;
+  size_t words = bytes / 8;
+  if (channels == 1 || channels == 2 || channels == 4)
+  {
+    const UINT64 spread = channels == 1   ? 0x0101010101010101ULL
+                          : channels == 2 ? 0x0001000100010001ULL
+                                          : 0x0000000100000001ULL;
+    const int topshift = 64 - channels * 8;
+    UINT64 carry = 0;
+    for (size_t i = 0; i < words; i++)
+    {
+      UINT64 w;
+      memcpy(&w, bytePtr + i * 8, 8);
+      for (int s = channels; s < 8; s <<= 1)
+        w = DeltaAddBytes(w, w << (s * 8));
+      w = DeltaAddBytes(w, carry);
+      carry = (w >> topshift) * spread;
+      memcpy(bytePtr + i * 8, &w, 8);
+    }
+    for (size_t i = MAX(words * 8, size_t(channels)); i < bytes; i++)
+      bytePtr[i] += bytePtr[i - channels];
+    return true;
+  }
+  else if (channels % 8 == 0)
+  {
+    const size_t step = channels / 8;
+    for (size_t i = step; i < words; i++)
+    {
+      UINT64 w, p;
+      memcpy(&w, bytePtr + i * 8, 8);
+      memcpy(&p, bytePtr + (i - step) * 8, 8);
+      w = DeltaAddBytes(w, p);
+      memcpy(bytePtr + i * 8, &w, 8);
+    }
+    return true;
+  }
+  return false;
+}
+#endif
+
 inline void DecodeDeltaBytes(unsigned char *bytePtr, int cols, int channels)
 {
+#if !LibRawBigEndian
+  if (DecodeDeltaWords(bytePtr, cols, channels))
+    return;
+#endif
   if (channels == 1)
   {
     unsigned char b0 = bytePtr[0];
@@ -252,6 +308,93 @@ static float expandFloats(unsigned char *dst, int tileWidth, int bytesps)
   return max;
 }
 
+/* Branch-free variants of __DNG_HalfToFloat() and __DNG_FP24ToFloat() for
+   the row loops below: denormals are exact as mantissa * 2^-24 (half) or
+   mantissa * 2^-78 (FP24) in single precision. Selection is done with bit
+   masks, so the compiler can vectorize the calling loops */
+static inline unsigned FloatBitsSelect(unsigned sign, unsigned exponent,
+                                       unsigned mantissa, unsigned normal,
+                                       unsigned den, unsigned inf, unsigned maxexp)
+{
+  unsigned dmask = 0u - unsigned(exponent == 0);
+  unsigned imask = 0u - unsigned(exponent == maxexp);
+  unsigned nmask = imask & (0u - unsigned(mantissa != 0)); // NaN: set to zero
+  unsigned r = (den & dmask) | (normal & ~dmask);
+  return ((inf & imask) | (r & ~imask) | sign) & ~nmask;
+}
+
+static inline unsigned HalfToFloatBits(unsigned h)
+{
+  unsigned sign = (h & 0x8000u) << 16;
+  unsigned exponent = (h >> 10) & 0x1f;
+  unsigned mantissa = h & 0x3ff;
+  float fden = float(int(mantissa)) * (1.f / 16777216.f);
+  unsigned den;
+  memcpy(&den, &fden, 4);
+  return FloatBitsSelect(sign, exponent, mantissa,
+                         ((exponent + 127 - 15) << 23) | (mantissa << 13), den,
+                         ((0x1eu + 127 - 15) << 23) | (0x3ffu << 13), 31);
+}
+
+static inline unsigned FP24ToFloatBits(unsigned b0, unsigned b1, unsigned b2)
+{
+  const float scale = (1.f / 65536.f) * (1.f / 65536.f) * (1.f / 65536.f) *
+                      (1.f / 65536.f) * (1.f / 16384.f);
+  unsigned sign = (b0 & 0x80) << 24;
+  unsigned exponent = b0 & 0x7f;
+  unsigned mantissa = (b1 << 8) | b2;
+  float fden = float(int(mantissa)) * scale;
+  unsigned den;
+  memcpy(&den, &fden, 4);
+  return FloatBitsSelect(sign, exponent, mantissa,
+                         ((exponent + 128 - 64) << 23) | (mantissa << 7), den,
+                         ((0x7eu + 128 - 64) << 23) | (0xffffu << 7), 127);
+}
+
+/* Out-of-place expandFloats(): converts count samples from src to dst and
+   returns the maximum value. 24-bit data is taken as three byte planes of
+   count bytes each, as left by DecodeDeltaBytes() */
+static float expandFloatsTo(const unsigned char *src, float *dst, int count,
+                            int bytesps)
+{
+  if (bytesps == 4)
+  {
+    float max = 0.f;
+    memcpy(dst, src, count * sizeof(float));
+    for (int index = 0; index < count; index++)
+      max = MAX(max, dst[index]);
+    return max;
+  }
+  /* conversions never produce NaN, so integer compare of the float bits
+     gives the maximum of non-negative values */
+  unsigned *dst32 = (unsigned *)dst;
+  int imax = 0;
+  if (bytesps == 2)
+  {
+    const ushort *src16 = (const ushort *)src;
+    for (int index = 0; index < count; index++)
+    {
+      unsigned v = HalfToFloatBits(src16[index]);
+      dst32[index] = v;
+      imax = MAX(imax, int(v));
+    }
+  }
+  else
+  {
+    const unsigned char *src1 = src + count;
+    const unsigned char *src2 = src + count * 2;
+    for (int index = 0; index < count; index++)
+    {
+      unsigned v = FP24ToFloatBits(src[index], src1[index], src2[index]);
+      dst32[index] = v;
+      imax = MAX(imax, int(v));
+    }
+  }
+  float max;
+  memcpy(&max, &imax, 4);
+  return max;
+}
+
 struct tile_stripe_data_t
 {
     bool tiled, striped;
@@ -284,7 +427,7 @@ void tile_stripe_data_t::init(tiff_ifd_t *ifd, const libraw_image_sizes_t& sizes
     tileWidth = tiled ? unpacker_data.tile_width : sizes.raw_width;
     tileHeight = tiled ? unpacker_data.tile_length :(striped ? ifd->rows_per_strip : sizes.raw_height);
     tilesH = tiled ? (sizes.raw_width + tileWidth - 1) / tileWidth : 1;
-    tilesV = tiled ? (sizes.raw_height + tileHeight - 1) / tileHeight : 1;
+    tilesV = tiled || striped ? (sizes.raw_height + tileHeight - 1) / tileHeight : 1;
     tileCnt = tilesH * tilesV;
 
     if (tileCnt < 1 || tileCnt > 1000000)
@@ -322,9 +465,52 @@ void tile_stripe_data_t::init(tiff_ifd_t *ifd, const libraw_image_sizes_t& sizes
             tBytes[t] = ifd->strip_byte_counts[t];
             maxBytesInTile = MAX(maxBytesInTile, tBytes[t]);
         }
+
+    // remote/range streams may fetch tile data ahead (and concurrently)
+    if (stream->has_read_ahead())
+    {
+        std::vector<INT64> offs(tOffsets.begin(), tOffsets.end());
+        std::vector<INT64> lens(tBytes.begin(), tBytes.end());
+        stream->read_ahead(tileCnt, offs.data(), lens.data());
+    }
 }
 
 #ifdef USE_ZLIB
+/* Per-thread inflate stream and buffers for deflate_dng_load_raw() */
+struct deflate_dng_tile_decoder
+{
+  z_stream zs;
+  bool zinit;
+  std::vector<uchar> cBuffer, uBuffer, rowBuffer;
+  std::vector<float> fBuffer;
+  deflate_dng_tile_decoder() : zinit(false) { memset(&zs, 0, sizeof(zs)); }
+  ~deflate_dng_tile_decoder()
+  {
+    if (zinit)
+      inflateEnd(&zs);
+  }
+  bool init(size_t maxBytesInTile, size_t tileBytes, size_t tileRowBytes)
+  {
+    cBuffer.resize(maxBytesInTile);
+    uBuffer.resize(tileBytes);
+    rowBuffer.resize(tileRowBytes);
+    fBuffer.resize(tileRowBytes / sizeof(float));
+    zinit = inflateInit(&zs) == Z_OK;
+    return zinit;
+  }
+  // same as uncompress() returning Z_OK, without stream setup per tile
+  bool inflate_tile(size_t srcBytes)
+  {
+    if (inflateReset(&zs) != Z_OK)
+      return false;
+    zs.next_in = cBuffer.data();
+    zs.avail_in = uInt(srcBytes);
+    zs.next_out = uBuffer.data();
+    zs.avail_out = uInt(uBuffer.size());
+    return inflate(&zs, Z_FINISH) == Z_STREAM_END;
+  }
+};
+
 void LibRaw::deflate_dng_load_raw()
 {
   int iifd = find_ifd_by_offset(libraw_internal_data.unpacker_data.data_offset);
@@ -370,44 +556,95 @@ void LibRaw::deflate_dng_load_raw()
   unsigned tileBytes = tilePixels * pixelSize;
   unsigned tileRowBytes = tiles.tileWidth * pixelSize;
 
-  std::vector<uchar> cBuffer(tiles.maxBytesInTile);
-  std::vector<uchar> uBuffer(tileBytes + tileRowBytes); // extra row for decoding
+  int bytesps = ifd->bps >> 3;
+  if (bytesps < 2 || bytesps > 4)
+  {
+    free(float_raw_image);
+    throw LIBRAW_EXCEPTION_DECODE_RAW;
+  }
+  size_t inRowBytes = size_t(tiles.tileWidth) * bytesps * ifd->samples;
+
+  LibRaw_abstract_datastream *input = libraw_internal_data.internal_data.input;
+  std::vector<float> tileMax(tiles.tileCnt, 0.f);
+  int errors = 0;
+
+  // Tiles are read one at a time, inflate and predictor run in parallel
+#ifdef LIBRAW_USE_OPENMP
+  int nthreads = MAX(1, MIN(raw_threads(), tiles.tileCnt));
+#pragma omp parallel num_threads(nthreads) reduction(+ : errors)
+#endif
+  {
+    deflate_dng_tile_decoder dec;
+    bool ready;
+    try
+    {
+      ready = dec.init(tiles.maxBytesInTile, tileBytes, tileRowBytes);
+    }
+    catch (...)
+    {
+      ready = false;
+    }
+    if (!ready)
+      errors++;
 
-  for (size_t y = 0, t = 0; y < imgdata.sizes.raw_height; y += tiles.tileHeight)
+#ifdef LIBRAW_USE_OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+    for (int t = 0; t < tiles.tileCnt; t++)
     {
-      for (size_t x = 0; x < imgdata.sizes.raw_width; x += tiles.tileWidth, ++t)
+      if (!ready || cancelRequested())
+        continue;
+      size_t y = size_t(t / tiles.tilesH) * tiles.tileHeight;
+      size_t x = size_t(t % tiles.tilesH) * tiles.tileWidth;
+      if (y >= imgdata.sizes.raw_height)
+        continue;
+      int got;
+#ifdef LIBRAW_USE_OPENMP
+#pragma omp critical
+#endif
+      {
+        input->seek(tiles.tOffsets[t], SEEK_SET);
+        got = input->read(dec.cBuffer.data(), 1, tiles.tBytes[t]);
+      }
+      if (!dec.inflate_tile(MAX(got, 0)))
+      {
+        errors++;
+        continue;
+      }
+      size_t rowsInTile = y + tiles.tileHeight > imgdata.sizes.raw_height ? imgdata.sizes.raw_height - y : tiles.tileHeight;
+      size_t colsInTile = x + tiles.tileWidth > imgdata.sizes.raw_width ? imgdata.sizes.raw_width - x : tiles.tileWidth;
+
+      float tmax = 0.f;
+      for (size_t row = 0; row < rowsInTile; ++row) // do not process full tile if not needed
       {
-        libraw_internal_data.internal_data.input->seek(tiles.tOffsets[t], SEEK_SET);
-        libraw_internal_data.internal_data.input->read(cBuffer.data(), 1, tiles.tBytes[t]);
-        unsigned long dstLen = tileBytes;
-        int err =
-            uncompress(uBuffer.data() + tileRowBytes, &dstLen, cBuffer.data(), tiles.tBytes[t]);
-        if (err != Z_OK)
+        unsigned char *src = dec.uBuffer.data() + row * inRowBytes;
+        unsigned char *planes = dec.rowBuffer.data();
+        if (bytesps == 3) // FP24 is converted directly from byte planes
         {
-          throw LIBRAW_EXCEPTION_DECODE_RAW;
-          return;
+          DecodeDeltaBytes(src, tiles.tileWidth / xFactor * bytesps, ifd->samples * xFactor);
+          planes = src;
         }
         else
-        {
-          int bytesps = ifd->bps >> 3;
-          size_t rowsInTile = y + tiles.tileHeight > imgdata.sizes.raw_height ? imgdata.sizes.raw_height - y : tiles.tileHeight;
-          size_t colsInTile = x + tiles.tileWidth > imgdata.sizes.raw_width ? imgdata.sizes.raw_width - x : tiles.tileWidth;
-
-          for (size_t row = 0; row < rowsInTile; ++row) // do not process full tile if not needed
-          {
-              unsigned char *dst = uBuffer.data() + row * tiles.tileWidth * bytesps * ifd->samples;
-              unsigned char *src = dst + tileRowBytes;
-              DecodeFPDelta(src, dst, tiles.tileWidth / xFactor, ifd->samples * xFactor, bytesps);
-              float lmax = expandFloats(dst, tiles.tileWidth * ifd->samples, bytesps);
-            max = MAX(max, lmax);
-            unsigned char *dst2 = (unsigned char *)&float_raw_image
-                [((y + row) * imgdata.sizes.raw_width + x) * ifd->samples];
-            memmove(dst2, dst, colsInTile * ifd->samples * sizeof(float));
-          }
-        }
+          DecodeFPDelta(src, planes, tiles.tileWidth / xFactor, ifd->samples * xFactor, bytesps);
+        float lmax = expandFloatsTo(planes, dec.fBuffer.data(), tiles.tileWidth * ifd->samples, bytesps);
+        tmax = MAX(tmax, lmax);
+        memcpy(&float_raw_image[((y + row) * imgdata.sizes.raw_width + x) * ifd->samples],
+               dec.fBuffer.data(), colsInTile * ifd->samples * sizeof(float));
       }
+      tileMax[t] = tmax;
     }
-  
+  }
+
+  if (errors || cancelRequested())
+  {
+    free(float_raw_image);
+    checkCancel();
+    throw LIBRAW_EXCEPTION_DECODE_RAW;
+  }
+
+  for (int t = 0; t < tiles.tileCnt; t++)
+    max = MAX(max, tileMax[t]);
+
   imgdata.color.fmaximum = max;
 
   // Set fields according to data format
@@ -612,6 +849,7 @@ void LibRaw::uncompressed_fp_dng_load_raw()
     {
         for (size_t x = 0; x < imgdata.sizes.raw_width  && t < tiles.tileCnt; x += tiles.tileWidth, ++t)
         {
+            checkCancel();
             libraw_internal_data.internal_data.input->seek(tiles.tOffsets[t], SEEK_SET);
             size_t rowsInTile = y + tiles.tileHeight > imgdata.sizes.raw_height ? imgdata.sizes.raw_height - y : tiles.tileHeight;
             size_t colsInTile = x + tiles.tileWidth > imgdata.sizes.raw_width ? imgdata.sizes.raw_width - x : tiles.tileWidth;
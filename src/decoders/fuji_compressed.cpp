@@ -1019,6 +1019,23 @@ void LibRaw::fuji_decode_strip(fuji_compressed_params *params, int cur_block, IN
   fuji_compressed_block info;
   fuji_compressed_params *info_common = params;
 
+  cur_block_width = libraw_internal_data.unpacker_data.fuji_block_width;
+  if (cur_block + 1 == libraw_internal_data.unpacker_data.fuji_total_blocks)
+  {
+    cur_block_width = imgdata.sizes.raw_width - (libraw_internal_data.unpacker_data.fuji_block_width * cur_block);
+    /* Old code, may get incorrect results on GFX50, but luckily large optical
+    black cur_block_width = imgdata.sizes.raw_width %
+    libraw_internal_data.unpacker_data.fuji_block_width;
+    */
+  }
+  // strips are decoded top down: skip the ones left/right of decode ROI,
+  // stop below it
+  unsigned row0 = 0, row1 = imgdata.sizes.raw_height;
+  if (decode_roi_skip(0, libraw_internal_data.unpacker_data.fuji_block_width * cur_block, row1, cur_block_width))
+    return;
+  decode_roi_rows(&row0, &row1);
+  int total_lines = MIN(libraw_internal_data.unpacker_data.fuji_total_lines, int(row1 + 5) / 6);
+
   if (!libraw_internal_data.unpacker_data.fuji_lossless)
   {
     int buf_size = sizeof(fuji_compressed_params) + (2 << libraw_internal_data.unpacker_data.fuji_bits);
@@ -1032,24 +1049,16 @@ void LibRaw::fuji_decode_strip(fuji_compressed_params *params, int cur_block, IN
   init_fuji_block(&info, info_common, raw_offset, dsize);
   line_size = sizeof(ushort) * (info_common->line_width + 2);
 
-  cur_block_width = libraw_internal_data.unpacker_data.fuji_block_width;
-  if (cur_block + 1 == libraw_internal_data.unpacker_data.fuji_total_blocks)
-  {
-    cur_block_width = imgdata.sizes.raw_width - (libraw_internal_data.unpacker_data.fuji_block_width * cur_block);
-    /* Old code, may get incorrect results on GFX50, but luckily large optical
-    black cur_block_width = imgdata.sizes.raw_width %
-    libraw_internal_data.unpacker_data.fuji_block_width;
-    */
-  }
-
   struct i_pair
   {
     int a, b;
   };
   const i_pair mtable[6] = {{_R0, _R3}, {_R1, _R4}, {_G0, _G6}, {_G1, _G7}, {_B0, _B3}, {_B1, _B4}},
                ztable[3] = {{_R2, 3}, {_G2, 6}, {_B2, 3}};
-  for (cur_line = 0; cur_line < libraw_internal_data.unpacker_data.fuji_total_lines; cur_line++)
+  for (cur_line = 0; cur_line < total_lines; cur_line++)
   {
+    if (cancelRequested())
+      break;
     // init grads and main qtable
     if (!libraw_internal_data.unpacker_data.fuji_lossless)
     {
@@ -1147,21 +1156,53 @@ void LibRaw::fuji_compressed_load_raw()
   free(common_info.buf);
 }
 
-void LibRaw::fuji_decode_loop(fuji_compressed_params *common_info, int count, INT64 *raw_block_offsets,
-                              unsigned *block_sizes, uchar *q_bases)
+struct fuji_decode_task_t
 {
-  int cur_block;
-  const int lineStep = (libraw_internal_data.unpacker_data.fuji_total_lines + 0xF) & ~0xF;
-#ifdef LIBRAW_USE_OPENMP
-#pragma omp parallel for private(cur_block)
-#endif
-  for (cur_block = 0; cur_block < count; cur_block++)
+  LibRaw *self;
+  fuji_compressed_params *common_info;
+  INT64 *raw_block_offsets;
+  unsigned *block_sizes;
+  uchar *q_bases;
+  int lineStep;
+  LibRaw_exceptions exception;
+};
+
+void LibRaw::fuji_decode_strip_task(void *t, int cur_block)
+{
+  fuji_decode_task_t *task = (fuji_decode_task_t *)t;
+  try
+  {
+    task->self->fuji_decode_strip(task->common_info, cur_block, task->raw_block_offsets[cur_block],
+                                  task->block_sizes[cur_block],
+                                  task->q_bases ? task->q_bases + cur_block * task->lineStep : 0);
+  }
+  catch (const LibRaw_exceptions &e)
+  {
+    task->exception = e;
+  }
+  catch (...)
   {
-    fuji_decode_strip(common_info, cur_block, raw_block_offsets[cur_block], block_sizes[cur_block],
-                      q_bases ? q_bases + cur_block * lineStep : 0);
+    task->exception = LIBRAW_EXCEPTION_ALLOC;
   }
 }
 
+void LibRaw::fuji_decode_loop(fuji_compressed_params *common_info, int count, INT64 *raw_block_offsets,
+                              unsigned *block_sizes, uchar *q_bases)
+{
+  fuji_decode_task_t task;
+  task.self = this;
+  task.common_info = common_info;
+  task.raw_block_offsets = raw_block_offsets;
+  task.block_sizes = block_sizes;
+  task.q_bases = q_bases;
+  task.lineStep = (libraw_internal_data.unpacker_data.fuji_total_lines + 0xF) & ~0xF;
+  task.exception = LIBRAW_EXCEPTION_NONE;
+  run_parallel(count, raw_threads(), fuji_decode_strip_task, &task);
+  checkCancel();
+  if (task.exception != LIBRAW_EXCEPTION_NONE)
+    throw task.exception;
+}
+
 void LibRaw::parse_fuji_compressed_header()
 {
   unsigned signature, lossless, h_raw_type, h_raw_bits, h_raw_height, h_raw_rounded_width, h_raw_width, h_block_size,
@@ -21,12 +21,15 @@
 void LibRaw::unpacked_load_raw()
 {
   int row, col, bits = 0;
+  unsigned row0 = 0, row1 = raw_height;
   while (1 << ++bits < (int)maximum)
     ;
-  read_shorts(raw_image, raw_width * raw_height);
+  decode_roi_rows(&row0, &row1);
+  fseek(ifp, INT64(row0) * raw_width * 2, SEEK_CUR);
+  read_shorts(raw_image + size_t(row0) * raw_width, raw_width * (row1 - row0));
   fseek(ifp, -2, SEEK_CUR); // avoid EOF error
   if (maximum < 0xffff || load_flags)
-    for (row = 0; row < raw_height; row++)
+    for (row = row0; row < int(row1); row++)
     {
       checkCancel();
       for (col = 0; col < raw_width; col++)
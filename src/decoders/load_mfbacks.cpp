@@ -492,9 +492,11 @@ void LibRaw::phase_one_load_raw_c()
 
   for (i = 0; i < 256; i++)
     curve[i] = i * i / 3.969 + 0.5;
+  unsigned row0 = 0, row1 = raw_height;
+  decode_roi_rows(&row0, &row1);
   try
   {
-    for (row = 0; row < raw_height; row++)
+    for (row = row0; row < int(row1); row++)
     {
       checkCancel();
       fseek(ifp, data_offset + offset[row], SEEK_SET);
@@ -685,6 +687,7 @@ for Fuji DBP for GX680, aka DX-2000
 
   for (tile_n = 0; tile_n < nTiles; tile_n++)
   {
+    checkCancel();
     read_shorts(tile, tile_width * raw_height);
     for (scan_line = 0; scan_line < raw_height; scan_line++)
     {
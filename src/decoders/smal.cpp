@@ -38,6 +38,8 @@ void LibRaw::smal_decode_segment(unsigned seg[2][2], int holes)
     seg[1][0] = raw_width * raw_height;
   for (pix = seg[0][0]; pix < seg[1][0]; pix++)
   {
+    if (pix % raw_width == 0)
+      checkCancel();
     for (s = 0; s < 3; s++)
     {
       data = data << nbits | getbits(nbits);
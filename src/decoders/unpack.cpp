@@ -24,6 +24,12 @@ int LibRaw::unpack(void)
     if (!libraw_internal_data.internal_data.input)
       return LIBRAW_INPUT_CLOSED;
 
+    if (libraw_internal_data.internal_data.metadata_only)
+      return LIBRAW_OUT_OF_ORDER_CALL; // opened with LIBRAW_RAWOPTIONS_METADATA_ONLY
+
+    if (render_cache)
+      render_cache->valid = 0;
+
     RUN_CALLBACK(LIBRAW_PROGRESS_LOAD_RAW, 0, 2);
     if (O.shot_select >= P1.raw_count)
       return LIBRAW_REQUEST_FOR_NONEXISTENT_IMAGE;
@@ -72,6 +78,9 @@ int LibRaw::unpack(void)
     imgdata.rawdata.color4_image = 0;
     imgdata.rawdata.color3_image = 0;
     imgdata.rawdata.float_image = 0;
+    memset(libraw_internal_data.unpacker_data.roi_box, 0,
+           sizeof(libraw_internal_data.unpacker_data.roi_box));
+    libraw_internal_data.unpacker_data.masked_areas_set = 0;
     imgdata.rawdata.float3_image = 0;
 
 #ifdef USE_DNGSDK
@@ -153,6 +162,11 @@ int LibRaw::unpack(void)
           libraw_internal_data.unpacker_data.pana_encoding > 4)
         rawspeed_enabled = 0;
 
+      // camera metadata is parsed on first use, it may stay NULL on error
+      if (imgdata.rawparams.use_rawspeed && rawspeed_enabled &&
+          !_rawspeed_camerameta)
+        _rawspeed_camerameta = static_cast<void *>(make_camera_metadata());
+
       // RawSpeed Supported,
       if (imgdata.rawparams.use_rawspeed && rawspeed_enabled &&
           !(is_sraw() && (imgdata.rawparams.specials &
@@ -180,6 +194,7 @@ int LibRaw::unpack(void)
     {
       // Not allocated on RawSpeed call, try call LibRaow
       int zero_rawimage = 0;
+      set_decode_roi();
       if (decoder_info.decoder_flags & LIBRAW_DECODER_OWNALLOC)
       {
         // x3f foveon decoder and DNG float
@@ -234,8 +249,12 @@ int LibRaw::unpack(void)
                 sizeof(imgdata.rawdata.raw_image[0]) >
             INT64(imgdata.rawparams.max_raw_memory_mb) * INT64(1024 * 1024))
           throw LIBRAW_EXCEPTION_TOOBIG;
-        imgdata.rawdata.raw_alloc = malloc(
-            rwidth * (rheight + 8) * sizeof(imgdata.rawdata.raw_image[0]));
+        size_t rsize =
+            rwidth * (rheight + 8) * sizeof(imgdata.rawdata.raw_image[0]);
+        // pixels outside of decoded ROI are zero
+        imgdata.rawdata.raw_alloc =
+            libraw_internal_data.unpacker_data.roi_box[2] ? calloc(rsize, 1)
+                                                          : malloc(rsize);
         imgdata.rawdata.raw_image = (ushort *)imgdata.rawdata.raw_alloc;
         if (!S.raw_pitch)
           S.raw_pitch = S.raw_width * 2; // Bayer case, not set before
@@ -367,3 +386,102 @@ int LibRaw::unpack(void)
     EXCEPTION_HANDLER(LIBRAW_EXCEPTION_IO_CORRUPT);
   }
 }
+
+/* Limits decoding to rawparams.roi plus 2*LIBRAW_ROI_MARGIN (processing
+   crop is aligned down to the CFA period, up to 16 pixels) for decoders
+   able to skip tiles, strips or rows */
+void LibRaw::set_decode_roi()
+{
+  unsigned *box = libraw_internal_data.unpacker_data.roi_box;
+  unsigned *roi = imgdata.rawparams.roi;
+  box[0] = box[1] = box[2] = box[3] = 0;
+  if (!roi[2] || !roi[3] || IO.fuji_width ||
+      !(imgdata.idata.filters || P1.colors == 1))
+    return;
+  if (load_raw != &LibRaw::lossless_dng_load_raw &&
+      load_raw != &LibRaw::packed_dng_load_raw &&
+      load_raw != &LibRaw::unpacked_load_raw &&
+      load_raw != &LibRaw::phase_one_load_raw_c &&
+      load_raw != &LibRaw::fuji_compressed_load_raw)
+    return;
+
+  INT64 m = 2 * LIBRAW_ROI_MARGIN;
+  INT64 top = INT64(S.top_margin) + roi[1];
+  INT64 left = INT64(S.left_margin) + roi[0];
+  INT64 bottom = MIN(top + roi[3] + m, INT64(S.raw_height));
+  INT64 right = MIN(left + roi[2] + m, INT64(S.raw_width));
+  top = MAX(top - m, 0);
+  left = MAX(left - m, 0);
+  if (top >= bottom || left >= right)
+    return; // empty: raw2image_ex() will report bad crop
+  box[0] = unsigned(top);
+  box[1] = unsigned(left);
+  box[2] = unsigned(bottom);
+  box[3] = unsigned(right);
+  /* crop_masked_pixels() measures black on the whole masked area */
+  set_masked_areas();
+}
+
+/* narrows [*row0, *row1) to the rows of decode ROI and masked areas */
+void LibRaw::decode_roi_rows(unsigned *row0, unsigned *row1)
+{
+  unsigned *box = libraw_internal_data.unpacker_data.roi_box;
+  if (!box[2])
+    return;
+  INT64 top = box[0], bottom = box[2];
+  for (int m = 0; m < 8; m++)
+    if (S.mask[m][2] > MAX(S.mask[m][0], 0) &&
+        S.mask[m][3] > MAX(S.mask[m][1], 0))
+    {
+      top = MIN(top, INT64(MAX(S.mask[m][0], 0)));
+      bottom = MAX(bottom, INT64(S.mask[m][2]));
+    }
+  *row0 = unsigned(MAX(INT64(*row0), top));
+  *row1 = unsigned(MIN(INT64(*row1), bottom));
+  if (*row0 > *row1)
+    *row0 = *row1;
+}
+
+/* nonzero if raw area intersects neither decode ROI nor masked areas */
+int LibRaw::decode_roi_skip(unsigned row, unsigned col, unsigned rows,
+                            unsigned cols)
+{
+  unsigned *box = libraw_internal_data.unpacker_data.roi_box;
+  if (!box[2])
+    return 0;
+  if (INT64(row) + rows > box[0] && row < box[2] &&
+      INT64(col) + cols > box[1] && col < box[3])
+    return 0;
+  for (int m = 0; m < 8; m++)
+    if (S.mask[m][2] > MAX(S.mask[m][0], 0) &&
+        S.mask[m][3] > MAX(S.mask[m][1], 0) &&
+        INT64(row) + rows > S.mask[m][0] && INT64(row) < S.mask[m][2] &&
+        INT64(col) + cols > S.mask[m][1] && INT64(col) < S.mask[m][3])
+      return 0;
+  return 1;
+}
+
+/* nonzero if the area raw2image_ex() will process (cropbox, ROI with margin
+   or the whole frame) lies inside the raw window decoded at unpack() */
+int LibRaw::decode_roi_covers()
+{
+  unsigned *box = libraw_internal_data.unpacker_data.roi_box;
+  libraw_image_sizes_t *sz = &imgdata.rawdata.sizes;
+  unsigned crop[4];
+  if (!box[2])
+    return 1;
+  INT64 top = sz->top_margin, left = sz->left_margin;
+  INT64 bottom = top + sz->height, right = left + sz->width;
+  if (process_cropbox(crop))
+  {
+    /* same alignment as in raw2image_ex() */
+    unsigned align = imgdata.idata.filters == 1 ? 16
+                     : imgdata.idata.filters == LIBRAW_XTRANS ? 6 : 1;
+    top += crop[1] / align * align;
+    left += crop[0] / align * align;
+    bottom = MIN(bottom, top + crop[3]);
+    right = MIN(right, left + crop[2]);
+  }
+  return top >= box[0] && left >= box[1] && bottom <= box[2] &&
+         right <= box[3];
+}
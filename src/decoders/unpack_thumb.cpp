@@ -364,3 +364,67 @@ int LibRaw::unpack_thumb(void)
     EXCEPTION_HANDLER(err);
   }
 }
+
+int LibRaw::unpack_thumb_ex(int idx)
+{
+  CHECK_ORDER_LOW(LIBRAW_PROGRESS_IDENTIFY);
+  int ret = select_thumbnail(idx);
+  if (ret != LIBRAW_SUCCESS)
+    return ret;
+  imgdata.progress_flags &= ~LIBRAW_PROGRESS_THUMB_LOAD;
+  return unpack_thumb();
+}
+
+/* JPEG entry bytes, no decoding and no T.thumb allocation */
+int LibRaw::thumb_to_buffer(int idx, void *buffer, size_t bufsize)
+{
+  CHECK_ORDER_LOW(LIBRAW_PROGRESS_IDENTIFY);
+  if (!libraw_internal_data.internal_data.input)
+    return LIBRAW_INPUT_CLOSED;
+  if (idx < 0 || idx >= imgdata.thumbs_list.thumbcount)
+    return LIBRAW_REQUEST_FOR_NONEXISTENT_IMAGE;
+  libraw_thumbnail_item_t &t = imgdata.thumbs_list.thumblist[idx];
+  if (t.tformat != LIBRAW_THUMBNAIL_JPEG || t.tlength < 64)
+    return LIBRAW_UNSUPPORTED_THUMBNAIL;
+  if (!buffer || bufsize < t.tlength)
+    return LIBRAW_BAD_OUTPUT_BUFFER;
+  try
+  {
+    if (t.toffset + INT64(t.tlength) > ID.input->size())
+      throw LIBRAW_EXCEPTION_IO_EOF;
+    ID.input->seek(t.toffset, SEEK_SET);
+    if (ID.input->read(buffer, 1, t.tlength) != int(t.tlength))
+      throw LIBRAW_EXCEPTION_IO_EOF;
+    ((unsigned char *)buffer)[0] = 0xff; // as jpeg_thumb
+    ((unsigned char *)buffer)[1] = 0xd8;
+    return LIBRAW_SUCCESS;
+  }
+  catch (const LibRaw_exceptions& err)
+  {
+    EXCEPTION_HANDLER(err);
+  }
+}
+
+/* JPEG entry bytes in place, if input is memory-backed (open_buffer()):
+   valid until the buffer is released */
+int LibRaw::thumb_direct_data(int idx, const void **data, size_t *size)
+{
+  CHECK_ORDER_LOW(LIBRAW_PROGRESS_IDENTIFY);
+  if (!libraw_internal_data.internal_data.input)
+    return LIBRAW_INPUT_CLOSED;
+  if (!data || !size)
+    return LIBRAW_BAD_OUTPUT_BUFFER;
+  if (idx < 0 || idx >= imgdata.thumbs_list.thumbcount)
+    return LIBRAW_REQUEST_FOR_NONEXISTENT_IMAGE;
+  libraw_thumbnail_item_t &t = imgdata.thumbs_list.thumblist[idx];
+  if (t.tformat != LIBRAW_THUMBNAIL_JPEG || t.tlength < 64)
+    return LIBRAW_UNSUPPORTED_THUMBNAIL;
+  const unsigned char *p =
+      (const unsigned char *)ID.input->mapped(t.toffset, t.tlength);
+  // not mapped, or SOI needs the fix thumb_to_buffer() does
+  if (!p || p[0] != 0xff || p[1] != 0xd8)
+    return LIBRAW_NOT_IMPLEMENTED;
+  *data = p;
+  *size = t.tlength;
+  return LIBRAW_SUCCESS;
+}
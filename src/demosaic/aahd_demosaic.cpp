@@ -352,6 +352,7 @@ void AAHD::evaluate_ahd()
    * Lab */
   for (int i = 0; i < libraw.imgdata.sizes.iheight; ++i)
   {
+    libraw.checkCancel();
     int moff = nr_offset(i + nr_margin, nr_margin);
     for (int j = 0; j < libraw.imgdata.sizes.iwidth; j++, ++moff)
     {
@@ -403,6 +404,7 @@ void AAHD::evaluate_ahd()
   }
   for (int i = 0; i < libraw.imgdata.sizes.iheight; ++i)
   {
+    libraw.checkCancel();
     int moff = nr_offset(i + nr_margin, nr_margin);
     for (int j = 0; j < libraw.imgdata.sizes.iwidth; j++, ++moff)
     {
@@ -695,10 +697,12 @@ void AAHD::make_ahd_rb()
 {
   for (int i = 0; i < libraw.imgdata.sizes.iheight; ++i)
   {
+    libraw.checkCancel();
     make_ahd_rb_hv(i);
   }
   for (int i = 0; i < libraw.imgdata.sizes.iheight; ++i)
   {
+    libraw.checkCancel();
     make_ahd_rb_last(i);
   }
 }
@@ -771,11 +775,16 @@ AAHD::~AAHD() { free(rgb_ahd[0]); }
 void LibRaw::aahd_interpolate()
 {
   AAHD aahd(*this);
+  RUN_CALLBACK(LIBRAW_PROGRESS_INTERPOLATE, 0, 5);
   aahd.hide_hots();
   aahd.make_ahd_greens();
+  RUN_CALLBACK(LIBRAW_PROGRESS_INTERPOLATE, 1, 5);
   aahd.make_ahd_rb();
+  RUN_CALLBACK(LIBRAW_PROGRESS_INTERPOLATE, 2, 5);
   aahd.evaluate_ahd();
+  RUN_CALLBACK(LIBRAW_PROGRESS_INTERPOLATE, 3, 5);
   aahd.refine_hv_dirs();
   //	aahd.illustrate_dirs();
+  RUN_CALLBACK(LIBRAW_PROGRESS_INTERPOLATE, 4, 5);
   aahd.combine_image();
 }
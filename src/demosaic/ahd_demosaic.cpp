@@ -37,7 +37,10 @@ void LibRaw::cielab(ushort rgb[3], short lab[3])
   if (!rgb)
   {
 #ifndef LIBRAW_NOTHREADS
-    if (cbrt[0] < -1.0f)
+    if (!cbrt)
+    {
+      cbrt = (float *)::malloc(0x10000 * sizeof(float));
+      merror(cbrt, "cielab()");
 #endif
       for (i = 0; i < 0x10000; i++)
       {
@@ -45,6 +48,9 @@ void LibRaw::cielab(ushort rgb[3], short lab[3])
         cbrt[i] =
             r > 0.008856 ? pow(r, 1.f / 3.0f) : 7.787f * r + 16.f / 116.0f;
       }
+#ifndef LIBRAW_NOTHREADS
+    }
+#endif
     for (i = 0; i < 3; i++)
       for (j = 0; j < colors; j++)
         for (xyz_cam[i][j] = k = 0; k < 3; k++)
@@ -290,70 +296,86 @@ void LibRaw::ahd_interpolate_combine_homogeneous_pixels(
     }
   }
 }
-void LibRaw::ahd_interpolate()
+struct ahd_task_t
 {
-    int terminate_flag = 0;
-    cielab(0, 0);
-    border_interpolate(5);
-
-#ifdef LIBRAW_USE_OPENMP
-    int buffer_count = omp_get_max_threads();
-#else
-    int buffer_count = 1;
-#endif
+    LibRaw* self;
+    char** buffers;
+    int nchunks;
+    volatile int terminate_flag;
+};
 
-    size_t buffer_size = 26 * LIBRAW_AHD_TILE * LIBRAW_AHD_TILE; /* 1664 kB */
-    char** buffers = malloc_omp_buffers(buffer_count, buffer_size, "ahd_interpolate()");
+void LibRaw::ahd_interpolate_task(void* t, int chunk)
+{
+    ahd_task_t* task = (ahd_task_t*)t;
+    task->self->ahd_interpolate_rows(chunk, task->nchunks, task->buffers[chunk],
+        &task->terminate_flag);
+}
 
-#ifdef LIBRAW_USE_OPENMP
-#pragma omp parallel for schedule(dynamic) default(none) shared(terminate_flag) firstprivate(buffers)
-#endif
-    for (int top = 2; top < height - 5; top += LIBRAW_AHD_TILE - 6)
+/* tile rows chunk, chunk + nchunks, ...; progress is reported by chunk 0 */
+void LibRaw::ahd_interpolate_rows(int chunk, int nchunks, char* buffer,
+    volatile int* terminate_flag)
+{
+    ushort(*rgb)[LIBRAW_AHD_TILE][LIBRAW_AHD_TILE][3];
+    short(*lab)[LIBRAW_AHD_TILE][LIBRAW_AHD_TILE][3];
+    char(*homo)[LIBRAW_AHD_TILE][2];
+
+    rgb = (ushort(*)[LIBRAW_AHD_TILE][LIBRAW_AHD_TILE][3])buffer;
+    lab = (short(*)[LIBRAW_AHD_TILE][LIBRAW_AHD_TILE][3])(
+        buffer + 12 * LIBRAW_AHD_TILE * LIBRAW_AHD_TILE);
+    homo = (char(*)[LIBRAW_AHD_TILE][2])(buffer + 24 * LIBRAW_AHD_TILE *
+        LIBRAW_AHD_TILE);
+
+    int tile_row = 0;
+    for (int top = 2; top < height - 5; top += LIBRAW_AHD_TILE - 6, tile_row++)
     {
-#ifdef LIBRAW_USE_OPENMP
-        if (0 == omp_get_thread_num())
-#endif
-            if (callbacks.progress_cb)
-            {
-                int rr = (*callbacks.progress_cb)(callbacks.progresscb_data,
-                    LIBRAW_PROGRESS_INTERPOLATE,
-                    top - 2, height - 7);
-                if (rr)
-                    terminate_flag = 1;
-            }
-
-#if defined(LIBRAW_USE_OPENMP)
-        char* buffer = buffers[omp_get_thread_num()];
-#else
-        char* buffer = buffers[0];
-#endif
-
-        ushort(*rgb)[LIBRAW_AHD_TILE][LIBRAW_AHD_TILE][3];
-        short(*lab)[LIBRAW_AHD_TILE][LIBRAW_AHD_TILE][3];
-        char(*homo)[LIBRAW_AHD_TILE][2];
-
-        rgb = (ushort(*)[LIBRAW_AHD_TILE][LIBRAW_AHD_TILE][3])buffer;
-        lab = (short(*)[LIBRAW_AHD_TILE][LIBRAW_AHD_TILE][3])(
-            buffer + 12 * LIBRAW_AHD_TILE * LIBRAW_AHD_TILE);
-        homo = (char(*)[LIBRAW_AHD_TILE][2])(buffer + 24 * LIBRAW_AHD_TILE *
-            LIBRAW_AHD_TILE);
+        if (tile_row % nchunks != chunk)
+            continue;
+        if (chunk == 0 && callbacks.progress_cb)
+        {
+            int rr = (*callbacks.progress_cb)(callbacks.progresscb_data,
+                LIBRAW_PROGRESS_INTERPOLATE,
+                top - 2, height - 7);
+            if (rr)
+                *terminate_flag = 1;
+        }
 
-        for (int left = 2; !terminate_flag && (left < width - 5);
+        for (int left = 2; !*terminate_flag && (left < width - 5);
             left += LIBRAW_AHD_TILE - 6)
         {
+            if (cancelRequested())
+                break;
             ahd_interpolate_green_h_and_v(top, left, rgb);
             ahd_interpolate_r_and_b_and_convert_to_cielab(top, left, rgb, lab);
             ahd_interpolate_build_homogeneity_map(top, left, lab, homo);
             ahd_interpolate_combine_homogeneous_pixels(top, left, rgb, homo);
         }
     }
+}
 
-#ifdef LIBRAW_USE_OPENMP
-#pragma omp barrier
-#endif
+void LibRaw::ahd_interpolate()
+{
+    cielab(0, 0);
+    border_interpolate(5);
+
+    int tile_rows = 0;
+    for (int top = 2; top < height - 5; top += LIBRAW_AHD_TILE - 6)
+        tile_rows++;
+    if (tile_rows < 1)
+        return;
+
+    ahd_task_t task;
+    task.self = this;
+    task.nchunks = parallel_width(tile_rows, process_threads());
+    task.terminate_flag = 0;
+
+    size_t buffer_size = 26 * LIBRAW_AHD_TILE * LIBRAW_AHD_TILE; /* 1664 kB */
+    task.buffers = malloc_omp_buffers(task.nchunks, buffer_size, "ahd_interpolate()");
+
+    run_parallel(task.nchunks, task.nchunks, ahd_interpolate_task, &task);
 
-    free_omp_buffers(buffers, buffer_count);
+    free_omp_buffers(task.buffers, task.nchunks);
 
-    if (terminate_flag)
+    checkCancel();
+    if (task.terminate_flag)
         throw LIBRAW_EXCEPTION_CANCELLED_BY_CALLBACK;
 }
\ No newline at end of file
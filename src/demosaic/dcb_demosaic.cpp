@@ -839,7 +839,7 @@ void LibRaw::fbdd(int noiserd)
 void LibRaw::dcb(int iterations, int dcb_enhance)
 {
 
-  int i = 1;
+  int i = 1, passes = MAX(iterations, 0);
 
   float(*image2)[3];
   image2 = (float(*)[3])calloc(width * height, sizeof *image2);
@@ -847,6 +847,7 @@ void LibRaw::dcb(int iterations, int dcb_enhance)
   float(*image3)[3];
   image3 = (float(*)[3])calloc(width * height, sizeof *image3);
 
+  RUN_CALLBACK(LIBRAW_PROGRESS_INTERPOLATE, 0, passes + 3);
   border_interpolate(6);
 
   dcb_hor(image2);
@@ -863,6 +864,7 @@ void LibRaw::dcb(int iterations, int dcb_enhance)
 
   while (i <= iterations)
   {
+    RUN_CALLBACK(LIBRAW_PROGRESS_INTERPOLATE, i, passes + 3);
     dcb_nyquist();
     dcb_nyquist();
     dcb_nyquist();
@@ -871,11 +873,13 @@ void LibRaw::dcb(int iterations, int dcb_enhance)
     i++;
   }
 
+  RUN_CALLBACK(LIBRAW_PROGRESS_INTERPOLATE, passes + 1, passes + 3);
   dcb_color();
   dcb_pp();
 
   dcb_map();
   dcb_correction2();
+  checkCancel();
 
   dcb_map();
   dcb_correction();
@@ -886,10 +890,12 @@ void LibRaw::dcb(int iterations, int dcb_enhance)
   dcb_map();
   dcb_correction();
 
+  checkCancel();
   dcb_map();
   dcb_restore_from_buffer(image2);
   dcb_color();
 
+  RUN_CALLBACK(LIBRAW_PROGRESS_INTERPOLATE, passes + 2, passes + 3);
   if (dcb_enhance)
   {
     dcb_refinement();
@@ -197,6 +197,26 @@ struct DHT
   void make_rb();
   void hide_hots();
   void restore_hots();
+  /* row passes run on LibRaw::run_parallel() */
+  typedef void (DHT::*row_function)(int i);
+  struct row_task_t
+  {
+    DHT *dht;
+    row_function fn;
+  };
+  static void row_task(void *t, int i)
+  {
+    row_task_t *task = (row_task_t *)t;
+    (task->dht->*(task->fn))(i);
+  }
+  void for_rows(row_function fn)
+  {
+    row_task_t task = {this, fn};
+    libraw.run_parallel(libraw.imgdata.sizes.iheight, libraw.process_threads(),
+                        row_task, &task);
+  }
+  void refine_hv_dirs_pass1(int i) { refine_hv_dirs(i, i & 1); }
+  void refine_hv_dirs_pass2(int i) { refine_hv_dirs(i, (i & 1) ^ 1); }
 };
 
 typedef float float3[3];
@@ -259,7 +279,7 @@ void DHT::hide_hots()
 {
   int iwidth = libraw.imgdata.sizes.iwidth;
 #if defined(LIBRAW_USE_OPENMP)
-#pragma omp parallel for schedule(guided) firstprivate(iwidth)
+#pragma omp parallel for schedule(guided) firstprivate(iwidth) num_threads(libraw.process_threads())
 #endif
   for (int i = 0; i < libraw.imgdata.sizes.iheight; ++i)
   {
@@ -399,9 +419,9 @@ void DHT::restore_hots()
   int iwidth = libraw.imgdata.sizes.iwidth;
 #if defined(LIBRAW_USE_OPENMP)
 #ifdef _MSC_VER
-#pragma omp parallel for firstprivate(iwidth)
+#pragma omp parallel for firstprivate(iwidth) num_threads(libraw.process_threads())
 #else
-#pragma omp parallel for schedule(guided) firstprivate(iwidth) collapse(2)
+#pragma omp parallel for schedule(guided) firstprivate(iwidth) collapse(2) num_threads(libraw.process_threads())
 #endif
 #endif
   for (int i = 0; i < libraw.imgdata.sizes.iheight; ++i)
@@ -422,13 +442,7 @@ void DHT::restore_hots()
 
 void DHT::make_diag_dirs()
 {
-#if defined(LIBRAW_USE_OPENMP)
-#pragma omp parallel for schedule(guided)
-#endif
-  for (int i = 0; i < libraw.imgdata.sizes.iheight; ++i)
-  {
-    make_diag_dline(i);
-  }
+  for_rows(&DHT::make_diag_dline);
 //#if defined(LIBRAW_USE_OPENMP)
 //#pragma omp parallel for schedule(guided)
 //#endif
@@ -441,45 +455,15 @@ void DHT::make_diag_dirs()
 //	for (int i = 0; i < libraw.imgdata.sizes.iheight; ++i) {
 //		refine_diag_dirs(i, (i & 1) ^ 1);
 //	}
-#if defined(LIBRAW_USE_OPENMP)
-#pragma omp parallel for schedule(guided)
-#endif
-  for (int i = 0; i < libraw.imgdata.sizes.iheight; ++i)
-  {
-    refine_idiag_dirs(i);
-  }
+  for_rows(&DHT::refine_idiag_dirs);
 }
 
 void DHT::make_hv_dirs()
 {
-#if defined(LIBRAW_USE_OPENMP)
-#pragma omp parallel for schedule(guided)
-#endif
-  for (int i = 0; i < libraw.imgdata.sizes.iheight; ++i)
-  {
-    make_hv_dline(i);
-  }
-#if defined(LIBRAW_USE_OPENMP)
-#pragma omp parallel for schedule(guided)
-#endif
-  for (int i = 0; i < libraw.imgdata.sizes.iheight; ++i)
-  {
-    refine_hv_dirs(i, i & 1);
-  }
-#if defined(LIBRAW_USE_OPENMP)
-#pragma omp parallel for schedule(guided)
-#endif
-  for (int i = 0; i < libraw.imgdata.sizes.iheight; ++i)
-  {
-    refine_hv_dirs(i, (i & 1) ^ 1);
-  }
-#if defined(LIBRAW_USE_OPENMP)
-#pragma omp parallel for schedule(guided)
-#endif
-  for (int i = 0; i < libraw.imgdata.sizes.iheight; ++i)
-  {
-    refine_ihv_dirs(i);
-  }
+  for_rows(&DHT::make_hv_dline);
+  for_rows(&DHT::refine_hv_dirs_pass1);
+  for_rows(&DHT::refine_hv_dirs_pass2);
+  for_rows(&DHT::refine_ihv_dirs);
 }
 
 void DHT::refine_hv_dirs(int i, int js)
@@ -688,13 +672,7 @@ void DHT::refine_idiag_dirs(int i)
  */
 void DHT::make_greens()
 {
-#if defined(LIBRAW_USE_OPENMP)
-#pragma omp parallel for schedule(guided)
-#endif
-  for (int i = 0; i < libraw.imgdata.sizes.iheight; ++i)
-  {
-    make_gline(i);
-  }
+  for_rows(&DHT::make_gline);
 }
 
 void DHT::make_gline(int i)
@@ -764,13 +742,7 @@ void DHT::make_gline(int i)
 
 void DHT::illustrate_dirs()
 {
-#if defined(LIBRAW_USE_OPENMP)
-#pragma omp parallel for schedule(guided)
-#endif
-  for (int i = 0; i < libraw.imgdata.sizes.iheight; ++i)
-  {
-    illustrate_dline(i);
-  }
+  for_rows(&DHT::illustrate_dline);
 }
 
 void DHT::illustrate_dline(int i)
@@ -954,22 +926,8 @@ void DHT::make_rbhv(int i)
 
 void DHT::make_rb()
 {
-#if defined(LIBRAW_USE_OPENMP)
-#pragma omp barrier
-#pragma omp parallel for schedule(guided)
-#endif
-  for (int i = 0; i < libraw.imgdata.sizes.iheight; ++i)
-  {
-    make_rbdiag(i);
-  }
-#if defined(LIBRAW_USE_OPENMP)
-#pragma omp barrier
-#pragma omp parallel for schedule(guided)
-#endif
-  for (int i = 0; i < libraw.imgdata.sizes.iheight; ++i)
-  {
-    make_rbhv(i);
-  }
+  for_rows(&DHT::make_rbdiag);
+  for_rows(&DHT::make_rbhv);
 }
 
 /*
@@ -980,9 +938,9 @@ void DHT::copy_to_image()
   int iwidth = libraw.imgdata.sizes.iwidth;
 #if defined(LIBRAW_USE_OPENMP)
 #ifdef _MSC_VER
-#pragma omp parallel for
+#pragma omp parallel for num_threads(libraw.process_threads())
 #else
-#pragma omp parallel for schedule(guided) collapse(2)
+#pragma omp parallel for schedule(guided) collapse(2) num_threads(libraw.process_threads())
 #endif
 #endif
   for (int i = 0; i < libraw.imgdata.sizes.iheight; ++i)
@@ -1012,13 +970,18 @@ DHT::~DHT()
 void LibRaw::dht_interpolate()
 {
   DHT dht(*this);
+  RUN_CALLBACK(LIBRAW_PROGRESS_INTERPOLATE, 0, 5);
   dht.hide_hots();
   dht.make_hv_dirs();
   //	dht.illustrate_dirs();
+  RUN_CALLBACK(LIBRAW_PROGRESS_INTERPOLATE, 1, 5);
   dht.make_greens();
+  RUN_CALLBACK(LIBRAW_PROGRESS_INTERPOLATE, 2, 5);
   dht.make_diag_dirs();
   //	dht.illustrate_dirs();
+  RUN_CALLBACK(LIBRAW_PROGRESS_INTERPOLATE, 3, 5);
   dht.make_rb();
+  RUN_CALLBACK(LIBRAW_PROGRESS_INTERPOLATE, 4, 5);
   dht.restore_hots();
   dht.copy_to_image();
 }
@@ -22,14 +22,16 @@ void LibRaw::pre_interpolate()
 {
   ushort(*img)[4];
   int row, col, c;
+  int half = half_size || imgdata.params.preview_scale > 1;
   RUN_CALLBACK(LIBRAW_PROGRESS_PRE_INTERPOLATE, 0, 2);
   if (shrink)
   {
-    if (half_size)
+    if (half)
     {
       height = iheight;
       width = iwidth;
-      if (filters == 9)
+      if (filters == 9 &&
+          !libraw_internal_data.internal_output_params.preview_bin)
       {
         for (row = 0; row < 3; row++)
           for (col = 1; col < 4; col++)
@@ -63,8 +65,8 @@ void LibRaw::pre_interpolate()
   }
   if (filters > 1000 && colors == 3)
   {
-    mix_green = four_color_rgb ^ half_size;
-    if (four_color_rgb | half_size)
+    mix_green = four_color_rgb ^ half;
+    if (four_color_rgb | half)
       colors++;
     else
     {
@@ -74,7 +76,7 @@ void LibRaw::pre_interpolate()
       filters &= ~((filters & 0x55555555U) << 1);
     }
   }
-  if (half_size)
+  if (half)
     filters = 0;
   RUN_CALLBACK(LIBRAW_PROGRESS_PRE_INTERPOLATE, 1, 2);
 }
@@ -354,7 +356,8 @@ void LibRaw::ppg_interpolate()
   RUN_CALLBACK(LIBRAW_PROGRESS_INTERPOLATE, 0, 3);
 #ifdef LIBRAW_USE_OPENMP
 #pragma omp parallel for default(shared) private(guess, diff, row, col, d, c,  \
-                                                 i, pix) schedule(static)
+                                                 i, pix) schedule(static)     \
+    num_threads(process_threads())
 #endif
   for (row = 3; row < height - 3; row++)
     for (col = 3 + (FC(row, 3) & 1), c = FC(row, col); col < width - 3;
@@ -381,7 +384,8 @@ void LibRaw::ppg_interpolate()
   RUN_CALLBACK(LIBRAW_PROGRESS_INTERPOLATE, 1, 3);
 #ifdef LIBRAW_USE_OPENMP
 #pragma omp parallel for default(shared) private(guess, diff, row, col, d, c,  \
-                                                 i, pix) schedule(static)
+                                                 i, pix) schedule(static)     \
+    num_threads(process_threads())
 #endif
   for (row = 1; row < height - 1; row++)
     for (col = 1 + (FC(row, 2) & 1), c = FC(row, col + 1); col < width - 1;
@@ -400,7 +404,8 @@ void LibRaw::ppg_interpolate()
   RUN_CALLBACK(LIBRAW_PROGRESS_INTERPOLATE, 2, 3);
 #ifdef LIBRAW_USE_OPENMP
 #pragma omp parallel for default(shared) private(guess, diff, row, col, d, c,  \
-                                                 i, pix) schedule(static)
+                                                 i, pix) schedule(static)     \
+    num_threads(process_threads())
 #endif
   for (row = 1; row < height - 1; row++)
     for (col = 1 + (FC(row, 1) & 1), c = 2 - FC(row, col); col < width - 1;
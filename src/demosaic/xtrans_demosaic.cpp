@@ -166,7 +166,7 @@ void LibRaw::xtrans_interpolate(int passes)
 	  }
 
 #if defined(LIBRAW_USE_OPENMP)
-  int buffer_count = omp_get_max_threads();
+  int buffer_count = process_threads();
 #else
   int buffer_count = 1;
 #endif
@@ -175,7 +175,7 @@ void LibRaw::xtrans_interpolate(int passes)
   char** buffers = malloc_omp_buffers(buffer_count, buffer_size, "xtrans_interpolate()");
 
 #if defined(LIBRAW_USE_OPENMP)
-# pragma omp parallel for schedule(dynamic) default(none) firstprivate(buffers, allhex, passes, sgrow, sgcol, ndir) shared(dir) 
+# pragma omp parallel for schedule(dynamic) default(none) firstprivate(buffers, allhex, passes, sgrow, sgcol, ndir) shared(dir) num_threads(buffer_count)
 #endif
     for (int top = 3; top < height - 19; top += LIBRAW_AHD_TILE - 16)
     {
@@ -200,6 +200,8 @@ void LibRaw::xtrans_interpolate(int passes)
 
         for (int left = 3; left < width - 19; left += LIBRAW_AHD_TILE - 16)
         {
+            if (cancelRequested())
+                break;
             int mrow = MIN(top + LIBRAW_AHD_TILE, height - 3);
             int mcol = MIN(left + LIBRAW_AHD_TILE, width - 3);
             for (int row = top; row < mrow; row++)
@@ -424,6 +426,7 @@ void LibRaw::xtrans_interpolate(int passes)
 #endif
 
     free_omp_buffers(buffers, buffer_count);
+    checkCancel();
 
     border_interpolate(8);
 }
@@ -149,6 +149,29 @@ extern "C"
     LibRaw *ip = (LibRaw *)lr->parent_class;
     return ip->unpack_thumb();
   }
+  int libraw_unpack_thumb_ex(libraw_data_t *lr, int i)
+  {
+    if (!lr)
+      return EINVAL;
+    LibRaw *ip = (LibRaw *)lr->parent_class;
+    return ip->unpack_thumb_ex(i);
+  }
+  int libraw_thumb_to_buffer(libraw_data_t *lr, int i, void *buffer,
+                             size_t bufsize)
+  {
+    if (!lr)
+      return EINVAL;
+    LibRaw *ip = (LibRaw *)lr->parent_class;
+    return ip->thumb_to_buffer(i, buffer, bufsize);
+  }
+  int libraw_thumb_direct_data(libraw_data_t *lr, int i, const void **data,
+                               size_t *size)
+  {
+    if (!lr)
+      return EINVAL;
+    LibRaw *ip = (LibRaw *)lr->parent_class;
+    return ip->thumb_direct_data(i, data, size);
+  }
   void libraw_recycle_datastream(libraw_data_t *lr)
   {
     if (!lr)
@@ -204,6 +227,22 @@ extern "C"
     LibRaw *ip = (LibRaw *)lr->parent_class;
     ip->set_progress_handler(cb, data);
   }
+  void libraw_set_executor(libraw_data_t *lr, libraw_executor_callback cb,
+                           void *data)
+  {
+    if (!lr)
+      return;
+    LibRaw *ip = (LibRaw *)lr->parent_class;
+    ip->set_executor(cb, data);
+  }
+  void libraw_set_async_launcher(libraw_data_t *lr, libraw_async_launcher cb,
+                                 void *data)
+  {
+    if (!lr)
+      return;
+    LibRaw *ip = (LibRaw *)lr->parent_class;
+    ip->set_async_launcher(cb, data);
+  }
   void libraw_set_export_metadata_handler(libraw_data_t *lr,
                                           export_image_metadata_callback cb, void* data)
   {
@@ -259,6 +298,27 @@ extern "C"
     LibRaw *ip = (LibRaw *)lr->parent_class;
     return ip->dcraw_process();
   }
+  int libraw_begin_render_session(libraw_data_t *lr)
+  {
+    if (!lr)
+      return EINVAL;
+    LibRaw *ip = (LibRaw *)lr->parent_class;
+    return ip->begin_render_session();
+  }
+  void libraw_end_render_session(libraw_data_t *lr)
+  {
+    if (!lr)
+      return;
+    LibRaw *ip = (LibRaw *)lr->parent_class;
+    ip->end_render_session();
+  }
+  int libraw_set_output_buffer(libraw_data_t *lr, libraw_output_buffer_t *buf)
+  {
+    if (!lr)
+      return EINVAL;
+    LibRaw *ip = (LibRaw *)lr->parent_class;
+    return ip->set_output_buffer(buf);
+  }
   libraw_processed_image_t *libraw_dcraw_make_mem_image(libraw_data_t *lr,
                                                         int *errc)
   {
@@ -459,6 +519,135 @@ extern "C"
     return lr->color.maximum;
   }
 
+  /* batch processing */
+  libraw_batch_t *libraw_batch_init(unsigned int flags)
+  {
+    LibRaw_batch *ret;
+    try
+    {
+      ret = new LibRaw_batch(flags);
+    }
+    catch (const std::bad_alloc& )
+    {
+      return NULL;
+    }
+    return (libraw_batch_t *)ret;
+  }
+  libraw_output_params_t *libraw_batch_params(libraw_batch_t *b)
+  {
+    if (!b)
+      return NULL;
+    return &((LibRaw_batch *)b)->params;
+  }
+  libraw_raw_unpack_params_t *libraw_batch_rawparams(libraw_batch_t *b)
+  {
+    if (!b)
+      return NULL;
+    return &((LibRaw_batch *)b)->rawparams;
+  }
+  void libraw_batch_set_options(libraw_batch_t *b, unsigned stages,
+                                int workers, int threads)
+  {
+    if (!b)
+      return;
+    LibRaw_batch *ip = (LibRaw_batch *)b;
+    ip->stages = stages;
+    ip->workers = workers;
+    ip->threads = threads;
+  }
+  void libraw_batch_set_callback(libraw_batch_t *b, libraw_batch_callback cb,
+                                 void *data)
+  {
+    if (!b)
+      return;
+    ((LibRaw_batch *)b)->set_callback(cb, data);
+  }
+  int libraw_batch_add(libraw_batch_t *b, const char *input,
+                       const char *output)
+  {
+    if (!b)
+      return EINVAL;
+    return ((LibRaw_batch *)b)->add(input, output);
+  }
+  int libraw_batch_run(libraw_batch_t *b)
+  {
+    if (!b)
+      return EINVAL;
+    return ((LibRaw_batch *)b)->run();
+  }
+  int libraw_batch_count(libraw_batch_t *b)
+  {
+    if (!b)
+      return 0;
+    return ((LibRaw_batch *)b)->count();
+  }
+  const libraw_batch_result_t *libraw_batch_result(libraw_batch_t *b,
+                                                   int index)
+  {
+    if (!b)
+      return NULL;
+    return ((LibRaw_batch *)b)->result(index);
+  }
+  void libraw_batch_cancel(libraw_batch_t *b)
+  {
+    if (!b)
+      return;
+    ((LibRaw_batch *)b)->cancel();
+  }
+  void libraw_batch_close(libraw_batch_t *b)
+  {
+    delete (LibRaw_batch *)b;
+  }
+
+  libraw_async_t *libraw_start_async(libraw_data_t *lr, unsigned stages)
+  {
+    if (!lr)
+      return NULL;
+    LibRaw *ip = (LibRaw *)lr->parent_class;
+    return (libraw_async_t *)ip->start_async(stages);
+  }
+
+  libraw_async_t *libraw_unpack_async(libraw_data_t *lr)
+  {
+    return libraw_start_async(lr, LIBRAW_ASYNC_UNPACK);
+  }
+
+  libraw_async_t *libraw_dcraw_process_async(libraw_data_t *lr)
+  {
+    return libraw_start_async(lr, LIBRAW_ASYNC_PROCESS);
+  }
+
+  int libraw_async_wait(libraw_async_t *a, int msec)
+  {
+    if (!a)
+      return 1;
+    return ((LibRaw_async *)a)->wait(msec);
+  }
+
+  int libraw_async_result(libraw_async_t *a)
+  {
+    if (!a)
+      return EINVAL;
+    return ((LibRaw_async *)a)->result();
+  }
+
+  void libraw_async_cancel(libraw_async_t *a)
+  {
+    if (a)
+      ((LibRaw_async *)a)->cancel();
+  }
+
+  void libraw_async_status(libraw_async_t *a, libraw_async_status_t *st)
+  {
+    if (a)
+      ((LibRaw_async *)a)->status(st);
+  }
+
+  void libraw_async_close(libraw_async_t *a)
+  {
+    delete (LibRaw_async *)a;
+  }
+
 #ifdef __cplusplus
 }
 #endif
@@ -27,6 +27,7 @@
 #include "libraw/libraw_types.h"
 #include "libraw/libraw_datastream.h"
 #include <sys/stat.h>
+#include <algorithm>
 #ifdef USE_JASPER
 #include <jasper/jasper.h> /* Decode RED camera movies */
 #else
@@ -420,6 +421,13 @@ INT64 LibRaw_buffer_datastream::tell()
   return INT64(streampos);
 }
 
+const void *LibRaw_buffer_datastream::mapped(INT64 offset, INT64 length)
+{
+  if (offset < 0 || length < 0 || offset + length > INT64(streamsize))
+    return NULL;
+  return buf + offset;
+}
+
 char *LibRaw_buffer_datastream::gets(char *s, int sz)
 {
   if(sz<1) return NULL;
@@ -653,6 +661,768 @@ void *LibRaw_bigfile_datastream::make_jas_stream()
 }
 #endif
 
+// == LibRaw_prefetch_datastream
+LibRaw_prefetch_datastream::LibRaw_prefetch_datastream(
+    LibRaw_abstract_datastream *p, int bsize, int mblocks, int hsize)
+    : parent(p), _fsize(0), _fpos(0), blocksize(bsize > 0 ? bsize : 0x10000),
+      maxblocks(mblocks > 0 ? mblocks : 1), headsize(hsize > 0 ? hsize : 0),
+      usecount(0), preads(0)
+{
+  if (parent && parent->valid())
+  {
+    _fsize = parent->size();
+    _fpos = parent->tell();
+  }
+  blocks.reserve(maxblocks);
+}
+
+LibRaw_prefetch_datastream::~LibRaw_prefetch_datastream() {}
+
+int LibRaw_prefetch_datastream::valid()
+{
+  return parent ? parent->valid() : 0;
+}
+
+LibRaw_prefetch_datastream::cache_block *
+LibRaw_prefetch_datastream::find_block(INT64 off)
+{
+  for (size_t i = 0; i < blocks.size(); i++)
+    if (off >= blocks[i].start &&
+        off < blocks[i].start + INT64(blocks[i].data.size()))
+    {
+      blocks[i].lastuse = ++usecount;
+      return &blocks[i];
+    }
+  return NULL;
+}
+
+LibRaw_prefetch_datastream::cache_block *
+LibRaw_prefetch_datastream::load_block(INT64 off)
+{
+  if (off < 0 || off >= _fsize)
+    return NULL;
+  /* first access to the file head reads all of it at once, other blocks
+     are aligned to blocksize */
+  INT64 start = off < headsize ? 0 : off - off % blocksize;
+  INT64 len = off < headsize ? headsize : blocksize;
+  if (len > _fsize - start)
+    len = _fsize - start;
+
+  cache_block *b;
+  if (int(blocks.size()) < maxblocks)
+  {
+    blocks.push_back(cache_block());
+    b = &blocks.back();
+  }
+  else
+  {
+    b = &blocks[0];
+    for (size_t i = 1; i < blocks.size(); i++)
+      if (blocks[i].lastuse < b->lastuse)
+        b = &blocks[i];
+  }
+  b->start = start;
+  b->data.resize(size_t(len));
+  parent->seek(start, SEEK_SET);
+  preads++;
+  int got = parent->read(b->data.data(), 1, size_t(len));
+  b->data.resize(got > 0 ? got : 0);
+  b->lastuse = ++usecount;
+  if (off >= start + INT64(b->data.size()))
+    return NULL;
+  return b;
+}
+
+int LibRaw_prefetch_datastream::read(void *ptr, size_t sz, size_t nmemb)
+{
+  if (_fpos >= _fsize)
+    return 0;
+  size_t to_read = sz * nmemb;
+  if (INT64(to_read) > _fsize - _fpos)
+    to_read = size_t(_fsize - _fpos);
+  unsigned char *out = (unsigned char *)ptr;
+  size_t done = 0;
+  while (done < to_read)
+  {
+    size_t rest = to_read - done;
+    cache_block *b = find_block(_fpos);
+    if (!b && rest >= size_t(blocksize))
+    {
+      /* large read: pass through */
+      parent->seek(_fpos, SEEK_SET);
+      preads++;
+      int got = parent->read(out + done, 1, rest);
+      if (got > 0)
+      {
+        done += got;
+        _fpos += got;
+      }
+      break;
+    }
+    if (!b && !(b = load_block(_fpos)))
+      break;
+    size_t boff = size_t(_fpos - b->start);
+    size_t n = b->data.size() - boff;
+    if (n > rest)
+      n = rest;
+    memmove(out + done, b->data.data() + boff, n);
+    done += n;
+    _fpos += n;
+  }
+  return int((done + sz - 1) / (sz > 0 ? sz : 1));
+}
+
+int LibRaw_prefetch_datastream::seek(INT64 o, int whence)
+{
+  switch (whence)
+  {
+  case SEEK_SET:
+    _fpos = o;
+    break;
+  case SEEK_CUR:
+    _fpos += o;
+    break;
+  case SEEK_END:
+    _fpos = _fsize + o;
+    break;
+  default:
+    return 0;
+  }
+  if (_fpos < 0)
+    _fpos = 0;
+  else if (_fpos > _fsize)
+    _fpos = _fsize;
+  return 0;
+}
+
+INT64 LibRaw_prefetch_datastream::tell() { return _fpos; }
+
+int LibRaw_prefetch_datastream::eof() { return _fpos >= _fsize; }
+
+int LibRaw_prefetch_datastream::get_char()
+{
+  cache_block *b = find_block(_fpos);
+  if (!b && !(b = load_block(_fpos)))
+    return -1;
+  return b->data[size_t(_fpos++ - b->start)];
+}
+
+char *LibRaw_prefetch_datastream::gets(char *s, int sz)
+{
+  if (sz < 1 || _fpos >= _fsize)
+    return NULL;
+  int i = 0;
+  while (i < sz - 1)
+  {
+    int c = get_char();
+    if (c < 0)
+      break;
+    s[i++] = c;
+    if (c == '\n')
+      break;
+  }
+  s[i] = 0;
+  return s;
+}
+
+int LibRaw_prefetch_datastream::scanf_one(const char *fmt, void *val)
+{
+  /* same as LibRaw_buffer_datastream::scanf_one() on a short window */
+  char str[64];
+  INT64 start = _fpos;
+  int len = read(str, 1, sizeof(str) - 1);
+  str[len > 0 ? len : 0] = 0;
+  _fpos = start;
+  int scanf_res;
+#ifndef WIN32SECURECALLS
+  scanf_res = sscanf(str, fmt, val);
+#else
+  scanf_res = sscanf_s(str, fmt, val);
+#endif
+  if (scanf_res > 0)
+  {
+    int xcnt = 0;
+    while (_fpos < _fsize)
+    {
+      _fpos++;
+      xcnt++;
+      if (xcnt >= len || str[xcnt] == 0 || str[xcnt] == ' ' ||
+          str[xcnt] == '\t' || str[xcnt] == '\n' || xcnt > 24)
+        break;
+    }
+  }
+  return scanf_res;
+}
+
+const char *LibRaw_prefetch_datastream::fname()
+{
+  return parent ? parent->fname() : NULL;
+}
+
+#ifdef LIBRAW_WIN32_UNICODEPATHS
+const wchar_t *LibRaw_prefetch_datastream::wfname()
+{
+  return parent ? parent->wfname() : NULL;
+}
+#endif
+
+#ifdef LIBRAW_OLD_VIDEO_SUPPORT
+void *LibRaw_prefetch_datastream::make_jas_stream()
+{
+  parent->seek(_fpos, SEEK_SET);
+  return parent->make_jas_stream();
+}
+#endif
+
+// == LibRaw_tracing_datastream
+
+LibRaw_tracing_datastream::LibRaw_tracing_datastream(
+    LibRaw_abstract_datastream *p)
+    : parent(p), curstage(0)
+{
+  stages.push_back("unnamed");
+}
+
+void LibRaw_tracing_datastream::set_stage(const char *name)
+{
+  std::string n(name ? name : "unnamed");
+  for (size_t i = 0; i < stages.size(); i++)
+    if (stages[i] == n)
+    {
+      curstage = int(i);
+      return;
+    }
+  stages.push_back(n);
+  curstage = int(stages.size()) - 1;
+}
+
+const char *LibRaw_tracing_datastream::stage_name(int stage)
+{
+  if (stage < 0 || stage >= int(stages.size()))
+    return "all";
+  return stages[stage].c_str();
+}
+
+void LibRaw_tracing_datastream::clear()
+{
+  trace.clear();
+  stages.resize(1);
+  curstage = 0;
+}
+
+void LibRaw_tracing_datastream::record(int type, INT64 offset, INT64 length)
+{
+  trace_event ev;
+  ev.offset = offset;
+  ev.length = length;
+  ev.stage = curstage;
+  ev.type = type;
+  trace.push_back(ev);
+}
+
+int LibRaw_tracing_datastream::read(void *ptr, size_t sz, size_t nmemb)
+{
+  INT64 off = parent->tell();
+  int ret = parent->read(ptr, sz, nmemb);
+  INT64 len = parent->tell() - off;
+  if (len > 0)
+    record(TRACE_READ, off, len);
+  return ret;
+}
+
+int LibRaw_tracing_datastream::seek(INT64 o, int whence)
+{
+  INT64 before = parent->tell();
+  int ret = parent->seek(o, whence);
+  INT64 after = parent->tell();
+  if (after != before)
+    record(TRACE_SEEK, after, 0);
+  return ret;
+}
+
+int LibRaw_tracing_datastream::get_char()
+{
+  INT64 off = parent->tell();
+  int c = parent->get_char();
+  if (c < 0)
+    return c;
+  /* byte-by-byte parsing: extend current run instead of new event */
+  if (!trace.empty())
+  {
+    trace_event &last = trace.back();
+    if (last.type == TRACE_READ && last.stage == curstage &&
+        last.offset + last.length == off)
+    {
+      last.length++;
+      return c;
+    }
+  }
+  record(TRACE_READ, off, 1);
+  return c;
+}
+
+char *LibRaw_tracing_datastream::gets(char *str, int sz)
+{
+  INT64 off = parent->tell();
+  char *ret = parent->gets(str, sz);
+  INT64 len = parent->tell() - off;
+  if (len > 0)
+    record(TRACE_READ, off, len);
+  return ret;
+}
+
+int LibRaw_tracing_datastream::scanf_one(const char *fmt, void *val)
+{
+  INT64 off = parent->tell();
+  int ret = parent->scanf_one(fmt, val);
+  INT64 len = parent->tell() - off;
+  if (len > 0)
+    record(TRACE_READ, off, len);
+  return ret;
+}
+
+/* libjpeg reads from parent directly: only the start offset is known */
+int LibRaw_tracing_datastream::jpeg_src(void *jpegdata)
+{
+  INT64 off = parent->tell();
+  int ret = parent->jpeg_src(jpegdata);
+  if (ret == 0)
+    record(TRACE_JPEG_SRC, off, 0);
+  return ret;
+}
+
+/* caller reads mapped range directly */
+const void *LibRaw_tracing_datastream::mapped(INT64 offset, INT64 length)
+{
+  const void *p = parent->mapped(offset, length);
+  if (p && length > 0)
+    record(TRACE_READ, offset, length);
+  return p;
+}
+
+std::vector<std::pair<INT64, INT64> >
+LibRaw_tracing_datastream::read_spans(int stage)
+{
+  std::vector<std::pair<INT64, INT64> > r, merged;
+  for (size_t i = 0; i < trace.size(); i++)
+    if (trace[i].type == TRACE_READ && (stage < 0 || trace[i].stage == stage))
+      r.push_back(std::make_pair(trace[i].offset,
+                                 trace[i].offset + trace[i].length));
+  std::sort(r.begin(), r.end());
+  for (size_t i = 0; i < r.size(); i++)
+  {
+    if (!merged.empty() && r[i].first <= merged.back().second)
+    {
+      if (r[i].second > merged.back().second)
+        merged.back().second = r[i].second;
+    }
+    else
+      merged.push_back(r[i]);
+  }
+  return merged;
+}
+
+LibRaw_tracing_datastream::trace_summary
+LibRaw_tracing_datastream::summary(int stage)
+{
+  trace_summary s;
+  memset(&s, 0, sizeof(s));
+  for (size_t i = 0; i < trace.size(); i++)
+  {
+    if (stage >= 0 && trace[i].stage != stage)
+      continue;
+    if (trace[i].type == TRACE_READ)
+    {
+      s.reads++;
+      s.bytes_read += trace[i].length;
+    }
+    else if (trace[i].type == TRACE_JPEG_SRC)
+      s.jpeg_srcs++;
+    else
+      s.seeks++;
+  }
+  std::vector<std::pair<INT64, INT64> > sp = read_spans(stage);
+  s.spans = unsigned(sp.size());
+  for (size_t i = 0; i < sp.size(); i++)
+    s.unique_bytes += sp[i].second - sp[i].first;
+  return s;
+}
+
+void LibRaw_tracing_datastream::print_summary(FILE *out, int verbose)
+{
+  INT64 fsize = size();
+  const char *fn = fname();
+  fprintf(out, "%s: %lld bytes\n", fn ? fn : "(stream)", (long long)fsize);
+  fprintf(out, "%-12s %8s %8s %8s %12s %12s %7s %7s\n", "stage", "reads",
+          "seeks", "spans", "bytes read", "unique", "%file", "ampl");
+  for (int st = 0; st <= int(stages.size()); st++)
+  {
+    int stage = st < int(stages.size()) ? st : -1;
+    trace_summary s = summary(stage);
+    if (stage >= 0 && !s.reads && !s.seeks && !s.jpeg_srcs)
+      continue;
+    fprintf(out, "%-12s %8u %8u %8u %12lld %12lld %6.2f%% %7.2f\n",
+            stage_name(stage), s.reads, s.seeks, s.spans,
+            (long long)s.bytes_read, (long long)s.unique_bytes,
+            fsize > 0 ? 100.0 * double(s.unique_bytes) / double(fsize) : 0.0,
+            s.unique_bytes > 0 ? double(s.bytes_read) / double(s.unique_bytes)
+                               : 0.0);
+    if (s.jpeg_srcs)
+      fprintf(out, "\t%u jpeg_src() calls: data read by libjpeg not counted\n",
+              s.jpeg_srcs);
+    if (verbose && stage >= 0)
+    {
+      std::vector<std::pair<INT64, INT64> > sp = read_spans(stage);
+      for (size_t i = 0; i < sp.size(); i++)
+        fprintf(out, "\t[%lld - %lld) %lld bytes\n", (long long)sp[i].first,
+                (long long)sp[i].second,
+                (long long)(sp[i].second - sp[i].first));
+    }
+  }
+}
+
+// == LibRaw_range_datastream
+
+LibRaw_range_datastream::LibRaw_range_datastream(libraw_range_read_callback cb,
+                                                 void *data, INT64 fsize,
+                                                 const char *fn, int bsize,
+                                                 int mblocks)
+    : callback(cb), cbdata(data), name(fn ? fn : ""), lastblock(NULL),
+      lastbno(-1), _fsize(fsize > 0 ? fsize : 0), _fpos(0),
+      blocksize(bsize > 0 ? bsize : 0x10000),
+      maxblocks(mblocks > 1 ? mblocks : 2), ra_min(1), ra_max(16),
+      ra_window(1), ra_next(-1), pending_next(0), usecount(0), fetches(0),
+      fetched(0)
+{
+}
+
+LibRaw_range_datastream::~LibRaw_range_datastream() {}
+
+int LibRaw_range_datastream::valid() { return callback && _fsize > 0; }
+
+void LibRaw_range_datastream::set_read_ahead(int minblocks, int mblocks)
+{
+  ra_min = minblocks > 0 ? minblocks : 1;
+  ra_max = mblocks > ra_min ? mblocks : ra_min;
+  if (ra_max > maxblocks / 2)
+    ra_max = maxblocks / 2 > ra_min ? maxblocks / 2 : ra_min;
+  ra_window = ra_min;
+}
+
+INT64 LibRaw_range_datastream::fetch(INT64 offset, INT64 length, void *buf)
+{
+  if (offset >= _fsize || length < 1)
+    return 0;
+  if (length > _fsize - offset)
+    length = _fsize - offset;
+  INT64 got = callback(cbdata, offset, length, buf);
+#ifdef LIBRAW_USE_OPENMP
+#pragma omp atomic
+#endif
+  fetches++;
+  if (got > 0)
+  {
+#ifdef LIBRAW_USE_OPENMP
+#pragma omp atomic
+#endif
+    fetched += got;
+  }
+  return got;
+}
+
+LibRaw_range_datastream::cache_block *
+LibRaw_range_datastream::find_block(INT64 bno)
+{
+  if (bno != lastbno || !lastblock)
+  {
+    std::map<INT64, cache_block>::iterator it = blocks.find(bno);
+    if (it == blocks.end())
+      return NULL;
+    lastbno = bno;
+    lastblock = &it->second;
+  }
+  lastblock->lastuse = ++usecount;
+  return lastblock;
+}
+
+void LibRaw_range_datastream::evict()
+{
+  while (int(blocks.size()) > maxblocks)
+  {
+    std::map<INT64, cache_block>::iterator lru = blocks.begin();
+    for (std::map<INT64, cache_block>::iterator it = blocks.begin();
+         it != blocks.end(); ++it)
+      if (it->second.lastuse < lru->second.lastuse)
+        lru = it;
+    if (lru->first == lastbno)
+      lastblock = NULL;
+    blocks.erase(lru);
+  }
+}
+
+void LibRaw_range_datastream::fetch_runs(std::vector<fetch_run> &runs)
+{
+  if (runs.empty())
+    return;
+  std::vector<std::vector<unsigned char> > bufs(runs.size());
+  std::vector<INT64> got(runs.size(), 0);
+  /* one request per run; runs are independent, so fetch them concurrently */
+#ifdef LIBRAW_USE_OPENMP
+#pragma omp parallel for schedule(dynamic) if (runs.size() > 1)
+#endif
+  for (int i = 0; i < int(runs.size()); i++)
+  {
+    INT64 off = runs[i].first * blocksize;
+    INT64 len = INT64(runs[i].count) * blocksize;
+    if (len > _fsize - off)
+      len = _fsize - off;
+    try
+    {
+      bufs[i].resize(size_t(len));
+      got[i] = fetch(off, len, bufs[i].data());
+    }
+    catch (...)
+    {
+      got[i] = -1;
+    }
+  }
+  for (size_t i = 0; i < runs.size(); i++)
+  {
+    if (got[i] < 1)
+      continue;
+    for (int k = 0; k < runs[i].count; k++)
+    {
+      INT64 boff = INT64(k) * blocksize;
+      if (boff >= got[i])
+        break;
+      INT64 n = got[i] - boff;
+      if (n > blocksize)
+        n = blocksize;
+      cache_block &b = blocks[runs[i].first + k];
+      b.data.assign(bufs[i].begin() + size_t(boff),
+                    bufs[i].begin() + size_t(boff + n));
+      b.lastuse = ++usecount;
+    }
+  }
+  lastblock = NULL;
+  evict();
+}
+
+void LibRaw_range_datastream::read_ahead(int count, const INT64 *offsets,
+                                         const INT64 *lengths)
+{
+  pending.clear();
+  pending_next = 0;
+  if (count < 1 || !offsets || !lengths)
+    return;
+  for (int i = 0; i < count; i++)
+    if (offsets[i] >= 0 && offsets[i] < _fsize && lengths[i] > 0)
+      pending.push_back(std::make_pair(offsets[i], lengths[i] < _fsize - offsets[i]
+                                                       ? offsets[i] + lengths[i]
+                                                       : _fsize));
+  fetch_pending(0);
+}
+
+void LibRaw_range_datastream::fetch_pending(size_t from)
+{
+  /* next batch of hinted ranges: up to half of cache, so batch does not
+     evict itself */
+  std::vector<INT64> need;
+  size_t i;
+  for (i = from; i < pending.size() && int(need.size()) < maxblocks / 2; i++)
+    for (INT64 bno = pending[i].first / blocksize;
+         bno * blocksize < pending[i].second; bno++)
+      if (blocks.find(bno) == blocks.end())
+        need.push_back(bno);
+  pending_next = i;
+  std::sort(need.begin(), need.end());
+  need.erase(std::unique(need.begin(), need.end()), need.end());
+
+  /* coalesce adjacent blocks, but keep runs short enough for concurrency */
+  std::vector<fetch_run> runs;
+  for (size_t k = 0; k < need.size(); k++)
+  {
+    if (!runs.empty() && runs.back().first + runs.back().count == need[k] &&
+        runs.back().count < ra_max)
+      runs.back().count++;
+    else
+    {
+      fetch_run r;
+      r.first = need[k];
+      r.count = 1;
+      runs.push_back(r);
+    }
+  }
+  fetch_runs(runs);
+}
+
+LibRaw_range_datastream::cache_block *
+LibRaw_range_datastream::load_block(INT64 bno)
+{
+  INT64 off = bno * blocksize;
+  if (off < 0 || off >= _fsize)
+    return NULL;
+
+  /* miss inside not yet fetched hinted range: fetch next batch */
+  for (size_t i = pending_next; i < pending.size(); i++)
+    if (off >= pending[i].first - pending[i].first % blocksize &&
+        off < pending[i].second)
+    {
+      fetch_pending(i);
+      if (cache_block *b = find_block(bno))
+        return b;
+      break;
+    }
+
+  /* sequential access grows read-ahead window, random access resets it */
+  if (bno == ra_next)
+    ra_window = ra_window * 2 < ra_max ? ra_window * 2 : ra_max;
+  else
+    ra_window = ra_min;
+  fetch_run r;
+  r.first = bno;
+  r.count = 1;
+  while (r.count < ra_window && (bno + r.count) * blocksize < _fsize &&
+         blocks.find(bno + r.count) == blocks.end())
+    r.count++;
+  ra_next = bno + r.count;
+  std::vector<fetch_run> runs(1, r);
+  fetch_runs(runs);
+  return find_block(bno);
+}
+
+int LibRaw_range_datastream::read(void *ptr, size_t sz, size_t nmemb)
+{
+  if (_fpos >= _fsize)
+    return 0;
+  size_t to_read = sz * nmemb;
+  if (INT64(to_read) > _fsize - _fpos)
+    to_read = size_t(_fsize - _fpos);
+  unsigned char *out = (unsigned char *)ptr;
+  size_t done = 0;
+  while (done < to_read)
+  {
+    size_t rest = to_read - done;
+    INT64 bno = _fpos / blocksize;
+    cache_block *b = find_block(bno);
+    if (!b && rest >= size_t(blocksize) * 2 && pending_next >= pending.size())
+    {
+      /* large read of not cached data: fetch directly, up to next cached
+         block */
+      INT64 end = _fpos + INT64(rest);
+      INT64 nb = bno + 1;
+      while (nb * blocksize < end && blocks.find(nb) == blocks.end())
+        nb++;
+      INT64 len = (nb * blocksize < end ? nb * blocksize : end) - _fpos;
+      INT64 got = fetch(_fpos, len, out + done);
+      if (got < 1)
+        break;
+      done += size_t(got);
+      _fpos += got;
+      if (got < len)
+        break;
+      continue;
+    }
+    if (!b && !(b = load_block(bno)))
+      break;
+    size_t boff = size_t(_fpos - bno * blocksize);
+    if (boff >= b->data.size())
+      break;
+    size_t n = b->data.size() - boff;
+    if (n > rest)
+      n = rest;
+    memmove(out + done, b->data.data() + boff, n);
+    done += n;
+    _fpos += n;
+  }
+  return int((done + sz - 1) / (sz > 0 ? sz : 1));
+}
+
+int LibRaw_range_datastream::seek(INT64 o, int whence)
+{
+  switch (whence)
+  {
+  case SEEK_SET:
+    _fpos = o;
+    break;
+  case SEEK_CUR:
+    _fpos += o;
+    break;
+  case SEEK_END:
+    _fpos = _fsize + o;
+    break;
+  default:
+    return 0;
+  }
+  if (_fpos < 0)
+    _fpos = 0;
+  else if (_fpos > _fsize)
+    _fpos = _fsize;
+  return 0;
+}
+
+int LibRaw_range_datastream::get_char()
+{
+  if (_fpos >= _fsize)
+    return -1;
+  INT64 bno = _fpos / blocksize;
+  cache_block *b = find_block(bno);
+  if (!b && !(b = load_block(bno)))
+    return -1;
+  size_t boff = size_t(_fpos - bno * blocksize);
+  if (boff >= b->data.size())
+    return -1;
+  _fpos++;
+  return b->data[boff];
+}
+
+char *LibRaw_range_datastream::gets(char *s, int sz)
+{
+  if (sz < 1 || _fpos >= _fsize)
+    return NULL;
+  int i = 0;
+  while (i < sz - 1)
+  {
+    int c = get_char();
+    if (c < 0)
+      break;
+    s[i++] = c;
+    if (c == '\n')
+      break;
+  }
+  s[i] = 0;
+  return s;
+}
+
+int LibRaw_range_datastream::scanf_one(const char *fmt, void *val)
+{
+  /* same as LibRaw_prefetch_datastream::scanf_one() */
+  char str[64];
+  INT64 start = _fpos;
+  int len = read(str, 1, sizeof(str) - 1);
+  str[len > 0 ? len : 0] = 0;
+  _fpos = start;
+  int scanf_res;
+#ifndef WIN32SECURECALLS
+  scanf_res = sscanf(str, fmt, val);
+#else
+  scanf_res = sscanf_s(str, fmt, val);
+#endif
+  if (scanf_res > 0)
+  {
+    int xcnt = 0;
+    while (_fpos < _fsize)
+    {
+      _fpos++;
+      xcnt++;
+      if (xcnt >= len || str[xcnt] == 0 || str[xcnt] == ' ' ||
+          str[xcnt] == '\t' || str[xcnt] == '\n' || xcnt > 24)
+        break;
+    }
+  }
+  return scanf_res;
+}
+
 // == LibRaw_windows_datastream
 #ifdef LIBRAW_WIN32_CALLS
 
@@ -179,7 +179,7 @@ void LibRaw::fixupArri()
 void LibRaw::identify()
 {
   // clang-format off
-  static const ushort canon[][11] = {
+  static const ushort canon[][11] = { // keep sorted, binary searched
       // raw_width, raw_height, left_margin, top_margin, width_decrement,
       // height_decrement, mask01, mask03, mask11,
 	  // mask13, CFA_filters.
@@ -395,8 +395,8 @@ void LibRaw::identify()
 	  { 2818048, 1376, 1024, 0, 0, 1, 0, 97, 0x49, 0, 0, "Sony", "XCD-SX910CR" },
   };
 
-  libraw_custom_camera_t
-      table[64 + sizeof(const_table) / sizeof(const_table[0])];
+  libraw_custom_camera_t table[64];
+  const libraw_custom_camera_t *cam = NULL;
 
 
   // clang-format on
@@ -407,9 +407,6 @@ void LibRaw::identify()
 
   unsigned camera_count =
       parse_custom_cameras(64, table, imgdata.rawparams.custom_camera_strings);
-  for (int q = 0; q < int(sizeof(const_table) / sizeof(const_table[0])); q++)
-    memmove(&table[q + camera_count], &const_table[q], sizeof(const_table[0]));
-  camera_count += sizeof(const_table) / sizeof(const_table[0]);
 
   tiff_flip = flip = filters = UINT_MAX; /* unknown */
   raw_height = raw_width = fuji_width = fuji_layout = cr2_slice[0] = 0;
@@ -704,63 +701,71 @@ void LibRaw::identify()
   }
 
   if (make[0] == 0)
-    for (zero_fsize = i = 0; i < (int)camera_count; i++)
+  {
+    /* user-supplied cameras first, then built-in ones */
+    for (zero_fsize = i = 0; i < (int)camera_count && !cam; i++)
       if (fsize == (int)table[i].fsize)
+        cam = &table[i];
+    for (i = 0; i < int(sizeof(const_table) / sizeof(const_table[0])) && !cam;
+         i++)
+      if (fsize == (int)const_table[i].fsize)
+        cam = &const_table[i];
+  }
+  if (cam)
+  {
+    strcpy(make, cam->t_make);
+    strcpy(model, cam->t_model);
+    flip = cam->flags >> 2;
+    zero_is_bad = cam->flags & 2;
+    data_offset = cam->offset == 0xffff ? 0 : cam->offset;
+    raw_width = cam->rw;
+    raw_height = cam->rh;
+    left_margin = cam->lm;
+    top_margin = cam->tm;
+    width = raw_width - left_margin - cam->rm;
+    height = raw_height - top_margin - cam->bm;
+    filters = 0x1010101U * cam->cf;
+    colors = 4 - !((filters & filters >> 1) & 0x5555);
+    load_flags = cam->lf & 0xff;
+    if (cam->lf & 0x100) /* Monochrome sensor dump */
+    {
+      colors = 1;
+      filters = 0;
+    }
+    switch (tiff_bps = (fsize - data_offset) * 8 / (raw_width * raw_height))
+    {
+    case 6:
+      load_raw = &LibRaw::minolta_rd175_load_raw;
+      ilm.CameraMount = LIBRAW_MOUNT_Minolta_A;
+      break;
+    case 8:
+      load_raw = &LibRaw::eight_bit_load_raw;
+      break;
+    case 10:
+      if ((fsize - data_offset) / raw_height * 3 >= raw_width * 4)
       {
-        strcpy(make, table[i].t_make);
-        strcpy(model, table[i].t_model);
-        flip = table[i].flags >> 2;
-        zero_is_bad = table[i].flags & 2;
-        data_offset = table[i].offset == 0xffff ? 0 : table[i].offset;
-        raw_width = table[i].rw;
-        raw_height = table[i].rh;
-        left_margin = table[i].lm;
-        top_margin = table[i].tm;
-        width = raw_width - left_margin - table[i].rm;
-        height = raw_height - top_margin - table[i].bm;
-        filters = 0x1010101U * table[i].cf;
-        colors = 4 - !((filters & filters >> 1) & 0x5555);
-        load_flags = table[i].lf & 0xff;
-        if (table[i].lf & 0x100) /* Monochrome sensor dump */
-        {
-          colors = 1;
-          filters = 0;
-        }
-        switch (tiff_bps = (fsize - data_offset) * 8 / (raw_width * raw_height))
-        {
-        case 6:
-          load_raw = &LibRaw::minolta_rd175_load_raw;
-          ilm.CameraMount = LIBRAW_MOUNT_Minolta_A;
-          break;
-        case 8:
-          load_raw = &LibRaw::eight_bit_load_raw;
-          break;
-        case 10:
-          if ((fsize - data_offset) / raw_height * 3 >= raw_width * 4)
-          {
-            load_raw = &LibRaw::android_loose_load_raw;
-            break;
-          }
-          else if (load_flags & 1)
-          {
-            load_raw = &LibRaw::android_tight_load_raw;
-            break;
-          }
-        case 12:
-          load_flags |= 128;
-          load_raw = &LibRaw::packed_load_raw;
-          break;
-        case 16:
-          order = 0x4949 | 0x404 * (load_flags & 1);
-          tiff_bps -= load_flags >> 4;
-          tiff_bps -= load_flags = load_flags >> 1 & 7;
-          load_raw = table[i].offset == 0xffff
-                         ? &LibRaw::unpacked_load_raw_reversed
-                         : &LibRaw::unpacked_load_raw;
-        }
-        maximum = (1 << tiff_bps) - (1 << table[i].max);
+        load_raw = &LibRaw::android_loose_load_raw;
         break;
       }
+      else if (load_flags & 1)
+      {
+        load_raw = &LibRaw::android_tight_load_raw;
+        break;
+      }
+    case 12:
+      load_flags |= 128;
+      load_raw = &LibRaw::packed_load_raw;
+      break;
+    case 16:
+      order = 0x4949 | 0x404 * (load_flags & 1);
+      tiff_bps -= load_flags >> 4;
+      tiff_bps -= load_flags = load_flags >> 1 & 7;
+      load_raw = cam->offset == 0xffff
+                     ? &LibRaw::unpacked_load_raw_reversed
+                     : &LibRaw::unpacked_load_raw;
+    }
+    maximum = (1 << tiff_bps) - (1 << cam->max);
+  }
   if (zero_fsize)
     fsize = 0;
   if (make[0] == 0)
@@ -1000,8 +1005,17 @@ void LibRaw::identify()
       bool fromtable = false;
     if (!load_raw)
       load_raw = &LibRaw::lossless_jpeg_load_raw;
-    for (i = 0; i < int(sizeof canon / sizeof *canon); i++)
-      if (raw_width == canon[i][0] && raw_height == canon[i][1])
+    /* canon[] is sorted by raw_width, then raw_height */
+    int lo = 0, hi = int(sizeof canon / sizeof *canon) - 1;
+    while (lo <= hi)
+    {
+      i = (lo + hi) / 2;
+      if (raw_width < canon[i][0] ||
+          (raw_width == canon[i][0] && raw_height < canon[i][1]))
+        hi = i - 1;
+      else if (raw_width > canon[i][0] || raw_height > canon[i][1])
+        lo = i + 1;
+      else
       {
         width = raw_width - (left_margin = canon[i][2]);
         height = raw_height - (top_margin = canon[i][3]);
@@ -1014,7 +1028,9 @@ void LibRaw::identify()
         if (canon[i][10])
           filters = canon[i][10] * 0x01010101U;
         fromtable = true;
+        break;
       }
+    }
     if ((unique_id | 0x20000ULL) ==
         0x2720000ULL) // "PowerShot G11", "PowerShot S90": 0x2700000, 0x2720000
                       // possibly "PowerShot SX120 IS" (if not chdk hack?): 0x2710000
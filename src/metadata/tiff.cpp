@@ -2008,9 +2008,6 @@ void LibRaw::apply_tiff()
         && tiff_ifd[i].bps > 0 && tiff_ifd[i].bps < 33 &&
         tiff_ifd[i].phint != 32803 && tiff_ifd[i].phint != 34892 &&
         unsigned(tiff_ifd[i].t_width | tiff_ifd[i].t_height) < 0x10000 &&
-        unsigned(tiff_ifd[i].t_width * tiff_ifd[i].t_height /
-                (SQR(tiff_ifd[i].bps) + 1)) >
-            unsigned(thumb_width * thumb_height / (SQR(thumb_misc) + 1)) &&
         tiff_ifd[i].comp != 34892)
     {
         if (fsizecheck > 0ULL)
@@ -2032,6 +2029,11 @@ void LibRaw::apply_tiff()
             if(!ok)
                 continue;
         }
+      list_tiff_thumbnail(i);
+      if (unsigned(tiff_ifd[i].t_width * tiff_ifd[i].t_height /
+                   (SQR(tiff_ifd[i].bps) + 1)) <=
+          unsigned(thumb_width * thumb_height / (SQR(thumb_misc) + 1)))
+        continue;
 
       thumb_width = tiff_ifd[i].t_width;
       thumb_height = tiff_ifd[i].t_height;
@@ -20,11 +20,10 @@
 
 void LibRaw::fuji_rotate()
 {
-  int i, row, col;
+  int row;
   double step;
-  float r, c, fr, fc;
-  unsigned ur, uc;
-  ushort wide, high, (*img)[4], (*pix)[4];
+  float *rtab, *ctab;
+  ushort wide, high, (*img)[4];
 
   if (!fuji_width)
     return;
@@ -37,22 +36,39 @@ void LibRaw::fuji_rotate()
 
   RUN_CALLBACK(LIBRAW_PROGRESS_FUJI_ROTATE, 0, 2);
 
+  /* source coordinates depend on row - col and row + col only */
+  rtab = (float *)malloc((high + wide) * 2 * sizeof *rtab);
+  merror(rtab, "fuji_rotate()");
+  ctab = rtab + high + wide;
+  for (row = 0; row < high + wide; row++)
+  {
+    rtab[row] = fuji_width + (row - (wide - 1)) * step;
+    ctab[row] = row * step;
+  }
+
+#if defined(LIBRAW_USE_OPENMP)
+#pragma omp parallel for schedule(dynamic, 16) default(shared)                 \
+    num_threads(process_threads())
+#endif
   for (row = 0; row < high; row++)
-    for (col = 0; col < wide; col++)
+    for (int col = 0; col < wide; col++)
     {
-      ur = r = fuji_width + (row - col) * step;
-      uc = c = (row + col) * step;
+      float r = rtab[row - col + wide - 1], c = ctab[row + col], fr, fc, v[4];
+      unsigned ur = r, uc = c;
       if (ur > (unsigned)height - 2 || uc > (unsigned)width - 2)
         continue;
       fr = r - ur;
       fc = c - uc;
-      pix = image + ur * width + uc;
-      for (i = 0; i < colors; i++)
-        img[row * wide + col][i] =
-            (pix[0][i] * (1 - fc) + pix[1][i] * fc) * (1 - fr) +
-            (pix[width][i] * (1 - fc) + pix[width + 1][i] * fc) * fr;
+      ushort(*pix)[4] = image + ur * width + uc;
+      /* all four channels at once, only colors are stored */
+      for (int i = 0; i < 4; i++)
+        v[i] = (pix[0][i] * (1 - fc) + pix[1][i] * fc) * (1 - fr) +
+               (pix[width][i] * (1 - fc) + pix[width + 1][i] * fc) * fr;
+      for (int i = 0; i < colors; i++)
+        img[row * wide + col][i] = v[i];
     }
 
+  free(rtab);
   free(image);
   width = wide;
   height = high;
@@ -63,47 +79,71 @@ void LibRaw::fuji_rotate()
 
 void LibRaw::stretch()
 {
-  ushort newdim, (*img)[4], *pix0, *pix1;
-  int row, col, c;
-  double rc, frac;
+  ushort newdim, (*img)[4];
+  int *src, i, c;
+  double rc, *frac;
 
   if (pixel_aspect == 1)
     return;
   RUN_CALLBACK(LIBRAW_PROGRESS_STRETCH, 0, 2);
   if (pixel_aspect < 1)
-  {
     newdim = height / pixel_aspect + 0.5;
+  else
+    newdim = width * pixel_aspect + 0.5;
+
+  /* source row (column) and weight of the next one for each new row
+     (column), accumulated as before */
+  frac = (double *)malloc(newdim * (sizeof *frac + sizeof *src));
+  merror(frac, "stretch()");
+  src = (int *)(frac + newdim);
+  for (rc = i = 0; i < newdim;
+       i++, rc += pixel_aspect < 1 ? pixel_aspect : 1 / pixel_aspect)
+    frac[i] = rc - (src[i] = rc);
+
+  if (pixel_aspect < 1)
+  {
     img = (ushort(*)[4])calloc(width, newdim * sizeof *img);
     merror(img, "stretch()");
-    for (rc = row = 0; row < newdim; row++, rc += pixel_aspect)
+#if defined(LIBRAW_USE_OPENMP)
+#pragma omp parallel for default(shared) private(c)                           \
+    num_threads(process_threads())
+#endif
+    for (int row = 0; row < newdim; row++)
     {
-      frac = rc - (c = rc);
-      pix0 = pix1 = image[c * width];
-      if (c + 1 < height)
+      double f = frac[row];
+      ushort *pix0 = image[src[row] * width], *pix1 = pix0;
+      if (src[row] + 1 < height)
         pix1 += width * 4;
-      for (col = 0; col < width; col++, pix0 += 4, pix1 += 4)
+      for (int col = 0; col < width; col++, pix0 += 4, pix1 += 4)
         FORCC img[row * width + col][c] =
-            pix0[c] * (1 - frac) + pix1[c] * frac + 0.5;
+            pix0[c] * (1 - f) + pix1[c] * f + 0.5;
     }
     height = newdim;
   }
   else
   {
-    newdim = width * pixel_aspect + 0.5;
     img = (ushort(*)[4])calloc(height, newdim * sizeof *img);
     merror(img, "stretch()");
-    for (rc = col = 0; col < newdim; col++, rc += 1 / pixel_aspect)
+    /* row by row, so both images are read and written sequentially */
+#if defined(LIBRAW_USE_OPENMP)
+#pragma omp parallel for default(shared) private(c)                           \
+    num_threads(process_threads())
+#endif
+    for (int row = 0; row < height; row++)
     {
-      frac = rc - (c = rc);
-      pix0 = pix1 = image[c];
-      if (c + 1 < width)
-        pix1 += 4;
-      for (row = 0; row < height; row++, pix0 += width * 4, pix1 += width * 4)
-        FORCC img[row * newdim + col][c] =
-            pix0[c] * (1 - frac) + pix1[c] * frac + 0.5;
+      ushort(*line)[4] = image + row * width, (*out)[4] = img + row * newdim;
+      for (int col = 0; col < newdim; col++)
+      {
+        double f = frac[col];
+        ushort *pix0 = line[src[col]], *pix1 = pix0;
+        if (src[col] + 1 < width)
+          pix1 += 4;
+        FORCC out[col][c] = pix0[c] * (1 - f) + pix1[c] * f + 0.5;
+      }
     }
     width = newdim;
   }
+  free(frac);
   free(image);
   image = img;
   RUN_CALLBACK(LIBRAW_PROGRESS_STRETCH, 1, 2);
@@ -24,13 +24,27 @@ int LibRaw::dcraw_process(void)
 
   CHECK_ORDER_LOW(LIBRAW_PROGRESS_LOAD_RAW);
   //    CHECK_ORDER_HIGH(LIBRAW_PROGRESS_PRE_INTERPOLATE);
+  if (!decode_roi_covers())
+    return LIBRAW_OUT_OF_ORDER_CALL; // not decoded at unpack()
 
   try
   {
+    if (render_cache)
+    {
+      if (render_cache->valid && render_cache_matches())
+        return dcraw_process_cached();
+      render_cache->valid = 0;
+      /* wavelet denoise depends on WB: not cached */
+      render_cache->building = O.threshold == 0.f;
+      memmove(&render_cache->params, &O, sizeof(O));
+      memmove(render_cache->roi, imgdata.rawparams.roi,
+              sizeof(render_cache->roi));
+    }
 
     int no_crop = 1;
+    unsigned cropbox[4];
 
-    if (~O.cropbox[2] && ~O.cropbox[3])
+    if (process_cropbox(cropbox))
       no_crop = 0;
 
     libraw_decoder_info_t di;
@@ -41,6 +55,7 @@ int LibRaw::dcraw_process(void)
         !O.bad_pixels && !O.dark_frame && is_bayer && !IO.zero_is_bad;
 
     raw2image_ex(subtract_inline); // allocate imgdata.image and copy data!
+    libraw_internal_data.output_data.linear_scale = 1.f;
 
     // Adjust sizes
 
@@ -109,6 +124,21 @@ int LibRaw::dcraw_process(void)
     if (callbacks.pre_scalecolors_cb)
       (callbacks.pre_scalecolors_cb)(this);
 
+    if (render_cache && render_cache->building)
+    {
+      memmove(&render_cache->color, &imgdata.color, sizeof(imgdata.color));
+      memmove(&render_cache->iparams, &imgdata.idata, sizeof(imgdata.idata));
+      memmove(&render_cache->sizes, &imgdata.sizes, sizeof(imgdata.sizes));
+      memmove(&render_cache->ioparams,
+              &libraw_internal_data.internal_output_params,
+              sizeof(render_cache->ioparams));
+      for (int c = 0; c < 4; c++)
+      {
+        render_cache->auto_mul[c] = 0.f;
+        render_cache->scale_mul[c] = 1.f;
+      }
+    }
+
     if (!O.no_auto_scale)
     {
       scale_colors();
@@ -195,65 +225,254 @@ int LibRaw::dcraw_process(void)
       SET_PROC_FLAG(LIBRAW_PROGRESS_MEDIAN_FILTER);
     }
 
-    if (O.highlight == 2)
-    {
-      blend_highlights();
-      SET_PROC_FLAG(LIBRAW_PROGRESS_HIGHLIGHTS);
-    }
+    crop_roi_margin();
 
-    if (O.highlight > 2)
+    if (render_cache && render_cache->building)
     {
-      recover_highlights();
-      SET_PROC_FLAG(LIBRAW_PROGRESS_HIGHLIGHTS);
+      size_t isize = size_t(S.iheight) * S.iwidth * sizeof(*imgdata.image);
+      /* not owned by memmgr: survives recycle() */
+      ushort(*cimage)[4] =
+          (ushort(*)[4])::realloc(render_cache->image, isize);
+      merror(cimage, "LibRaw::dcraw_process()");
+      render_cache->image = cimage;
+      memmove(render_cache->image, imgdata.image, isize);
+      memmove(&render_cache->iparams_interpolated, &imgdata.idata,
+              sizeof(imgdata.idata));
+      memmove(&render_cache->sizes_interpolated, &imgdata.sizes,
+              sizeof(imgdata.sizes));
+      memmove(&render_cache->ioparams_interpolated,
+              &libraw_internal_data.internal_output_params,
+              sizeof(render_cache->ioparams_interpolated));
+      render_cache->progress_flags = imgdata.progress_flags;
+      render_cache->building = 0;
+      render_cache->valid = 1;
     }
 
-    if (O.use_fuji_rotate)
-    {
-      fuji_rotate();
-      SET_PROC_FLAG(LIBRAW_PROGRESS_FUJI_ROTATE);
-    }
+    dcraw_process_finish();
+    O.four_color_rgb = save_4color; // also, restore
 
-    if (!libraw_internal_data.output_data.histogram)
-    {
-      libraw_internal_data.output_data.histogram =
-          (int(*)[LIBRAW_HISTOGRAM_SIZE])malloc(
-              sizeof(*libraw_internal_data.output_data.histogram) * 4);
-      merror(libraw_internal_data.output_data.histogram,
-             "LibRaw::dcraw_process()");
-    }
+    return dcraw_process_result();
+  }
+  catch (const std::bad_alloc&)
+  {
+      recycle();
+      return LIBRAW_UNSUFFICIENT_MEMORY;
+  }
+  catch (const LibRaw_exceptions& err)
+  {
+    if (render_cache)
+      render_cache->building = render_cache->valid = 0;
+    EXCEPTION_HANDLER(err);
+  }
+}
+
+/* cuts rawparams.roi out of the demosaiced ROI + margin area */
+void LibRaw::crop_roi_margin()
+{
+  unsigned *roi = imgdata.rawparams.roi;
+  if (!roi[2] || !roi[3] || (~O.cropbox[2] && ~O.cropbox[3]) ||
+      IO.fuji_width)
+    return;
+  /* image pixel size in sensor pixels */
+  int scale = IO.preview_bin ? IO.preview_bin : (IO.shrink ? 2 : 1);
+  int left = int(roi[0]) -
+             (int(S.left_margin) - int(imgdata.rawdata.sizes.left_margin));
+  int top = int(roi[1]) -
+            (int(S.top_margin) - int(imgdata.rawdata.sizes.top_margin));
+  left = LIM(left / scale, 0, S.width - 1);
+  top = LIM(top / scale, 0, S.height - 1);
+  int width = LIM(int(roi[2]) / scale, 1, S.width - left);
+  int height = LIM(int(roi[3]) / scale, 1, S.height - top);
+  if (width == S.width && height == S.height)
+    return;
+  for (int row = 0; row < height; row++)
+    memmove(imgdata.image + size_t(row) * width,
+            imgdata.image + size_t(row + top) * S.width + left,
+            width * sizeof(*imgdata.image));
+  S.width = S.iwidth = width;
+  S.height = S.iheight = height;
+}
+
+/* highlights, fuji rotate, profile and color conversion: stages after
+   interpolation, also used for cached render */
+void LibRaw::dcraw_process_finish()
+{
+  if (libraw_internal_data.output_data.outbuf)
+    libraw_internal_data.output_data.outbuf->written = 0;
+
+  if (O.highlight == 2)
+  {
+    blend_highlights();
+    SET_PROC_FLAG(LIBRAW_PROGRESS_HIGHLIGHTS);
+  }
+
+  if (O.highlight > 2)
+  {
+    recover_highlights();
+    SET_PROC_FLAG(LIBRAW_PROGRESS_HIGHLIGHTS);
+  }
+
+  if (O.use_fuji_rotate)
+  {
+    fuji_rotate();
+    SET_PROC_FLAG(LIBRAW_PROGRESS_FUJI_ROTATE);
+  }
+
+  if (!libraw_internal_data.output_data.histogram)
+  {
+    libraw_internal_data.output_data.histogram =
+        (int(*)[LIBRAW_HISTOGRAM_SIZE])malloc(
+            sizeof(*libraw_internal_data.output_data.histogram) * 4);
+    merror(libraw_internal_data.output_data.histogram,
+           "LibRaw::dcraw_process()");
+  }
 #ifndef NO_LCMS
-    if (O.camera_profile)
-    {
-      apply_profile(O.camera_profile, O.output_profile);
-      SET_PROC_FLAG(LIBRAW_PROGRESS_APPLY_PROFILE);
-    }
+  if (O.camera_profile)
+  {
+    apply_profile(O.camera_profile, O.output_profile);
+    SET_PROC_FLAG(LIBRAW_PROGRESS_APPLY_PROFILE);
+  }
 #endif
 
-    if (callbacks.pre_converttorgb_cb)
-      (callbacks.pre_converttorgb_cb)(this);
-
-    convert_to_rgb();
-    SET_PROC_FLAG(LIBRAW_PROGRESS_CONVERT_RGB);
+  if (callbacks.pre_converttorgb_cb)
+    (callbacks.pre_converttorgb_cb)(this);
 
-    if (callbacks.post_converttorgb_cb)
-      (callbacks.post_converttorgb_cb)(this);
+  convert_to_rgb();
+  SET_PROC_FLAG(LIBRAW_PROGRESS_CONVERT_RGB);
 
-    if (O.use_fuji_rotate)
-    {
-      stretch();
-      SET_PROC_FLAG(LIBRAW_PROGRESS_STRETCH);
-    }
-    O.four_color_rgb = save_4color; // also, restore
+  if (callbacks.post_converttorgb_cb)
+    (callbacks.post_converttorgb_cb)(this);
 
-    return 0;
+  if (O.use_fuji_rotate)
+  {
+    stretch();
+    SET_PROC_FLAG(LIBRAW_PROGRESS_STRETCH);
   }
-  catch (const std::bad_alloc&)
+
+  libraw_output_buffer_t *ob = libraw_internal_data.output_data.outbuf;
+  if (ob && !ob->written)
+    write_output_buffer();
+}
+
+/* processed image is in imgdata.image even if it does not fit to
+   registered output buffer */
+int LibRaw::dcraw_process_result()
+{
+  libraw_output_buffer_t *ob = libraw_internal_data.output_data.outbuf;
+  return ob && !ob->written ? LIBRAW_BAD_OUTPUT_BUFFER : LIBRAW_SUCCESS;
+}
+
+int LibRaw::begin_render_session()
+{
+  CHECK_ORDER_LOW(LIBRAW_PROGRESS_IDENTIFY);
+  if (!render_cache)
   {
-      recycle();
+    render_cache = (libraw_render_cache_t *)::calloc(1, sizeof(*render_cache));
+    if (!render_cache)
       return LIBRAW_UNSUFFICIENT_MEMORY;
   }
-  catch (const LibRaw_exceptions& err)
+  render_cache->building = render_cache->valid = 0;
+  return LIBRAW_SUCCESS;
+}
+
+void LibRaw::end_render_session()
+{
+  if (!render_cache)
+    return;
+  ::free(render_cache->image);
+  ::free(render_cache);
+  render_cache = NULL;
+}
+
+/* cached image is valid if all parameters used before interpolation
+   are the same; WB, highlight mode, color space, flip and output
+   settings may differ */
+int LibRaw::render_cache_matches()
+{
+  libraw_output_params_t a, b;
+  memmove(&a, &O, sizeof(a));
+  memmove(&b, &render_cache->params, sizeof(b));
+  libraw_output_params_t *p[2] = {&a, &b};
+  for (int i = 0; i < 2; i++)
   {
-    EXCEPTION_HANDLER(err);
+    memset(p[i]->gamm, 0, sizeof(p[i]->gamm));
+    memset(p[i]->user_mul, 0, sizeof(p[i]->user_mul));
+    p[i]->bright = 0.f;
+    p[i]->highlight = 0;
+    p[i]->use_auto_wb = p[i]->use_camera_wb = p[i]->use_camera_matrix = 0;
+    p[i]->output_color = 0;
+    p[i]->output_profile = p[i]->camera_profile = NULL;
+    p[i]->output_bps = p[i]->output_tiff = p[i]->output_flags = 0;
+    p[i]->user_flip = 0;
+    p[i]->auto_bright_thr = 0.f;
+    p[i]->no_auto_bright = 0;
+    p[i]->use_fuji_rotate = 0;
   }
+  return !memcmp(&a, &b, sizeof(a)) &&
+         !memcmp(render_cache->roi, imgdata.rawparams.roi,
+                 sizeof(render_cache->roi));
+}
+
+/* re-render from cached interpolated image: new WB multipliers are applied
+   as ratio to ones used for cached image */
+int LibRaw::dcraw_process_cached()
+{
+  raw2image_start(); // flip
+  int flip = S.flip;
+  int save_4color = O.four_color_rgb;
+
+  memmove(&imgdata.color, &render_cache->color, sizeof(imgdata.color));
+  memmove(&imgdata.idata, &render_cache->iparams, sizeof(imgdata.idata));
+  memmove(&imgdata.sizes, &render_cache->sizes, sizeof(imgdata.sizes));
+  memmove(&libraw_internal_data.internal_output_params,
+          &render_cache->ioparams,
+          sizeof(libraw_internal_data.internal_output_params));
+
+  float scale_mul[4], ratio[4];
+  memmove(scale_mul, render_cache->scale_mul, sizeof(scale_mul));
+  libraw_internal_data.output_data.linear_scale = 1.f;
+  if (!O.no_auto_scale)
+    scale_colors_multipliers(render_cache->auto_mul, scale_mul);
+  int same = 1;
+  for (int c = 0; c < 4; c++)
+  {
+    ratio[c] = render_cache->scale_mul[c] > 0.f
+                   ? scale_mul[c] / render_cache->scale_mul[c]
+                   : 1.f;
+    if (ratio[c] != 1.f)
+      same = 0;
+  }
+
+  memmove(&imgdata.idata, &render_cache->iparams_interpolated,
+          sizeof(imgdata.idata));
+  memmove(&imgdata.sizes, &render_cache->sizes_interpolated,
+          sizeof(imgdata.sizes));
+  memmove(&libraw_internal_data.internal_output_params,
+          &render_cache->ioparams_interpolated,
+          sizeof(libraw_internal_data.internal_output_params));
+  S.flip = flip;
+  imgdata.progress_flags = render_cache->progress_flags;
+
+  size_t pixels = size_t(S.iheight) * S.iwidth;
+  imgdata.image = (ushort(*)[4])realloc(imgdata.image,
+                                        pixels * sizeof(*imgdata.image));
+  merror(imgdata.image, "LibRaw::dcraw_process_cached()");
+  if (same)
+    memmove(imgdata.image, render_cache->image,
+            pixels * sizeof(*imgdata.image));
+  else
+  {
+    ushort(*src)[4] = render_cache->image;
+    ushort(*dst)[4] = imgdata.image;
+#if defined(LIBRAW_USE_OPENMP)
+#pragma omp parallel for default(shared) num_threads(process_threads())
+#endif
+    for (INT64 i = 0; i < INT64(pixels); i++)
+      for (int c = 0; c < 4; c++)
+        dst[i][c] = CLIP(int(src[i][c] * ratio[c]));
+  }
+
+  dcraw_process_finish();
+  O.four_color_rgb = save_4color;
+  return dcraw_process_result();
 }
@@ -138,8 +138,24 @@ void LibRaw::get_mem_image_format(int *width, int *height, int *colors,
 {
   *width = S.width;
   *height = S.height;
+  int flip = S.flip;
   if (imgdata.progress_flags < LIBRAW_PROGRESS_FUJI_ROTATE)
   {
+    /* as raw2image_start() will set it */
+    if (O.user_flip >= 0)
+      flip = O.user_flip;
+    switch ((flip + 3600) % 360)
+    {
+    case 270:
+      flip = 5;
+      break;
+    case 180:
+      flip = 3;
+      break;
+    case 90:
+      flip = 6;
+      break;
+    }
     if (O.use_fuji_rotate)
     {
       if (IO.fuji_width)
@@ -157,7 +173,7 @@ void LibRaw::get_mem_image_format(int *width, int *height, int *colors,
       }
     }
   }
-  if (S.flip & 4)
+  if (flip & 4)
   {
     std::swap(*width, *height);
   }
@@ -175,23 +191,7 @@ int LibRaw::copy_mem_image(void *scan0, int stride, int bgr)
     return LIBRAW_OUT_OF_ORDER_CALL;
 
   if (libraw_internal_data.output_data.histogram)
-  {
-    int perc, val, total, t_white = 0x2000, c;
-    perc = S.width * S.height * O.auto_bright_thr;
-    if (IO.fuji_width)
-      perc /= 2;
-    if (!((O.highlight & ~2) || O.no_auto_bright))
-      for (t_white = c = 0; c < P1.colors; c++)
-      {
-        for (val = 0x2000, total = 0; --val > 32;)
-          if ((total += libraw_internal_data.output_data.histogram[c][val]) >
-              perc)
-            break;
-        if (t_white < val)
-          t_white = val;
-      }
-    gamma_curve(O.gamm[0], O.gamm[1], 2, (t_white << 3) / O.bright);
-  }
+    output_gamma_curve();
 
   int s_iheight = S.iheight;
   int s_iwidth = S.iwidth;
@@ -256,6 +256,357 @@ int LibRaw::copy_mem_image(void *scan0, int stride, int bgr)
 #undef FORBGR
 #undef FORRGB
 
+/* white point from histogram (auto brightness) and output curve */
+void LibRaw::output_gamma_curve()
+{
+  int perc, val, total, t_white = 0x2000, c;
+  perc = S.width * S.height * O.auto_bright_thr;
+  if (IO.fuji_width)
+    perc /= 2;
+  if (!((O.highlight & ~2) || O.no_auto_bright))
+    for (t_white = c = 0; c < P1.colors; c++)
+    {
+      for (val = 0x2000, total = 0; --val > 32;)
+        if ((total += libraw_internal_data.output_data.histogram[c][val]) >
+            perc)
+          break;
+      if (t_white < val)
+        t_white = val;
+    }
+  gamma_curve(O.gamm[0], O.gamm[1], 2, (t_white << 3) / O.bright);
+}
+
+int LibRaw::set_output_buffer(libraw_output_buffer_t *buf)
+{
+  if (buf)
+  {
+    if (!buf->data || buf->stride <= 0 || buf->size <= 0 ||
+        (buf->format &
+         ~(LIBRAW_OUTBUF_LAYOUT_MASK | LIBRAW_OUTBUF_SAMPLE_MASK |
+           LIBRAW_OUTBUF_PLANAR | LIBRAW_OUTBUF_LINEAR)) ||
+        (buf->format & LIBRAW_OUTBUF_SAMPLE_MASK) > LIBRAW_OUTBUF_FLOAT ||
+        ((buf->format & LIBRAW_OUTBUF_LINEAR) &&
+         (buf->format & LIBRAW_OUTBUF_SAMPLE_MASK) != LIBRAW_OUTBUF_FLOAT))
+      return LIBRAW_BAD_OUTPUT_BUFFER;
+    buf->width = buf->height = buf->written = 0;
+  }
+  libraw_internal_data.output_data.outbuf = buf;
+  return LIBRAW_SUCCESS;
+}
+
+int LibRaw::output_buffer_linear()
+{
+  libraw_output_buffer_t *ob = libraw_internal_data.output_data.outbuf;
+  return ob && (ob->format & LIBRAW_OUTBUF_LINEAR);
+}
+
+static int outbuf_sample_bytes(unsigned format)
+{
+  switch (format & LIBRAW_OUTBUF_SAMPLE_MASK)
+  {
+  case LIBRAW_OUTBUF_16BIT:
+    return 2;
+  case LIBRAW_OUTBUF_FLOAT:
+    return 4;
+  default:
+    return 1;
+  }
+}
+
+/* bytes between pixels of output row and between channels of pixel */
+static void outbuf_steps(const libraw_output_buffer_t *ob, INT64 *pixstep,
+                         INT64 *chstep)
+{
+  int bytes = outbuf_sample_bytes(ob->format);
+  if (ob->format & LIBRAW_OUTBUF_PLANAR)
+  {
+    *pixstep = bytes;
+    *chstep = INT64(ob->stride) * ob->height;
+  }
+  else
+  {
+    *pixstep = bytes * ((ob->format & LIBRAW_OUTBUF_RGBA) ? 4 : 3);
+    *chstep = bytes;
+  }
+}
+
+/* output position of image row, and step between its pixels (flip) */
+static uchar *outbuf_row(libraw_output_buffer_t *ob, int flip, int row,
+                         int width, int height, INT64 *step)
+{
+  INT64 colstep, rowstep = ob->stride, chstep;
+  outbuf_steps(ob, &colstep, &chstep);
+  if (flip & 2)
+    row = height - 1 - row;
+  if (flip & 4)
+    std::swap(colstep, rowstep);
+  uchar *dst = (uchar *)ob->data + row * rowstep;
+  if (flip & 1)
+  {
+    dst += (width - 1) * colstep;
+    colstep = -colstep;
+  }
+  *step = colstep;
+  return dst;
+}
+
+/* one image row through output curve; single color is replicated */
+static void outbuf_put_row(libraw_output_buffer_t *ob, uchar *dst,
+                           INT64 step, ushort (*img)[4], int width,
+                           int colors, const ushort *curve)
+{
+  int col, r = 0, g = 1, b = 2;
+  int alpha = ob->format & LIBRAW_OUTBUF_RGBA; /* also set for BGRA */
+  INT64 pixstep, cs;
+  outbuf_steps(ob, &pixstep, &cs);
+  if (colors == 1)
+    g = b = 0;
+  if (ob->format & LIBRAW_OUTBUF_BGR)
+    std::swap(r, b);
+
+  // keep trivial decisions in the outer loop for speed
+  switch (ob->format & LIBRAW_OUTBUF_SAMPLE_MASK)
+  {
+  case LIBRAW_OUTBUF_8BIT:
+    for (col = 0; col < width; col++, dst += step)
+    {
+      dst[0] = curve[img[col][r]] >> 8;
+      dst[cs] = curve[img[col][g]] >> 8;
+      dst[cs * 2] = curve[img[col][b]] >> 8;
+      if (alpha)
+        dst[cs * 3] = 0xff;
+    }
+    break;
+  case LIBRAW_OUTBUF_16BIT:
+    for (col = 0; col < width; col++, dst += step)
+    {
+      *(ushort *)dst = curve[img[col][r]];
+      *(ushort *)(dst + cs) = curve[img[col][g]];
+      *(ushort *)(dst + cs * 2) = curve[img[col][b]];
+      if (alpha)
+        *(ushort *)(dst + cs * 3) = 0xffff;
+    }
+    break;
+  case LIBRAW_OUTBUF_FLOAT:
+    for (col = 0; col < width; col++, dst += step)
+    {
+      *(float *)dst = curve[img[col][r]] * (1.f / 65535.f);
+      *(float *)(dst + cs) = curve[img[col][g]] * (1.f / 65535.f);
+      *(float *)(dst + cs * 2) = curve[img[col][b]] * (1.f / 65535.f);
+      if (alpha)
+        *(float *)(dst + cs * 3) = 1.f;
+    }
+    break;
+  }
+}
+
+/* one row of linear RGB triplets, scaled to 1.0 at white level */
+static void outbuf_put_linear_row(libraw_output_buffer_t *ob, uchar *dst,
+                                  INT64 step, const float *rgb, int width,
+                                  float scale)
+{
+  int col, r = 0, b = 2;
+  int alpha = ob->format & LIBRAW_OUTBUF_RGBA;
+  INT64 pixstep, cs;
+  outbuf_steps(ob, &pixstep, &cs);
+  if (ob->format & LIBRAW_OUTBUF_BGR)
+    std::swap(r, b);
+  for (col = 0; col < width; col++, dst += step, rgb += 3)
+  {
+    *(float *)dst = rgb[r] * scale;
+    *(float *)(dst + cs) = rgb[1] * scale;
+    *(float *)(dst + cs * 2) = rgb[b] * scale;
+    if (alpha)
+      *(float *)(dst + cs * 3) = 1.f;
+  }
+}
+
+/* sets output size; 0 if the registered buffer is too small for it */
+int LibRaw::output_buffer_fits()
+{
+  libraw_output_buffer_t *ob = libraw_internal_data.output_data.outbuf;
+  int width = S.width, height = S.height;
+  int channels = (ob->format & LIBRAW_OUTBUF_RGBA) ? 4 : 3;
+  if (S.flip & 4)
+    std::swap(width, height);
+  ob->width = width;
+  ob->height = height;
+  INT64 rowbytes = INT64(width) * outbuf_sample_bytes(ob->format);
+  INT64 planes = 0;
+  if (ob->format & LIBRAW_OUTBUF_PLANAR)
+    planes = INT64(ob->stride) * height * (channels - 1);
+  else
+    rowbytes *= channels;
+  return rowbytes <= ob->stride &&
+         planes + INT64(ob->stride) * (height - 1) + rowbytes <= ob->size;
+}
+
+/* convert_to_rgb_loop() fused with output: used when the output curve
+   does not depend on the histogram of the converted image, and for linear
+   output that is taken before 16-bit clipping */
+void LibRaw::convert_to_rgb_output(float out_cam[3][4])
+{
+  libraw_output_buffer_t *ob = libraw_internal_data.output_data.outbuf;
+  int(*histogram)[LIBRAW_HISTOGRAM_SIZE] =
+      libraw_internal_data.output_data.histogram;
+  const int raw_color = libraw_internal_data.internal_output_params.raw_color;
+  const int colors = P1.colors;
+  const int linear = ob->format & LIBRAW_OUTBUF_LINEAR;
+  const float scale =
+      libraw_internal_data.output_data.linear_scale * (1.f / 65535.f);
+  const size_t hsize = sizeof(*histogram) * 4;
+  int row, col, c, i;
+
+#if defined(LIBRAW_USE_OPENMP)
+  int buffer_count = process_threads();
+#else
+  int buffer_count = 1;
+#endif
+  /* per thread: histograms, summed at end, and linear row */
+  char **buffers = malloc_omp_buffers(
+      buffer_count, hsize + S.width * 3 * sizeof(float), "convert_to_rgb()");
+  for (i = 0; i < buffer_count; i++)
+    memset(buffers[i], 0, hsize);
+
+  if (!linear)
+    gamma_curve(O.gamm[0], O.gamm[1], 2, (0x2000 << 3) / O.bright);
+
+#if defined(LIBRAW_USE_OPENMP)
+#pragma omp parallel for default(shared) private(col, c)                       \
+    num_threads(buffer_count)
+#endif
+  for (row = 0; row < S.height; row++)
+  {
+#if defined(LIBRAW_USE_OPENMP)
+    char *buf = buffers[omp_get_thread_num()];
+#else
+    char *buf = buffers[0];
+#endif
+    int(*hist)[LIBRAW_HISTOGRAM_SIZE] = (int(*)[LIBRAW_HISTOGRAM_SIZE])buf;
+    float *rgb = (float *)(buf + hsize), *out = rgb;
+    ushort(*img)[4] = imgdata.image + size_t(row) * S.width;
+    INT64 step;
+    if (raw_color || (colors != 3 && colors != 4))
+    {
+      for (col = 0; col < S.width; col++)
+      {
+        if (raw_color)
+          for (c = 0; c < colors; c++)
+            hist[c][img[col][c] >> 3]++;
+        if (linear)
+          for (c = 0; c < 3; c++)
+            rgb[col * 3 + c] = img[col][colors == 1 ? 0 : c];
+      }
+    }
+    else if (colors == 3)
+    {
+      for (col = 0; col < S.width; col++, out += linear ? 3 : 0)
+      {
+        ushort *pix = img[col];
+        out[0] = out_cam[0][0] * pix[0] + out_cam[0][1] * pix[1] +
+                 out_cam[0][2] * pix[2];
+        out[1] = out_cam[1][0] * pix[0] + out_cam[1][1] * pix[1] +
+                 out_cam[1][2] * pix[2];
+        out[2] = out_cam[2][0] * pix[0] + out_cam[2][1] * pix[1] +
+                 out_cam[2][2] * pix[2];
+        pix[0] = CLIP((int)out[0]);
+        pix[1] = CLIP((int)out[1]);
+        pix[2] = CLIP((int)out[2]);
+        hist[0][pix[0] >> 3]++;
+        hist[1][pix[1] >> 3]++;
+        hist[2][pix[2] >> 3]++;
+      }
+    }
+    else
+    {
+      for (col = 0; col < S.width; col++, out += linear ? 3 : 0)
+      {
+        ushort *pix = img[col];
+        out[0] = out_cam[0][0] * pix[0] + out_cam[0][1] * pix[1] +
+                 out_cam[0][2] * pix[2] + out_cam[0][3] * pix[3];
+        out[1] = out_cam[1][0] * pix[0] + out_cam[1][1] * pix[1] +
+                 out_cam[1][2] * pix[2] + out_cam[1][3] * pix[3];
+        out[2] = out_cam[2][0] * pix[0] + out_cam[2][1] * pix[1] +
+                 out_cam[2][2] * pix[2] + out_cam[2][3] * pix[3];
+        pix[0] = CLIP((int)out[0]);
+        pix[1] = CLIP((int)out[1]);
+        pix[2] = CLIP((int)out[2]);
+        hist[0][pix[0] >> 3]++;
+        hist[1][pix[1] >> 3]++;
+        hist[2][pix[2] >> 3]++;
+        hist[3][pix[3] >> 3]++;
+      }
+    }
+    uchar *dst = outbuf_row(ob, S.flip, row, S.width, S.height, &step);
+    if (linear)
+      outbuf_put_linear_row(ob, dst, step, rgb, S.width, scale);
+    else
+      outbuf_put_row(ob, dst, step, img, S.width, colors, imgdata.color.curve);
+  }
+
+  int *sum = (int *)histogram;
+  memset(sum, 0, hsize);
+  for (i = 0; i < buffer_count; i++)
+  {
+    int *h = (int *)buffers[i];
+    for (c = 0; c < LIBRAW_HISTOGRAM_SIZE * 4; c++)
+      sum[c] += h[c];
+  }
+  free_omp_buffers(buffers, buffer_count);
+  ob->written = 1;
+}
+
+/* output pass after conversion: curve depends on histogram, or image
+   was stretched (linear output is then taken from 16-bit image) */
+void LibRaw::write_output_buffer()
+{
+  libraw_output_buffer_t *ob = libraw_internal_data.output_data.outbuf;
+  const int linear = ob->format & LIBRAW_OUTBUF_LINEAR;
+  const float scale =
+      libraw_internal_data.output_data.linear_scale * (1.f / 65535.f);
+  int row;
+  if (!output_buffer_fits())
+    return;
+#if defined(LIBRAW_USE_OPENMP)
+  int buffer_count = process_threads();
+#else
+  int buffer_count = 1;
+#endif
+  char **buffers = NULL;
+  if (linear)
+    buffers = malloc_omp_buffers(buffer_count, S.width * 3 * sizeof(float),
+                                 "write_output_buffer()");
+  else
+    output_gamma_curve();
+#if defined(LIBRAW_USE_OPENMP)
+#pragma omp parallel for default(shared) num_threads(buffer_count)
+#endif
+  for (row = 0; row < S.height; row++)
+  {
+    INT64 step;
+    ushort(*img)[4] = imgdata.image + size_t(row) * S.width;
+    uchar *dst = outbuf_row(ob, S.flip, row, S.width, S.height, &step);
+    if (linear)
+    {
+#if defined(LIBRAW_USE_OPENMP)
+      float *rgb = (float *)buffers[omp_get_thread_num()];
+#else
+      float *rgb = (float *)buffers[0];
+#endif
+      for (int col = 0; col < S.width; col++)
+        for (int c = 0; c < 3; c++)
+          rgb[col * 3 + c] = img[col][P1.colors == 1 ? 0 : c];
+      outbuf_put_linear_row(ob, dst, step, rgb, S.width, scale);
+    }
+    else
+      outbuf_put_row(ob, dst, step, img, S.width, P1.colors,
+                     imgdata.color.curve);
+  }
+  if (buffers)
+    free_omp_buffers(buffers, buffer_count);
+  ob->written = 1;
+}
+
 libraw_processed_image_t *LibRaw::dcraw_make_mem_image(int *errcode)
 
 {
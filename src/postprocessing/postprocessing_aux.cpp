@@ -30,82 +30,84 @@ void LibRaw::hat_transform(float *temp, float *base, int st, int size, int sc)
               base[st * (2 * size - 2 - (i + sc))];
 }
 
-#if !defined(LIBRAW_USE_OPENMP)
-void LibRaw::wavelet_denoise()
+/* wavelet_denoise() keeps two planes: the sum of thresholded high-pass
+   levels and the current low-pass image. Rows are split into bands; the
+   vertical pass of a band streams hat_transform()ed rows through a ring of
+   2*sc+1 rows, so the low-pass image is updated in place. Rows the
+   neighbour bands overwrite are transformed beforehand (WAVELET_HALO) */
+#define WAVELET_LEVELS 5
+#define WAVELET_BAND_ROWS (3 * (1 << (WAVELET_LEVELS - 1)) + 1)
+
+enum wavelet_phase_t
 {
-  float *fimg = 0, *temp, thold, mul[2], avg, diff;
-  int scale = 1, size, lev, hpass, lpass, row, col, nc, c, i, wlast, blk[2];
-  ushort *window[4];
-  static const float noise[] = {0.8002, 0.2735, 0.1202, 0.0585,
-                                0.0291, 0.0152, 0.0080, 0.0044};
+  WAVELET_LOAD,
+  WAVELET_HALO,
+  WAVELET_LEVEL,
+  WAVELET_STORE,
+  GREENS_SAVE,
+  GREENS_MATCH
+};
 
-  while (maximum << scale < 0x10000)
-    scale++;
-  maximum <<= --scale;
-  black <<= scale;
-  FORC4 cblack[c] <<= scale;
-  if ((size = iheight * iwidth) < 0x15550000)
-    fimg = (float *)malloc((size * 3 + iheight + iwidth) * sizeof *fimg);
-  merror(fimg, "wavelet_denoise()");
-  temp = fimg + size * 3;
-  if ((nc = colors) == 3 && filters)
-    nc++;
-  FORC(nc)
-  { /* denoise R,G1,B,G3 individually */
-    for (i = 0; i < size; i++)
-      fimg[i] = 256 * sqrt((double)(image[i][c] << scale));
-    for (hpass = lev = 0; lev < 5; lev++)
-    {
-      lpass = size * ((lev & 1) + 1);
-      for (row = 0; row < iheight; row++)
-      {
-        hat_transform(temp, fimg + hpass + row * iwidth, 1, iwidth, 1 << lev);
-        for (col = 0; col < iwidth; col++)
-          fimg[lpass + row * iwidth + col] = temp[col] * 0.25;
-      }
-      for (col = 0; col < iwidth; col++)
-      {
-        hat_transform(temp, fimg + lpass + col, iwidth, iheight, 1 << lev);
-        for (row = 0; row < iheight; row++)
-          fimg[lpass + row * iwidth + col] = temp[row] * 0.25;
-      }
-      thold = threshold * noise[lev];
-      for (i = 0; i < size; i++)
-      {
-        fimg[hpass + i] -= fimg[lpass + i];
-        if (fimg[hpass + i] < -thold)
-          fimg[hpass + i] += thold;
-        else if (fimg[hpass + i] > thold)
-          fimg[hpass + i] -= thold;
-        else
-          fimg[hpass + i] = 0;
-        if (hpass)
-          fimg[i] += fimg[hpass + i];
-      }
-      hpass = lpass;
-    }
-    for (i = 0; i < size; i++)
-      image[i][c] = CLIP(SQR(fimg[i] + fimg[lpass + i]) / 0x10000);
-  }
-  if (filters && colors == 3)
+struct wavelet_task_t
+{
+  LibRaw *self;
+  int phase, nbands, c, lev;
+  float thold, *acc, *lpass, *lut, *bands;
+};
+
+void LibRaw::wavelet_denoise_task(void *t, int band)
+{
+  wavelet_task_t *task = (wavelet_task_t *)t;
+  task->self->wavelet_denoise_band(task, band);
+}
+
+void LibRaw::wavelet_denoise_band(void *t, int band)
+{
+  wavelet_task_t *task = (wavelet_task_t *)t;
+  int c = task->c, row, col;
+
+  if (task->phase >= GREENS_SAVE)
   { /* pull G1 and G3 closer together */
+    float mul[2], avg, diff, thold = threshold / 512;
+    int blk[2], r0, r1;
+    ushort *window[3], *spare, *slot = (ushort *)(task->bands +
+                                                  band * WAVELET_BAND_ROWS *
+                                                      iwidth);
+    /* even band starts: rows sharing a shrunk image row stay in one band */
+    r0 = band ? MAX(1, (1 + (height - 2) * band / task->nbands) & ~1) : 1;
+    r1 = band + 1 < task->nbands
+             ? MAX(1, (1 + (height - 2) * (band + 1) / task->nbands) & ~1)
+             : height - 1;
+    if (r0 >= r1)
+      return;
+    if (task->phase == GREENS_SAVE)
+    { /* rows the neighbour bands change: original values */
+      for (col = FC(r0 - 1, 1) & 1; col < width; col += 2)
+        slot[col] = BAYER(r0 - 1, col);
+      for (col = FC(r1, 1) & 1; col < width; col += 2)
+        slot[width + col] = BAYER(r1, col);
+      return;
+    }
     for (row = 0; row < 2; row++)
     {
       mul[row] = 0.125 * pre_mul[FC(row + 1, 0) | 1] / pre_mul[FC(row, 0) | 1];
       blk[row] = cblack[FC(row, 0) | 1];
     }
-    for (i = 0; i < 4; i++)
-      window[i] = (ushort *)fimg + width * i;
-    for (wlast = -1, row = 1; row < height - 1; row++)
+    window[0] = slot;
+    window[1] = slot + width * 2;
+    spare = slot + width * 3;
+    for (col = FC(r0, 1) & 1; col < width; col += 2)
+      window[1][col] = BAYER(r0, col);
+    for (row = r0; row < r1; row++)
     {
-      while (wlast < row + 1)
+      if (row + 1 == r1)
+        window[2] = slot + width;
+      else
       {
-        for (wlast++, i = 0; i < 4; i++)
-          window[(i + 3) & 3] = window[i];
-        for (col = FC(wlast, 1) & 1; col < width; col += 2)
-          window[2][col] = BAYER(wlast, col);
+        window[2] = spare;
+        for (col = FC(row + 1, 1) & 1; col < width; col += 2)
+          window[2][col] = BAYER(row + 1, col);
       }
-      thold = threshold / 512;
       for (col = (FC(row, 0) & 1) + 1; col < width - 1; col += 2)
       {
         avg = (window[0][col - 1] + window[0][col + 1] + window[2][col - 1] +
@@ -122,16 +124,96 @@ void LibRaw::wavelet_denoise()
           diff = 0;
         BAYER(row, col) = CLIP(SQR(avg + diff) + 0.5);
       }
+      spare = window[0];
+      window[0] = window[1];
+      window[1] = window[2];
+    }
+    return;
+  }
+
+  int r0 = iheight * band / task->nbands;
+  int r1 = iheight * (band + 1) / task->nbands;
+  float *acc = task->acc, *lpass = task->lpass;
+
+  if (task->phase == WAVELET_LOAD)
+  {
+    for (int i = r0 * iwidth; i < r1 * iwidth; i++)
+      lpass[i] = task->lut[image[i][c]];
+    return;
+  }
+  if (task->phase == WAVELET_STORE)
+  {
+    for (int i = r0 * iwidth; i < r1 * iwidth; i++)
+      image[i][c] = CLIP(SQR(acc[i] + lpass[i]) / 0x10000);
+    return;
+  }
+
+  int sc = 1 << task->lev, nring = 2 * sc + 1;
+  float *ring = task->bands + band * WAVELET_BAND_ROWS * iwidth;
+  float *tail = ring + nring * iwidth;
+  /* rows [lo, next) are in the ring; [r1, r1 + sc) are kept in tail */
+  int lo = MAX(0, r0 - sc), next = MIN(r1, r0 + sc);
+  if (task->phase == WAVELET_HALO)
+  {
+    for (row = lo; row < next; row++)
+    {
+      float *h = ring + (row % nring) * iwidth;
+      hat_transform(h, lpass + row * iwidth, 1, iwidth, sc);
+      for (col = 0; col < iwidth; col++)
+        h[col] *= 0.25;
+    }
+    for (row = r1; row < MIN(iheight, r1 + sc); row++)
+    {
+      float *h = tail + (row - r1) * iwidth;
+      hat_transform(h, lpass + row * iwidth, 1, iwidth, sc);
+      for (col = 0; col < iwidth; col++)
+        h[col] *= 0.25;
+    }
+    return;
+  }
+
+  /* WAVELET_LEVEL */
+  float thold = task->thold;
+  int lev = task->lev;
+  for (row = r0; row < r1; row++)
+  {
+    for (; next < iheight && next <= row + sc; next++)
+    {
+      float *h = ring + (next % nring) * iwidth;
+      if (next >= r1)
+        memmove(h, tail + (next - r1) * iwidth, iwidth * sizeof *h);
+      else
+      {
+        hat_transform(h, lpass + next * iwidth, 1, iwidth, sc);
+        for (col = 0; col < iwidth; col++)
+          h[col] *= 0.25;
+      }
+    }
+    /* the same neighbours as hat_transform(), mirrored at the edges */
+    int up = row < sc ? sc - row : row - sc;
+    int down = row + sc < iheight ? row + sc : 2 * iheight - 2 - (row + sc);
+    up = LIM(up, 0, iheight - 1);
+    down = LIM(down, 0, iheight - 1);
+    float *hc = ring + (row % nring) * iwidth;
+    float *hu = ring + (up % nring) * iwidth;
+    float *hd = ring + (down % nring) * iwidth;
+    float *lp = lpass + row * iwidth, *sum = acc + row * iwidth;
+    for (col = 0; col < iwidth; col++)
+    {
+      float low = (2 * hc[col] + hu[col] + hd[col]) * 0.25f;
+      float high = lp[col] - low;
+      /* soft threshold: shrink towards 0 by thold, branchless */
+      high = MIN(high + thold, 0.f) + MAX(high - thold, 0.f);
+      sum[col] = lev ? sum[col] + high : high;
+      lp[col] = low;
     }
   }
-  free(fimg);
 }
-#else /* LIBRAW_USE_OPENMP */
+
 void LibRaw::wavelet_denoise()
 {
-  float *fimg = 0, *temp, thold, mul[2], avg, diff;
-  int scale = 1, size, lev, hpass, lpass, row, col, nc, c, i, wlast, blk[2];
-  ushort *window[4];
+  float *fimg = 0;
+  int scale = 1, size, lev, nc, c, i;
   static const float noise[] = {0.8002, 0.2735, 0.1202, 0.0585,
                                 0.0291, 0.0152, 0.0080, 0.0044};
 
@@ -140,185 +222,270 @@ void LibRaw::wavelet_denoise()
   maximum <<= --scale;
   black <<= scale;
   FORC4 cblack[c] <<= scale;
+
+  /* band buffers: ring and tail rows for the largest scale; the green
+     matching needs 4 rows of width ushorts, less than that */
+  int nbands = parallel_width(MAX(1, iheight / 128), process_threads());
   if ((size = iheight * iwidth) < 0x15550000)
-    fimg = (float *)malloc((size * 3 + iheight + iwidth) * sizeof *fimg);
+    fimg = (float *)malloc(
+        (size * 2 + 0x10000 + (size_t)nbands * WAVELET_BAND_ROWS * iwidth) *
+        sizeof *fimg);
   merror(fimg, "wavelet_denoise()");
-  temp = fimg + size * 3;
+
+  wavelet_task_t task;
+  task.self = this;
+  task.nbands = nbands;
+  task.acc = fimg;
+  task.lpass = fimg + size;
+  task.lut = fimg + size * 2;
+  task.bands = task.lut + 0x10000;
+  for (i = 0; i < 0x10000; i++)
+    task.lut[i] = 256 * sqrt((double)(i << scale));
+
   if ((nc = colors) == 3 && filters)
     nc++;
-#pragma omp parallel default(shared) private(                                  \
-    i, col, row, thold, lev, lpass, hpass, temp, c) firstprivate(scale, size)
-  {
-#pragma omp critical /* LibRaw's malloc is not local thread-safe */
-    temp = (float *)malloc((iheight + iwidth) * sizeof *fimg);
-    FORC(nc)
-    { /* denoise R,G1,B,G3 individually */
-#pragma omp for
-      for (i = 0; i < size; i++)
-        fimg[i] = 256 * sqrt((double)(image[i][c] << scale));
-      for (hpass = lev = 0; lev < 5; lev++)
-      {
-        lpass = size * ((lev & 1) + 1);
-#pragma omp for
-        for (row = 0; row < iheight; row++)
-        {
-          hat_transform(temp, fimg + hpass + row * iwidth, 1, iwidth, 1 << lev);
-          for (col = 0; col < iwidth; col++)
-            fimg[lpass + row * iwidth + col] = temp[col] * 0.25;
-        }
-#pragma omp for
-        for (col = 0; col < iwidth; col++)
-        {
-          hat_transform(temp, fimg + lpass + col, iwidth, iheight, 1 << lev);
-          for (row = 0; row < iheight; row++)
-            fimg[lpass + row * iwidth + col] = temp[row] * 0.25;
-        }
-        thold = threshold * noise[lev];
-#pragma omp for
-        for (i = 0; i < size; i++)
-        {
-          fimg[hpass + i] -= fimg[lpass + i];
-          if (fimg[hpass + i] < -thold)
-            fimg[hpass + i] += thold;
-          else if (fimg[hpass + i] > thold)
-            fimg[hpass + i] -= thold;
-          else
-            fimg[hpass + i] = 0;
-          if (hpass)
-            fimg[i] += fimg[hpass + i];
-        }
-        hpass = lpass;
-      }
-#pragma omp for
-      for (i = 0; i < size; i++)
-        image[i][c] = CLIP(SQR(fimg[i] + fimg[lpass + i]) / 0x10000);
-    }
-#pragma omp critical
-    free(temp);
-  } /* end omp parallel */
-  /* the following loops are hard to parallize, no idea yes,
-   * problem is wlast which is carrying dependency
-   * second part should be easyer, but did not yet get it right.
-   */
-  if (filters && colors == 3)
-  { /* pull G1 and G3 closer together */
-    for (row = 0; row < 2; row++)
+  FORC(nc)
+  { /* denoise R,G1,B,G3 individually */
+    checkCancel();
+    task.c = c;
+    task.phase = WAVELET_LOAD;
+    run_parallel(nbands, process_threads(), wavelet_denoise_task, &task);
+    for (lev = 0; lev < WAVELET_LEVELS; lev++)
     {
-      mul[row] = 0.125 * pre_mul[FC(row + 1, 0) | 1] / pre_mul[FC(row, 0) | 1];
-      blk[row] = cblack[FC(row, 0) | 1];
-    }
-    for (i = 0; i < 4; i++)
-      window[i] = (ushort *)fimg + width * i;
-    for (wlast = -1, row = 1; row < height - 1; row++)
-    {
-      while (wlast < row + 1)
-      {
-        for (wlast++, i = 0; i < 4; i++)
-          window[(i + 3) & 3] = window[i];
-        for (col = FC(wlast, 1) & 1; col < width; col += 2)
-          window[2][col] = BAYER(wlast, col);
-      }
-      thold = threshold / 512;
-      for (col = (FC(row, 0) & 1) + 1; col < width - 1; col += 2)
-      {
-        avg = (window[0][col - 1] + window[0][col + 1] + window[2][col - 1] +
-               window[2][col + 1] - blk[~row & 1] * 4) *
-                  mul[row & 1] +
-              (window[1][col] + blk[row & 1]) * 0.5;
-        avg = avg < 0 ? 0 : sqrt(avg);
-        diff = sqrt((double)BAYER(row, col)) - avg;
-        if (diff < -thold)
-          diff += thold;
-        else if (diff > thold)
-          diff -= thold;
-        else
-          diff = 0;
-        BAYER(row, col) = CLIP(SQR(avg + diff) + 0.5);
-      }
+      task.lev = lev;
+      task.thold = threshold * noise[lev];
+      task.phase = WAVELET_HALO;
+      run_parallel(nbands, process_threads(), wavelet_denoise_task, &task);
+      task.phase = WAVELET_LEVEL;
+      run_parallel(nbands, process_threads(), wavelet_denoise_task, &task);
     }
+    task.phase = WAVELET_STORE;
+    run_parallel(nbands, process_threads(), wavelet_denoise_task, &task);
+  }
+  if (filters && colors == 3)
+  {
+    task.phase = GREENS_SAVE;
+    run_parallel(nbands, process_threads(), wavelet_denoise_task, &task);
+    task.phase = GREENS_MATCH;
+    run_parallel(nbands, process_threads(), wavelet_denoise_task, &task);
   }
   free(fimg);
 }
 
-#endif
+#define MED_SORT(a, b)                                                         \
+  {                                                                            \
+    int t_ = MIN(a, b);                                                        \
+    b = MAX(a, b);                                                             \
+    a = t_;                                                                    \
+  }
+
+/* Optimal 9-element median search, branchless so the compiler may run it
+   on a vector of columns at once. out[col] = median of the 3x3 block of
+   rows r0..r2 around col, for col in 1..n-2 */
+static void median9_row(const int *r0, const int *r1, const int *r2, int *out,
+                        int n)
+{
+  for (int col = 1; col < n - 1; col++)
+  {
+    int p0 = r0[col - 1], p1 = r0[col], p2 = r0[col + 1];
+    int p3 = r1[col - 1], p4 = r1[col], p5 = r1[col + 1];
+    int p6 = r2[col - 1], p7 = r2[col], p8 = r2[col + 1];
+    MED_SORT(p1, p2);
+    MED_SORT(p4, p5);
+    MED_SORT(p7, p8);
+    MED_SORT(p0, p1);
+    MED_SORT(p3, p4);
+    MED_SORT(p6, p7);
+    MED_SORT(p1, p2);
+    MED_SORT(p4, p5);
+    MED_SORT(p7, p8);
+    MED_SORT(p0, p3);
+    MED_SORT(p5, p8);
+    MED_SORT(p4, p7);
+    MED_SORT(p3, p6);
+    MED_SORT(p1, p4);
+    MED_SORT(p2, p5);
+    MED_SORT(p4, p7);
+    MED_SORT(p4, p2);
+    MED_SORT(p6, p4);
+    MED_SORT(p4, p2);
+    out[col] = p4;
+  }
+}
+#undef MED_SORT
+
 void LibRaw::median_filter()
 {
-  ushort(*pix)[4];
-  int pass, c, i, j, k, med[9];
-  static const uchar opt[] = /* Optimal 9-element median search */
-      {1, 2, 4, 5, 7, 8, 0, 1, 3, 4, 6, 7, 1, 2, 4, 5, 7, 8, 0,
-       3, 5, 8, 4, 7, 3, 6, 1, 4, 2, 5, 4, 7, 4, 2, 6, 4, 4, 2};
+  int pass, c, i;
+
+#if defined(LIBRAW_USE_OPENMP)
+  int buffer_count = process_threads();
+#else
+  int buffer_count = 1;
+#endif
+  /* per thread: R-G (B-G) differences of three consecutive rows + medians */
+  char **buffers = malloc_omp_buffers(buffer_count, width * 4 * sizeof(int),
+                                      "median_filter()");
 
   for (pass = 1; pass <= med_passes; pass++)
   {
     RUN_CALLBACK(LIBRAW_PROGRESS_MEDIAN_FILTER, pass - 1, med_passes);
     for (c = 0; c < 3; c += 2)
     {
-      for (pix = image; pix < image + width * height; pix++)
-        pix[0][3] = pix[0][c];
-      for (pix = image + width; pix < image + width * (height - 1); pix++)
+#if defined(LIBRAW_USE_OPENMP)
+#pragma omp parallel for default(shared) num_threads(buffer_count)
+#endif
+      for (i = 0; i < width * height; i++)
+        image[i][3] = image[i][c];
+      /* border rows and columns are left as is */
+#if defined(LIBRAW_USE_OPENMP)
+#pragma omp parallel default(shared) num_threads(buffer_count)
+#endif
       {
-        if ((pix - image + 1) % width < 2)
-          continue;
-        for (k = 0, i = -width; i <= width; i += width)
-          for (j = i - 1; j <= i + 1; j++)
-            med[k++] = pix[j][3] - pix[j][1];
-        for (i = 0; i < int(sizeof opt); i += 2)
-          if (med[opt[i]] > med[opt[i + 1]])
-            SWAP(med[opt[i]], med[opt[i + 1]]);
-        pix[0][c] = CLIP(med[4] + pix[0][1]);
-      }
+#if defined(LIBRAW_USE_OPENMP)
+        int *buf = (int *)buffers[omp_get_thread_num()];
+#else
+        int *buf = (int *)buffers[0];
+#endif
+        int *diff[3], *med = buf + width * 3, last = -2;
+#if defined(LIBRAW_USE_OPENMP)
+#pragma omp for schedule(static)
+#endif
+        for (int row = 1; row < height - 1; row++)
+        {
+          int r = 0;
+          if (row == last + 1)
+          { /* next row of the same block: two rows are already there */
+            int *t = diff[0];
+            diff[0] = diff[1];
+            diff[1] = diff[2];
+            diff[2] = t;
+            r = 2;
+          }
+          else
+            for (int k = 0; k < 3; k++)
+              diff[k] = buf + width * k;
+          for (; r < 3; r++)
+          {
+            ushort(*pix)[4] = image + (row - 1 + r) * width;
+            for (int col = 0; col < width; col++)
+              diff[r][col] = pix[col][3] - pix[col][1];
+          }
+          median9_row(diff[0], diff[1], diff[2], med, width);
+          ushort(*pix)[4] = image + row * width;
+          for (int col = 1; col < width - 1; col++)
+            pix[col][c] = CLIP(med[col] + pix[col][1]);
+          last = row;
+        }
+      } /* end omp parallel */
     }
   }
+  free_omp_buffers(buffers, buffer_count);
 }
 
 void LibRaw::blend_highlights()
 {
-  int clip = INT_MAX, row, col, c, i, j;
+  int clip = INT_MAX, row, col, c, i, j, k, n;
   static const float trans[2][4][4] = {
       {{1, 1, 1}, {1.7320508, -1.7320508, 0}, {-1, -1, 2}},
       {{1, 1, 1, 1}, {1, -1, 1, -1}, {1, 1, -1, -1}, {1, -1, -1, 1}}};
   static const float itrans[2][4][4] = {
       {{1, 0.8660254, -0.5}, {1, -0.8660254, -0.5}, {1, 0, 1}},
       {{1, 1, 1, 1}, {1, -1, 1, -1}, {1, 1, -1, -1}, {1, -1, -1, 1}}};
-  float cam[2][4], lab[2][4], sum[2], chratio;
 
   if ((unsigned)(colors - 3) > 1)
     return;
   RUN_CALLBACK(LIBRAW_PROGRESS_HIGHLIGHTS, 0, 2);
   FORCC if (clip > (i = 65535 * pre_mul[c])) clip = i;
+
+#if defined(LIBRAW_USE_OPENMP)
+  int buffer_count = process_threads();
+#else
+  int buffer_count = 1;
+#endif
+  /* per thread: clipped pixels of a row as planes of cam[2][4], lab[2][4]
+     and sum[2], so the color transforms run over many pixels at once */
+  char **buffers = malloc_omp_buffers(
+      buffer_count, width * (sizeof(int) + 18 * sizeof(float)),
+      "blend_highlights()");
+  const float(*tr)[4] = trans[colors - 3], (*itr)[4] = itrans[colors - 3];
+
+#if defined(LIBRAW_USE_OPENMP)
+#pragma omp parallel for schedule(dynamic, 16) default(shared)                 \
+    private(col, c, i, j, k, n) num_threads(buffer_count)
+#endif
   for (row = 0; row < height; row++)
-    for (col = 0; col < width; col++)
+  {
+#if defined(LIBRAW_USE_OPENMP)
+    char *buffer = buffers[omp_get_thread_num()];
+#else
+    char *buffer = buffers[0];
+#endif
+    int *idx = (int *)buffer;
+    float *cam[2][4], *lab[2][4], *sum[2];
+    for (i = 0; i < 2; i++)
     {
-      FORCC if (image[row * width + col][c] > clip) break;
-      if (c == colors)
-        continue;
-      FORCC
+      FORC4
       {
-        cam[0][c] = image[row * width + col][c];
-        cam[1][c] = MIN(cam[0][c], clip);
+        cam[i][c] = (float *)(idx + width) + width * (i * 4 + c);
+        lab[i][c] = (float *)(idx + width) + width * (8 + i * 4 + c);
       }
-      for (i = 0; i < 2; i++)
+      sum[i] = (float *)(idx + width) + width * (16 + i);
+    }
+    ushort(*pix)[4] = image + row * width;
+    for (n = col = 0; col < width; col++)
+    {
+      FORCC if (pix[col][c] > clip) break;
+      if (c < colors)
+        idx[n++] = col;
+    }
+    if (!n)
+      continue;
+    FORCC for (k = 0; k < n; k++)
+    {
+      cam[0][c][k] = pix[idx[k]][c];
+      cam[1][c][k] = MIN(cam[0][c][k], clip);
+    }
+    for (i = 0; i < 2; i++)
+    {
+      FORCC
       {
-        FORCC for (lab[i][c] = j = 0; j < colors; j++) lab[i][c] +=
-            trans[colors - 3][c][j] * cam[i][j];
-        for (sum[i] = 0, c = 1; c < colors; c++)
-          sum[i] += SQR(lab[i][c]);
+        for (k = 0; k < n; k++)
+          lab[i][c][k] = 0;
+        for (j = 0; j < colors; j++)
+          for (k = 0; k < n; k++)
+            lab[i][c][k] += tr[c][j] * cam[i][j][k];
       }
-      chratio = sqrt(sum[1] / sum[0]);
+      for (k = 0; k < n; k++)
+        sum[i][k] = 0;
       for (c = 1; c < colors; c++)
-        lab[0][c] *= chratio;
-      FORCC for (cam[0][c] = j = 0; j < colors; j++) cam[0][c] +=
-          itrans[colors - 3][c][j] * lab[0][j];
-      FORCC image[row * width + col][c] = cam[0][c] / colors;
+        for (k = 0; k < n; k++)
+          sum[i][k] += SQR(lab[i][c][k]);
     }
+    float *chratio = sum[1];
+    for (k = 0; k < n; k++)
+      chratio[k] = sqrt(sum[1][k] / sum[0][k]);
+    for (c = 1; c < colors; c++)
+      for (k = 0; k < n; k++)
+        lab[0][c][k] *= chratio[k];
+    FORCC
+    {
+      for (k = 0; k < n; k++)
+        cam[0][c][k] = 0;
+      for (j = 0; j < colors; j++)
+        for (k = 0; k < n; k++)
+          cam[0][c][k] += itr[c][j] * lab[0][j][k];
+    }
+    FORCC for (k = 0; k < n; k++) pix[idx[k]][c] = cam[0][c][k] / colors;
+  }
+  free_omp_buffers(buffers, buffer_count);
   RUN_CALLBACK(LIBRAW_PROGRESS_HIGHLIGHTS, 1, 2);
 }
 
 #define SCALE (4 >> shrink)
 void LibRaw::recover_highlights()
 {
-  float *map, sum, wgt, grow;
+  float *map, *grown, sum, wgt, grow;
   int hsat[4], count, spread, change, val, i;
   unsigned high, wide, mrow, mcol, row, col, kc, c, d, y, x;
   ushort *pixel;
@@ -332,12 +499,18 @@ void LibRaw::recover_highlights()
       kc = c;
   high = height / SCALE;
   wide = width / SCALE;
-  map = (float *)calloc(high, wide * sizeof *map);
+  map = (float *)calloc(high, 2 * wide * sizeof *map);
   merror(map, "recover_highlights()");
+  grown = map + high * wide;
   FORC(unsigned(colors)) if (c != kc)
   {
     RUN_CALLBACK(LIBRAW_PROGRESS_HIGHLIGHTS, c - 1, colors - 1);
     memset(map, 0, high * wide * sizeof *map);
+#if defined(LIBRAW_USE_OPENMP)
+#pragma omp parallel for default(shared)                                       \
+    private(mcol, row, col, pixel, sum, wgt, count)                            \
+    num_threads(process_threads())
+#endif
     for (mrow = 0; mrow < high; mrow++)
       for (mcol = 0; mcol < wide; mcol++)
       {
@@ -356,11 +529,19 @@ void LibRaw::recover_highlights()
         if (count == SCALE * SCALE)
           map[mrow * wide + mcol] = sum / wgt;
       }
+    /* every pass grows the map by one cell from the cells set before it:
+       new values go to grown[] and are merged after the pass */
     for (spread = 32 / grow; spread--;)
     {
+      change = 0;
+#if defined(LIBRAW_USE_OPENMP)
+#pragma omp parallel for default(shared) private(mcol, sum, count, d, y, x)    \
+    reduction(| : change) num_threads(process_threads())
+#endif
       for (mrow = 0; mrow < high; mrow++)
         for (mcol = 0; mcol < wide; mcol++)
         {
+          grown[mrow * wide + mcol] = 0;
           if (map[mrow * wide + mcol])
             continue;
           sum = count = 0;
@@ -375,20 +556,24 @@ void LibRaw::recover_highlights()
             }
           }
           if (count > 3)
-            map[mrow * wide + mcol] = -(sum + grow) / (count + grow);
-        }
-      for (change = i = 0; i < int(high * wide); i++)
-        if (map[i] < 0)
-        {
-          map[i] = -map[i];
-          change = 1;
+          {
+            grown[mrow * wide + mcol] = (sum + grow) / (count + grow);
+            change = 1;
+          }
         }
       if (!change)
         break;
+      for (i = 0; i < int(high * wide); i++)
+        if (grown[i])
+          map[i] = grown[i];
     }
     for (i = 0; i < int(high * wide); i++)
       if (map[i] == 0)
         map[i] = 1;
+#if defined(LIBRAW_USE_OPENMP)
+#pragma omp parallel for default(shared) private(mcol, row, col, pixel, val)  \
+    num_threads(process_threads())
+#endif
     for (mrow = 0; mrow < high; mrow++)
       for (mcol = 0; mcol < wide; mcol++)
       {
@@ -21,6 +21,13 @@ int LibRaw::dcraw_process(void)
   return LIBRAW_NOT_IMPLEMENTED;
 }
 
+int LibRaw::begin_render_session() { return LIBRAW_NOT_IMPLEMENTED; }
+void LibRaw::end_render_session() {}
+int LibRaw::set_output_buffer(libraw_output_buffer_t *)
+{
+  return LIBRAW_NOT_IMPLEMENTED;
+}
+
 void LibRaw::fuji_rotate() {}
 void LibRaw::convert_to_rgb_loop(float out_cam[3][4]) {}
 libraw_processed_image_t *LibRaw::dcraw_make_mem_image(int *) {
@@ -29,6 +29,7 @@ void LibRaw::exp_bef(float shift, float smooth)
     smooth = 1.0;
 
   unsigned short *lut = (ushort *)malloc((TBLN + 1) * sizeof(unsigned short));
+  merror(lut, "exp_bef()");
 
   if (shift <= 1.0)
   {
@@ -51,6 +52,9 @@ void LibRaw::exp_bef(float shift, float smooth)
               (x2 + 2.0f * x1 - 3.0f * sq3x);
     float A = (shift - B) * 3.0f * powf(x1 * x1, 1.0f / 3.0f);
     float CC = y2 - A * powf(x2, 1.0f / 3.0f) - B * x2;
+#if defined(LIBRAW_USE_OPENMP)
+#pragma omp parallel for default(shared) num_threads(process_threads())
+#endif
     for (int i = 0; i <= TBLN; i++)
     {
       float X = (float)i;
@@ -61,7 +65,11 @@ void LibRaw::exp_bef(float shift, float smooth)
         lut[i] = Y < 0 ? 0 : (Y > TBLN ? TBLN : (unsigned short)(Y));
     }
   }
-  for (int i = 0; i < S.height * S.width; i++)
+  int npixels = S.height * S.width;
+#if defined(LIBRAW_USE_OPENMP)
+#pragma omp parallel for default(shared) num_threads(process_threads())
+#endif
+  for (int i = 0; i < npixels; i++)
   {
     imgdata.image[i][0] = lut[imgdata.image[i][0]];
     imgdata.image[i][1] = lut[imgdata.image[i][1]];
@@ -97,7 +97,16 @@ void LibRaw::convert_to_rgb()
         for (out_cam[i][j] = k = 0; k < 3; k++)
           out_cam[i][j] += out_rgb[output_color - 1][i][k] * rgb_cam[k][j];
   }
-  convert_to_rgb_loop(out_cam);
+  libraw_output_buffer_t *ob = libraw_internal_data.output_data.outbuf;
+  /* without auto brightness the output curve is known now: write the
+     buffer in the same pass; linear output needs no curve. Not if image
+     is changed later by post_converttorgb_cb or stretch() */
+  if (ob && !callbacks.post_converttorgb_cb &&
+      ((highlight & ~2) || no_auto_bright || output_buffer_linear()) &&
+      !(use_fuji_rotate && pixel_aspect != 1) && output_buffer_fits())
+    convert_to_rgb_output(out_cam);
+  else
+    convert_to_rgb_loop(out_cam);
 
   if (colors == 4 && output_color)
     colors = 3;
@@ -105,56 +114,67 @@ void LibRaw::convert_to_rgb()
   RUN_CALLBACK(LIBRAW_PROGRESS_CONVERT_RGB, 1, 2);
 }
 
-void LibRaw::scale_colors()
+int LibRaw::scale_colors_auto_wb_needed()
+{
+  return use_auto_wb ||
+         (use_camera_wb &&
+          (cam_mul[0] < -0.5 // LibRaw 0.19 and older: fallback to auto only if cam_mul[0] is set to -1
+           || (cam_mul[0] <= 0.00001f // New default: fallback to auto if no cam_mul parsed from metadata
+               && !(imgdata.rawparams.options & LIBRAW_RAWOPTIONS_CAMERAWB_FALLBACK_TO_DAYLIGHT))));
+}
+
+void LibRaw::scale_colors_auto_wb(float auto_mul[4])
 {
-  unsigned bottom, right, size, row, col, ur, uc, i, x, y, c, sum[8];
+  unsigned bottom, right, row, col, x, y, c, sum[8];
   int val;
-  double dsum[8], dmin, dmax;
-  float scale_mul[4], fr, fc;
-  ushort *img = 0, *pix;
+  double dsum[8];
 
-  RUN_CALLBACK(LIBRAW_PROGRESS_SCALE_COLORS, 0, 2);
+  memset(dsum, 0, sizeof dsum);
+  bottom = MIN(greybox[1] + greybox[3], height);
+  right = MIN(greybox[0] + greybox[2], width);
+  for (row = greybox[1]; row < bottom; row += 8)
+    for (col = greybox[0]; col < right; col += 8)
+    {
+      memset(sum, 0, sizeof sum);
+      for (y = row; y < row + 8 && y < bottom; y++)
+        for (x = col; x < col + 8 && x < right; x++)
+          FORC4
+          {
+            if (filters)
+            {
+              c = fcol(y, x);
+              val = BAYER2(y, x);
+            }
+            else
+              val = image[y * width + x][c];
+            if (val > (int)maximum - 25)
+              goto skip_block;
+            if ((val -= cblack[c]) < 0)
+              val = 0;
+            sum[c] += val;
+            sum[c + 4]++;
+            if (filters)
+              break;
+          }
+      FORC(8) dsum[c] += sum[c];
+    skip_block:;
+    }
+  FORC4 auto_mul[c] = dsum[c] ? dsum[c + 4] / dsum[c] : 0;
+}
+
+/* white balance and scale multipliers, also normalizes pre_mul and
+   subtracts black from maximum */
+void LibRaw::scale_colors_multipliers(const float auto_mul[4],
+                                      float scale_mul[4])
+{
+  unsigned row, col, c, sum[8];
+  int val;
+  double dmin, dmax;
 
   if (user_mul[0])
     memcpy(pre_mul, user_mul, sizeof pre_mul);
-  if (use_auto_wb || (use_camera_wb && 
-      (cam_mul[0] < -0.5  // LibRaw 0.19 and older: fallback to auto only if cam_mul[0] is set to -1
-          || (cam_mul[0] <= 0.00001f  // New default: fallback to auto if no cam_mul parsed from metadata
-              && !(imgdata.rawparams.options & LIBRAW_RAWOPTIONS_CAMERAWB_FALLBACK_TO_DAYLIGHT))
-          )))
-  {
-    memset(dsum, 0, sizeof dsum);
-    bottom = MIN(greybox[1] + greybox[3], height);
-    right = MIN(greybox[0] + greybox[2], width);
-    for (row = greybox[1]; row < bottom; row += 8)
-      for (col = greybox[0]; col < right; col += 8)
-      {
-        memset(sum, 0, sizeof sum);
-        for (y = row; y < row + 8 && y < bottom; y++)
-          for (x = col; x < col + 8 && x < right; x++)
-            FORC4
-            {
-              if (filters)
-              {
-                c = fcol(y, x);
-                val = BAYER2(y, x);
-              }
-              else
-                val = image[y * width + x][c];
-              if (val > (int)maximum - 25)
-                goto skip_block;
-              if ((val -= cblack[c]) < 0)
-                val = 0;
-              sum[c] += val;
-              sum[c + 4]++;
-              if (filters)
-                break;
-            }
-        FORC(8) dsum[c] += sum[c];
-      skip_block:;
-      }
-    FORC4 if (dsum[c]) pre_mul[c] = dsum[c + 4] / dsum[c];
-  }
+  if (scale_colors_auto_wb_needed())
+    FORC4 if (auto_mul[c]) pre_mul[c] = auto_mul[c];
   if (use_camera_wb && cam_mul[0] > 0.00001f)
   {
     memset(sum, 0, sizeof sum);
@@ -201,8 +221,11 @@ void LibRaw::scale_colors()
     if (dmax < pre_mul[c])
       dmax = pre_mul[c];
   }
-  if (!highlight)
+  /* linear output keeps highlights: 1.0 is white level of clipped scaling */
+  if (!highlight && !output_buffer_linear())
     dmax = dmin;
+  libraw_internal_data.output_data.linear_scale =
+      dmin > 0.00001 ? dmax / dmin : 1.f;
   if (dmax > 0.00001 && maximum > 0)
     FORC4 scale_mul[c] = (pre_mul[c] /= dmax) * 65535.0 / maximum;
   else
@@ -214,6 +237,27 @@ void LibRaw::scale_colors()
         cblack[6 + c / 2 % cblack[4] * cblack[5] + c % 2 % cblack[5]];
     cblack[4] = cblack[5] = 0;
   }
+}
+
+void LibRaw::scale_colors()
+{
+  unsigned size, row, col, ur, uc, i, c;
+  float scale_mul[4], auto_mul[4] = {0, 0, 0, 0}, fr, fc;
+  ushort *img = 0, *pix;
+
+  RUN_CALLBACK(LIBRAW_PROGRESS_SCALE_COLORS, 0, 2);
+
+  /* render session keeps auto WB for re-rendering with other WB settings */
+  int caching = render_cache && render_cache->building;
+  if (caching || scale_colors_auto_wb_needed())
+    scale_colors_auto_wb(auto_mul);
+  scale_colors_multipliers(auto_mul, scale_mul);
+  if (caching)
+  {
+    memcpy(render_cache->auto_mul, auto_mul, sizeof(auto_mul));
+    memcpy(render_cache->scale_mul, scale_mul, sizeof(scale_mul));
+  }
+
   size = iheight * iwidth;
   scale_colors_loop(scale_mul);
   if ((aber[0] != 1 || aber[2] != 1) && colors == 3)
@@ -253,11 +297,10 @@ void LibRaw::scale_colors()
 // green equilibration
 void LibRaw::green_matching()
 {
-  int i, j;
+  int i, j, k, b;
   double m1, m2, c1, c2;
   int o1_1, o1_2, o1_3, o1_4;
   int o2_1, o2_2, o2_3, o2_4;
-  ushort(*img)[4];
   const int margin = 3;
   int oj = 2, oi = 2;
   float f;
@@ -271,37 +314,95 @@ void LibRaw::green_matching()
   if (FC(oj, oi) != 3)
     oj--;
 
-  img = (ushort(*)[4])calloc(height * width, sizeof *image);
-  merror(img, "green_matching()");
-  memcpy(img, image, height * width * sizeof *image);
+  /* Only the G3 values of rows oj, oj+2, ... are changed, and only those
+     are read back, so the original values of three such rows are enough.
+     Rows are split into bands; the rows next to a band, changed by the
+     neighbour bands, are saved first */
+  int rows = (height - margin - oj + 1) / 2;
+  if (rows < 1)
+    return;
+#if defined(LIBRAW_USE_OPENMP)
+  int nbands = MAX(1, MIN(process_threads(), rows / 16));
+#else
+  int nbands = 1;
+#endif
+  char **buffers = malloc_omp_buffers(nbands, 4 * width * sizeof(ushort),
+                                      "green_matching()");
 
-  for (j = oj; j < height - margin; j += 2)
-    for (i = oi; i < width - margin; i += 2)
+#if defined(LIBRAW_USE_OPENMP)
+#pragma omp parallel for default(shared) private(i) num_threads(nbands)
+#endif
+  for (b = 0; b < nbands; b++)
+  {
+    ushort *saved = (ushort *)buffers[b];
+    int j0 = oj + 2 * (rows * b / nbands);
+    int j1 = oj + 2 * (rows * (b + 1) / nbands);
+    if (j0 == j1)
+      continue;
+    for (i = oi - 2; i < width; i += 2)
     {
-      o1_1 = img[(j - 1) * width + i - 1][1];
-      o1_2 = img[(j - 1) * width + i + 1][1];
-      o1_3 = img[(j + 1) * width + i - 1][1];
-      o1_4 = img[(j + 1) * width + i + 1][1];
-      o2_1 = img[(j - 2) * width + i][3];
-      o2_2 = img[(j + 2) * width + i][3];
-      o2_3 = img[j * width + i - 2][3];
-      o2_4 = img[j * width + i + 2][3];
-
-      m1 = (o1_1 + o1_2 + o1_3 + o1_4) / 4.0;
-      m2 = (o2_1 + o2_2 + o2_3 + o2_4) / 4.0;
+      saved[i] = image[(j0 - 2) * width + i][3];
+      saved[width + i] = image[j1 * width + i][3];
+    }
+  }
 
-      c1 = (abs(o1_1 - o1_2) + abs(o1_1 - o1_3) + abs(o1_1 - o1_4) +
-            abs(o1_2 - o1_3) + abs(o1_3 - o1_4) + abs(o1_2 - o1_4)) /
-           6.0;
-      c2 = (abs(o2_1 - o2_2) + abs(o2_1 - o2_3) + abs(o2_1 - o2_4) +
-            abs(o2_2 - o2_3) + abs(o2_3 - o2_4) + abs(o2_2 - o2_4)) /
-           6.0;
-      if ((img[j * width + i][3] < maximum * 0.95) && (c1 < maximum * thr) &&
-          (c2 < maximum * thr))
+#if defined(LIBRAW_USE_OPENMP)
+#pragma omp parallel for default(shared)                                       \
+    private(i, j, k, m1, m2, c1, c2, o1_1, o1_2, o1_3, o1_4, o2_1, o2_2, o2_3,  \
+            o2_4, f) num_threads(nbands)
+#endif
+  for (b = 0; b < nbands; b++)
+  {
+    ushort *prev = (ushort *)buffers[b], *cur = prev + width * 2,
+           *next = NULL, *spare = prev + width * 3;
+    int k1 = rows * (b + 1) / nbands;
+    k = rows * b / nbands;
+    if (k == k1)
+      continue;
+    for (i = oi - 2; i < width; i += 2)
+      cur[i] = image[(oj + 2 * k) * width + i][3];
+    for (; k < k1; k++)
+    {
+      j = oj + 2 * k;
+      if (k + 1 == k1)
+        next = (ushort *)buffers[b] + width;
+      else
       {
-        f = image[j * width + i][3] * m1 / m2;
-        image[j * width + i][3] = f > 0xffff ? 0xffff : f;
+        next = spare;
+        for (i = oi - 2; i < width; i += 2)
+          next[i] = image[(j + 2) * width + i][3];
       }
+      for (i = oi; i < width - margin; i += 2)
+      {
+        o1_1 = image[(j - 1) * width + i - 1][1];
+        o1_2 = image[(j - 1) * width + i + 1][1];
+        o1_3 = image[(j + 1) * width + i - 1][1];
+        o1_4 = image[(j + 1) * width + i + 1][1];
+        o2_1 = prev[i];
+        o2_2 = next[i];
+        o2_3 = cur[i - 2];
+        o2_4 = cur[i + 2];
+
+        m1 = (o1_1 + o1_2 + o1_3 + o1_4) / 4.0;
+        m2 = (o2_1 + o2_2 + o2_3 + o2_4) / 4.0;
+
+        c1 = (abs(o1_1 - o1_2) + abs(o1_1 - o1_3) + abs(o1_1 - o1_4) +
+              abs(o1_2 - o1_3) + abs(o1_3 - o1_4) + abs(o1_2 - o1_4)) /
+             6.0;
+        c2 = (abs(o2_1 - o2_2) + abs(o2_1 - o2_3) + abs(o2_1 - o2_4) +
+              abs(o2_2 - o2_3) + abs(o2_3 - o2_4) + abs(o2_2 - o2_4)) /
+             6.0;
+        if ((cur[i] < maximum * 0.95) && (c1 < maximum * thr) &&
+            (c2 < maximum * thr))
+        {
+          f = cur[i] * m1 / m2;
+          image[j * width + i][3] = f > 0xffff ? 0xffff : f;
+        }
+      }
+      spare = prev;
+      prev = cur;
+      cur = next;
     }
-  free(img);
+  }
+  free_omp_buffers(buffers, nbands);
 }
@@ -20,5 +20,7 @@
 void LibRaw::copy_fuji_uncropped(unsigned short cblack[4],
 				 unsigned short *dmaxp) {}
 void LibRaw::copy_bayer(unsigned short cblack[4], unsigned short *dmaxp){}
+void LibRaw::copy_bayer_binned(unsigned short cblack[4],
+                               unsigned short *dmaxp){}
 void LibRaw::raw2image_start(){}
 
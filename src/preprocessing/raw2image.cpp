@@ -43,11 +43,31 @@ void LibRaw::raw2image_start()
 
   // adjust for half mode!
   IO.shrink =
-      P1.filters &&
-      (O.half_size || ((O.threshold || O.aber[0] != 1 || O.aber[2] != 1)));
+      P1.filters && (O.half_size || O.preview_scale > 1 ||
+                     ((O.threshold || O.aber[0] != 1 || O.aber[2] != 1)));
 
   S.iheight = (S.height + IO.shrink) >> IO.shrink;
   S.iwidth = (S.width + IO.shrink) >> IO.shrink;
+
+  // preview mode: one image pixel per preview_bin x preview_bin CFA block
+  IO.preview_bin = preview_bin_factor();
+  if (IO.preview_bin)
+  {
+    S.iheight = MAX(1, S.height / IO.preview_bin);
+    S.iwidth = MAX(1, S.width / IO.preview_bin);
+  }
+}
+
+int LibRaw::preview_bin_factor()
+{
+  int n = O.preview_scale;
+  if (n < 2 || !IO.shrink || IO.fuji_width || O.bad_pixels || O.dark_frame)
+    return 0; // plain half_size
+  if (P1.filters == LIBRAW_XTRANS)
+    n = MAX(n, 3); // 2x2 X-Trans blocks may miss red or blue
+  else if (P1.filters < 1000)
+    return 0;
+  return MIN(n, MIN(int(S.width), int(S.height)));
 }
 
 int LibRaw::raw2image(void)
@@ -126,6 +146,12 @@ int LibRaw::raw2image(void)
           }
         }
       }
+      else if (IO.preview_bin)
+      {
+        unsigned short cblack[4] = {0, 0, 0, 0};
+        unsigned short dmax = 0;
+        copy_bayer_binned(cblack, &dmax);
+      }
       else
       {
         int row, col;
@@ -190,6 +216,13 @@ int LibRaw::raw2image(void)
       canon_600_correct();
     }
 
+    if (IO.preview_bin)
+    {
+      /* binned image looks like half_size output of a smaller sensor */
+      S.height = S.iheight * 2;
+      S.width = S.iwidth * 2;
+    }
+
     imgdata.progress_flags =
         LIBRAW_PROGRESS_START | LIBRAW_PROGRESS_OPEN |
         LIBRAW_PROGRESS_RAW2_IMAGE | LIBRAW_PROGRESS_IDENTIFY |
@@ -206,38 +239,148 @@ int LibRaw::raw2image(void)
   }
 }
 
-void LibRaw::copy_fuji_uncropped(unsigned short cblack[4],
-                                 unsigned short *dmaxp)
+struct copy_rows_task_t
+{
+  LibRaw *self;
+  unsigned short *cblack;
+  unsigned short *rowmax;
+};
+
+void LibRaw::copy_fuji_uncropped_task(void *t, int row)
+{
+  copy_rows_task_t *task = (copy_rows_task_t *)t;
+  task->rowmax[row] = task->self->copy_fuji_uncropped_row(row, task->cblack);
+}
+
+unsigned short LibRaw::copy_fuji_uncropped_row(int row, unsigned short cblack[4])
 {
-#if defined(LIBRAW_USE_OPENMP)
-#pragma omp parallel for schedule(dynamic) default(none) firstprivate(cblack) shared(dmaxp)
-#endif
-  for (int row = 0; row < int(S.raw_height) - int(S.top_margin) * 2; row++)
+  int col;
+  unsigned short ldmax = 0;
+  for (col = 0;
+       col < IO.fuji_width << !libraw_internal_data.unpacker_data.fuji_layout
+       && col + int(S.left_margin) < int(S.raw_width);
+       col++)
   {
-    int col;
-    unsigned short ldmax = 0;
-    for (col = 0;
-         col < IO.fuji_width << !libraw_internal_data.unpacker_data.fuji_layout
-         && col + int(S.left_margin) < int(S.raw_width);
-         col++)
+    unsigned r, c;
+    if (libraw_internal_data.unpacker_data.fuji_layout)
     {
-      unsigned r, c;
-      if (libraw_internal_data.unpacker_data.fuji_layout)
+      r = IO.fuji_width - 1 - col + (row >> 1);
+      c = col + ((row + 1) >> 1);
+    }
+    else
+    {
+      r = IO.fuji_width - 1 + row - (col >> 1);
+      c = row + ((col + 1) >> 1);
+    }
+    if (r < S.height && c < S.width)
+    {
+      unsigned short val =
+          imgdata.rawdata.raw_image[(row + S.top_margin) * S.raw_pitch / 2 +
+                                    (col + S.left_margin)];
+      int cc = FC(r, c);
+      if (val > cblack[cc])
       {
-        r = IO.fuji_width - 1 - col + (row >> 1);
-        c = col + ((row + 1) >> 1);
+        val -= cblack[cc];
+        if (val > ldmax)
+          ldmax = val;
       }
       else
+        val = 0;
+      imgdata.image[((r) >> IO.shrink) * S.iwidth + ((c) >> IO.shrink)][cc] =
+          val;
+    }
+  }
+  return ldmax;
+}
+
+void LibRaw::copy_fuji_uncropped(unsigned short cblack[4],
+                                 unsigned short *dmaxp)
+{
+  int rows = int(S.raw_height) - int(S.top_margin) * 2;
+  if (rows < 1)
+    return;
+  std::vector<unsigned short> rowmax(rows, 0);
+  copy_rows_task_t task = {this, cblack, rowmax.data()};
+  run_parallel(rows, process_threads(), copy_fuji_uncropped_task, &task);
+  for (int row = 0; row < rows; row++)
+    if (*dmaxp < rowmax[row])
+      *dmaxp = rowmax[row];
+}
+
+void LibRaw::copy_bayer_task(void *t, int row)
+{
+  copy_rows_task_t *task = (copy_rows_task_t *)t;
+  task->rowmax[row] = task->self->copy_bayer_row(row, task->cblack);
+}
+
+unsigned short LibRaw::copy_bayer_row(int row, unsigned short cblack[4])
+{
+  int col;
+  unsigned short ldmax = 0;
+  for (col = 0; col < S.width && col + S.left_margin < S.raw_width; col++)
+  {
+    unsigned short val =
+        imgdata.rawdata.raw_image[(row + S.top_margin) * S.raw_pitch / 2 +
+                                  (col + S.left_margin)];
+    int cc = fcol(row, col);
+    if (val > cblack[cc])
+    {
+      val -= cblack[cc];
+      if (val > ldmax)
+        ldmax = val;
+    }
+    else
+      val = 0;
+    imgdata.image[((row) >> IO.shrink) * S.iwidth + ((col) >> IO.shrink)][cc] = val;
+  }
+  return ldmax;
+}
+
+void LibRaw::copy_bayer(unsigned short cblack[4], unsigned short *dmaxp)
+{
+  // Both cropped and uncropped
+  int maxHeight = MIN(int(S.height),int(S.raw_height)-int(S.top_margin));
+  if (maxHeight < 1)
+    return;
+  std::vector<unsigned short> rowmax(maxHeight, 0);
+  copy_rows_task_t task = {this, cblack, rowmax.data()};
+  run_parallel(maxHeight, process_threads(), copy_bayer_task, &task);
+  for (int row = 0; row < maxHeight; row++)
+    if (*dmaxp < rowmax[row])
+      *dmaxp = rowmax[row];
+}
+
+void LibRaw::copy_bayer_binned_task(void *t, int row)
+{
+  copy_rows_task_t *task = (copy_rows_task_t *)t;
+  task->rowmax[row] = task->self->copy_bayer_binned_row(row, task->cblack);
+}
+
+/* Averages same-color sites of each preview_bin x preview_bin block into
+   one image pixel; ldmax is tracked on single sites as in copy_bayer_row() */
+unsigned short LibRaw::copy_bayer_binned_row(int brow,
+                                             unsigned short cblack[4])
+{
+  int n = IO.preview_bin;
+  int rows = MIN(int(S.height), int(S.raw_height) - int(S.top_margin));
+  int cols = MIN(int(S.width), int(S.raw_width) - int(S.left_margin));
+  int row, col, bcol, c;
+  int r0 = brow * n, r1 = MIN(r0 + n, rows);
+  unsigned short ldmax = 0;
+  for (bcol = 0; bcol < S.iwidth; bcol++)
+  {
+    INT64 sum[4] = {0, 0, 0, 0};
+    unsigned cnt[4] = {0, 0, 0, 0};
+    int c0 = bcol * n, c1 = MIN(c0 + n, cols);
+    for (row = r0; row < r1; row++)
+    {
+      unsigned short *src =
+          imgdata.rawdata.raw_image +
+          (row + S.top_margin) * S.raw_pitch / 2 + S.left_margin;
+      for (col = c0; col < c1; col++)
       {
-        r = IO.fuji_width - 1 + row - (col >> 1);
-        c = row + ((col + 1) >> 1);
-      }
-      if (r < S.height && c < S.width)
-      {
-        unsigned short val =
-            imgdata.rawdata.raw_image[(row + S.top_margin) * S.raw_pitch / 2 +
-                                      (col + S.left_margin)];
-        int cc = FC(r, c);
+        unsigned short val = src[col];
+        int cc = fcol(row, col);
         if (val > cblack[cc])
         {
           val -= cblack[cc];
@@ -246,61 +389,60 @@ void LibRaw::copy_fuji_uncropped(unsigned short cblack[4],
         }
         else
           val = 0;
-        imgdata.image[((r) >> IO.shrink) * S.iwidth + ((c) >> IO.shrink)][cc] =
-            val;
+        sum[cc] += val;
+        cnt[cc]++;
       }
     }
-#if defined(LIBRAW_USE_OPENMP)
-#pragma omp critical(dataupdate)
-#endif
-    {
-      if (*dmaxp < ldmax)
-        *dmaxp = ldmax;
-    }
+    unsigned short *pix = imgdata.image[brow * S.iwidth + bcol];
+    for (c = 0; c < 4; c++)
+      if (cnt[c])
+        pix[c] = (unsigned short)((sum[c] + cnt[c] / 2) / cnt[c]);
   }
+  return ldmax;
 }
 
-void LibRaw::copy_bayer(unsigned short cblack[4], unsigned short *dmaxp)
+void LibRaw::copy_bayer_binned(unsigned short cblack[4],
+                               unsigned short *dmaxp)
 {
-  // Both cropped and uncropped
-  int maxHeight = MIN(int(S.height),int(S.raw_height)-int(S.top_margin));
-#if defined(LIBRAW_USE_OPENMP)
-#pragma omp parallel for schedule(dynamic) default(none) shared(dmaxp) firstprivate(cblack, maxHeight)
-#endif
-  for (int row = 0; row < maxHeight ; row++)
+  int rows = S.iheight;
+  std::vector<unsigned short> rowmax(rows, 0);
+  copy_rows_task_t task = {this, cblack, rowmax.data()};
+  run_parallel(rows, process_threads(), copy_bayer_binned_task, &task);
+  for (int row = 0; row < rows; row++)
+    if (*dmaxp < rowmax[row])
+      *dmaxp = rowmax[row];
+}
+
+/* params.cropbox if set, else rawparams.roi with LIBRAW_ROI_MARGIN (cut
+   off by crop_roi_margin() after interpolation). Returns 0 if no crop */
+int LibRaw::process_cropbox(unsigned box[4])
+{
+  unsigned *roi = imgdata.rawparams.roi;
+  if (~O.cropbox[2] && ~O.cropbox[3])
   {
-    int col;
-    unsigned short ldmax = 0;
-    for (col = 0; col < S.width && col + S.left_margin < S.raw_width; col++)
-    {
-      unsigned short val =
-          imgdata.rawdata.raw_image[(row + S.top_margin) * S.raw_pitch / 2 +
-                                    (col + S.left_margin)];
-      int cc = fcol(row, col);
-      if (val > cblack[cc])
-      {
-        val -= cblack[cc];
-        if (val > ldmax)
-          ldmax = val;
-      }
-      else
-        val = 0;
-      imgdata.image[((row) >> IO.shrink) * S.iwidth + ((col) >> IO.shrink)][cc] = val;
-    }
-#if defined(LIBRAW_USE_OPENMP)
-#pragma omp critical(dataupdate)
-#endif
-    {
-      if (*dmaxp < ldmax)
-        *dmaxp = ldmax;
-    }
+    memmove(box, O.cropbox, sizeof(O.cropbox));
+    return 1;
+  }
+  if (!roi[2] || !roi[3])
+    return 0;
+  if (IO.fuji_width)
+  {
+    memmove(box, roi, sizeof(imgdata.rawparams.roi));
+    return 1;
   }
+  box[0] = roi[0] > LIBRAW_ROI_MARGIN ? roi[0] - LIBRAW_ROI_MARGIN : 0;
+  box[1] = roi[1] > LIBRAW_ROI_MARGIN ? roi[1] - LIBRAW_ROI_MARGIN : 0;
+  box[2] = roi[2] + roi[0] - box[0] + LIBRAW_ROI_MARGIN;
+  box[3] = roi[3] + roi[1] - box[1] + LIBRAW_ROI_MARGIN;
+  return 1;
 }
 
 int LibRaw::raw2image_ex(int do_subtract_black)
 {
 
   CHECK_ORDER_LOW(LIBRAW_PROGRESS_LOAD_RAW);
+  if (!decode_roi_covers())
+    return LIBRAW_OUT_OF_ORDER_CALL;
 
   try
   {
@@ -323,12 +465,13 @@ int LibRaw::raw2image_ex(int do_subtract_black)
 
     // process cropping
     int do_crop = 0;
-    if (~O.cropbox[2] && ~O.cropbox[3])
+    unsigned cropbox[4];
+    if (process_cropbox(cropbox))
     {
       int crop[4], c, filt;
       for (int c = 0; c < 4; c++)
       {
-        crop[c] = O.cropbox[c];
+        crop[c] = cropbox[c];
         if (crop[c] < 0)
           crop[c] = 0;
       }
@@ -370,6 +513,11 @@ int LibRaw::raw2image_ex(int do_subtract_black)
 
       S.iheight = (S.height + IO.shrink) >> IO.shrink;
       S.iwidth = (S.width + IO.shrink) >> IO.shrink;
+      if (IO.preview_bin)
+      {
+        S.iheight = MAX(1, S.height / IO.preview_bin);
+        S.iwidth = MAX(1, S.width / IO.preview_bin);
+      }
       if (!IO.fuji_width && imgdata.idata.filters &&
           imgdata.idata.filters >= 1000)
       {
@@ -479,6 +627,10 @@ int LibRaw::raw2image_ex(int do_subtract_black)
           copy_fuji_uncropped(cblack, &dmax);
         }
       } // end Fuji
+      else if (IO.preview_bin)
+      {
+        copy_bayer_binned(cblack, &dmax);
+      }
       else
       {
         copy_bayer(cblack, &dmax);
@@ -537,6 +689,12 @@ int LibRaw::raw2image_ex(int do_subtract_black)
       canon_600_correct();
     }
 
+    if (IO.preview_bin)
+    {
+      S.height = S.iheight * 2;
+      S.width = S.iwidth * 2;
+    }
+
     if (do_subtract_black)
     {
       C.data_maximum = (int)dmax;
@@ -17,6 +17,76 @@
  */
 
 #include "../../internal/dcraw_defs.h"
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace
+{
+struct adobe_coeff_t
+{
+  unsigned m_idx;
+  const char *prefix;
+  int t_black, t_maximum, trans[12];
+};
+
+/*
+   Table entries are bucketed by (maker, lowercased first char of prefix).
+   Buckets keep table order, so the first matching entry still wins.
+   Entries with empty prefix match any model and live in bucket char 0.
+ */
+class adobe_coeff_index_t
+{
+  std::vector<unsigned> keys;
+  std::vector<unsigned short> idx;
+
+  static unsigned key(unsigned m_idx, char c)
+  {
+    return (m_idx << 8) | (unsigned char)tolower((unsigned char)c);
+  }
+  int first_match(const adobe_coeff_t *table, unsigned k,
+                  const char *t_model) const
+  {
+    std::vector<unsigned>::const_iterator it =
+        std::lower_bound(keys.begin(), keys.end(), k);
+    for (; it != keys.end() && *it == k; ++it)
+    {
+      const adobe_coeff_t &e = table[idx[it - keys.begin()]];
+      size_t l = strlen(e.prefix);
+      if (!l || !strncasecmp(t_model, e.prefix, l))
+        return idx[it - keys.begin()];
+    }
+    return -1;
+  }
+
+public:
+  adobe_coeff_index_t(const adobe_coeff_t *table, int n)
+  {
+    std::vector<std::pair<unsigned, unsigned short> > v(n);
+    for (int i = 0; i < n; i++)
+      v[i] = std::make_pair(key(table[i].m_idx, table[i].prefix[0]),
+                            (unsigned short)i);
+    std::sort(v.begin(), v.end());
+    keys.resize(n);
+    idx.resize(n);
+    for (int i = 0; i < n; i++)
+    {
+      keys[i] = v[i].first;
+      idx[i] = v[i].second;
+    }
+  }
+  int find(const adobe_coeff_t *table, unsigned m_idx,
+           const char *t_model) const
+  {
+    int any = first_match(table, key(m_idx, 0), t_model);
+    int named =
+        t_model[0] ? first_match(table, key(m_idx, t_model[0]), t_model) : -1;
+    if (any < 0 || (named >= 0 && named < any))
+      return named;
+    return any;
+  }
+};
+} // namespace
 
 /*
    All matrices are from Adobe DNG Converter unless otherwise noted.
@@ -25,12 +95,7 @@ int LibRaw::adobe_coeff(unsigned make_idx, const char *t_model,
                         int internal_only)
 {
   // clang-format off
-  static const struct
-  {
-	  unsigned m_idx;
-	  const char *prefix;
-	  int t_black, t_maximum, trans[12];
-  } table[] = {
+  static const adobe_coeff_t table[] = {
     { LIBRAW_CAMERAMAKER_Agfa, "DC-833m", 0, 0,
       { 11438,-3762,-1115,-2409,9914,2497,-1227,2295,5300 } }, /* DJC */
 
@@ -1738,42 +1803,38 @@ int LibRaw::adobe_coeff(unsigned make_idx, const char *t_model,
   }
   int rblack = black + bl4 + bl64;
 
-  for (i = 0; i < int(sizeof table / sizeof *table); i++)
+  static const adobe_coeff_index_t cm_index(table,
+                                            sizeof table / sizeof *table);
+
+  if ((i = cm_index.find(table, make_idx, t_model)) >= 0)
   {
-	  if (table[i].m_idx == make_idx)
-	  {
-		  unsigned l = strlen(table[i].prefix);
-		  if (!l ||  !strncasecmp(t_model, table[i].prefix, l))
-		  {
-			  if (!dng_version)
-			  {
-				  if (table[i].t_black > 0)
-				  {
-					  black = (ushort)table[i].t_black;
-					  memset(cblack, 0, sizeof(cblack));
-				  }
-				  else if (table[i].t_black < 0 && rblack == 0)
-				  {
-					  black = (ushort)(-table[i].t_black);
-					  memset(cblack, 0, sizeof(cblack));
-				  }
-				  if (table[i].t_maximum)
-					  maximum = (ushort)table[i].t_maximum;
-			  }
-			  if (table[i].trans[0])
-			  {
-				  for (raw_color = j = 0; j < 12; j++)
-					  if (internal_only)
-						  imgdata.color.cam_xyz[j / 3][j % 3] = table[i].trans[j] / 10000.0;
-					  else
-						  imgdata.color.cam_xyz[j / 3][j % 3] = ((double *)cam_xyz)[j] =
-						  table[i].trans[j] / 10000.0;
-				  if (!internal_only)
-					  cam_xyz_coeff(rgb_cam, cam_xyz);
-			  }
-			  return 1; // CM found
-		  }
-	  }
+    if (!dng_version)
+    {
+      if (table[i].t_black > 0)
+      {
+        black = (ushort)table[i].t_black;
+        memset(cblack, 0, sizeof(cblack));
+      }
+      else if (table[i].t_black < 0 && rblack == 0)
+      {
+        black = (ushort)(-table[i].t_black);
+        memset(cblack, 0, sizeof(cblack));
+      }
+      if (table[i].t_maximum)
+        maximum = (ushort)table[i].t_maximum;
+    }
+    if (table[i].trans[0])
+    {
+      for (raw_color = j = 0; j < 12; j++)
+        if (internal_only)
+          imgdata.color.cam_xyz[j / 3][j % 3] = table[i].trans[j] / 10000.0;
+        else
+          imgdata.color.cam_xyz[j / 3][j % 3] = ((double *)cam_xyz)[j] =
+              table[i].trans[j] / 10000.0;
+      if (!internal_only)
+        cam_xyz_coeff(rgb_cam, cam_xyz);
+    }
+    return 1; // CM found
   }
   return 0; // CM not found
 }
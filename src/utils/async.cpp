@@ -0,0 +1,277 @@
+/* -*- C++ -*-
+ * File: async.cpp
+ * Copyright 2008-2021 LibRaw LLC (info@libraw.org)
+ *
+ * LibRaw_async: background unpack()/dcraw_process() with cancel and progress
+
+LibRaw is free software; you can redistribute it and/or modify
+it under the terms of the one of two licenses as you choose:
+
+1. GNU LESSER GENERAL PUBLIC LICENSE version 2.1
+   (See file LICENSE.LGPL provided in LibRaw distribution archive for details).
+
+2. COMMON DEVELOPMENT AND DISTRIBUTION LICENSE (CDDL) Version 1.0
+   (See file LICENSE.CDDL provided in LibRaw distribution archive for details).
+
+ */
+
+#include "libraw/libraw.h"
+#ifndef LIBRAW_NOTHREADS
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+
+namespace
+{
+struct async_state_t
+{
+#ifndef LIBRAW_NOTHREADS
+  std::mutex lock;
+  std::condition_variable done_cv;
+  std::thread thread;
+#endif
+  unsigned stages;
+  int running, done, cancelled, result;
+  int stage, iteration, expected;
+  progress_callback saved_cb;
+  void *saved_data;
+
+  async_state_t()
+      : stages(0), running(0), done(0), cancelled(0), result(LIBRAW_SUCCESS),
+        stage(0), iteration(0), expected(0), saved_cb(NULL), saved_data(NULL)
+  {
+  }
+
+  /* internal thread of the previous job, if any */
+  void join()
+  {
+#ifndef LIBRAW_NOTHREADS
+    if (thread.joinable())
+      thread.join();
+#endif
+  }
+};
+
+#ifndef LIBRAW_NOTHREADS
+typedef std::unique_lock<std::mutex> async_lock_t;
+#else
+struct async_lock_t
+{
+  async_lock_t(int) {}
+};
+#endif
+} // namespace
+
+#ifndef LIBRAW_NOTHREADS
+#define ASYNC_LOCK(s) async_lock_t lk((s)->lock)
+#else
+#define ASYNC_LOCK(s) async_lock_t lk(0)
+#endif
+
+LibRaw_async::LibRaw_async(LibRaw *processor) : lr(processor), state(NULL)
+{
+  state = new async_state_t;
+}
+
+LibRaw_async::~LibRaw_async()
+{
+  cancel();
+  wait(-1);
+  delete static_cast<async_state_t *>(state);
+}
+
+int LibRaw_async::start(unsigned stages)
+{
+  async_state_t *s = static_cast<async_state_t *>(state);
+  if (!lr || !(stages & LIBRAW_ASYNC_ALL))
+    return LIBRAW_OUT_OF_ORDER_CALL;
+  {
+    ASYNC_LOCK(s);
+    if (s->running)
+      return LIBRAW_OUT_OF_ORDER_CALL;
+    s->join();
+    s->stages = stages;
+    s->running = 1;
+    s->done = s->cancelled = 0;
+    s->result = LIBRAW_SUCCESS;
+    s->stage = s->iteration = s->expected = 0;
+  }
+
+  if (lr->callbacks.async_cb)
+  {
+    (*lr->callbacks.async_cb)(lr->callbacks.async_data, job, this);
+    return LIBRAW_SUCCESS;
+  }
+#ifndef LIBRAW_NOTHREADS
+  try
+  {
+    std::thread t(job, this, 0);
+    ASYNC_LOCK(s);
+    s->thread.swap(t);
+  }
+  catch (...)
+  {
+    ASYNC_LOCK(s);
+    s->running = 0;
+    return LIBRAW_UNSUFFICIENT_MEMORY;
+  }
+#else
+  job(this, 0);
+#endif
+  return LIBRAW_SUCCESS;
+}
+
+int LibRaw_async::run(unsigned stages)
+{
+  int ret = LIBRAW_SUCCESS;
+  if ((stages & LIBRAW_ASYNC_UNPACK) && (ret = lr->unpack()) != LIBRAW_SUCCESS)
+    return ret;
+  if (stages & LIBRAW_ASYNC_PROCESS)
+    ret = lr->dcraw_process();
+  return ret;
+}
+
+void LibRaw_async::job(void *data, int)
+{
+  LibRaw_async *self = static_cast<LibRaw_async *>(data);
+  async_state_t *s = static_cast<async_state_t *>(self->state);
+  LibRaw *lr = self->lr;
+
+  s->saved_cb = lr->callbacks.progress_cb;
+  s->saved_data = lr->callbacks.progresscb_data;
+  lr->set_progress_handler(progress, self);
+
+  int ret, cancelled;
+  {
+    ASYNC_LOCK(s); // cancel() sets it from other thread
+    cancelled = s->cancelled;
+  }
+  if (cancelled)
+    ret = LIBRAW_CANCELLED_BY_CALLBACK;
+  else
+  {
+    try
+    {
+      ret = self->run(s->stages);
+    }
+    catch (...)
+    {
+      ret = LIBRAW_UNSUFFICIENT_MEMORY;
+    }
+  }
+
+  lr->set_progress_handler(s->saved_cb, s->saved_data);
+
+  ASYNC_LOCK(s);
+  /* cancel() after the last cancellation point must not stop the next call */
+  lr->clearCancelFlag();
+  if (s->cancelled && ret == LIBRAW_SUCCESS)
+    ret = LIBRAW_CANCELLED_BY_CALLBACK;
+  s->result = ret;
+  s->running = 0;
+  s->done = 1;
+#ifndef LIBRAW_NOTHREADS
+  s->done_cv.notify_all();
+#endif
+}
+
+int LibRaw_async::progress(void *data, enum LibRaw_progress stage,
+                           int iteration, int expected)
+{
+  LibRaw_async *self = static_cast<LibRaw_async *>(data);
+  async_state_t *s = static_cast<async_state_t *>(self->state);
+  {
+    ASYNC_LOCK(s); // read by status() from other thread
+    s->stage = stage;
+    s->iteration = iteration;
+    s->expected = expected;
+  }
+  if (s->saved_cb)
+    return (*s->saved_cb)(s->saved_data, stage, iteration, expected);
+  return 0;
+}
+
+int LibRaw_async::wait(int msec)
+{
+  async_state_t *s = static_cast<async_state_t *>(state);
+#ifndef LIBRAW_NOTHREADS
+  async_lock_t lk(s->lock);
+  if (msec < 0)
+    while (s->running)
+      s->done_cv.wait(lk);
+  else
+  {
+    std::chrono::steady_clock::time_point deadline =
+        std::chrono::steady_clock::now() + std::chrono::milliseconds(msec);
+    while (s->running)
+      if (s->done_cv.wait_until(lk, deadline) == std::cv_status::timeout)
+        break;
+  }
+  if (s->running)
+    return 0;
+  s->join();
+  return 1;
+#else
+  (void)msec;
+  return !s->running;
+#endif
+}
+
+int LibRaw_async::finished()
+{
+  async_state_t *s = static_cast<async_state_t *>(state);
+  ASYNC_LOCK(s);
+  return s->done;
+}
+
+int LibRaw_async::result()
+{
+  async_state_t *s = static_cast<async_state_t *>(state);
+  ASYNC_LOCK(s);
+  return s->result;
+}
+
+void LibRaw_async::cancel()
+{
+  async_state_t *s = static_cast<async_state_t *>(state);
+  ASYNC_LOCK(s);
+  if (!s->running)
+    return;
+  s->cancelled = 1;
+  lr->setCancelFlag();
+}
+
+void LibRaw_async::status(libraw_async_status_t *st)
+{
+  async_state_t *s = static_cast<async_state_t *>(state);
+  if (!st)
+    return;
+  ASYNC_LOCK(s);
+  st->progress_flags = lr ? lr->imgdata.progress_flags : 0;
+  st->stage = (enum LibRaw_progress)s->stage;
+  st->iteration = s->iteration;
+  st->expected = s->expected;
+  st->finished = s->done;
+  st->result = s->result;
+}
+
+LibRaw_async *LibRaw::start_async(unsigned stages)
+{
+  LibRaw_async *a;
+  try
+  {
+    a = new LibRaw_async(this);
+  }
+  catch (...)
+  {
+    return NULL;
+  }
+  if (a->start(stages) != LIBRAW_SUCCESS)
+  {
+    delete a;
+    return NULL;
+  }
+  return a;
+}
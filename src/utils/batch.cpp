@@ -0,0 +1,370 @@
+/* -*- C++ -*-
+ * File: batch.cpp
+ * Copyright 2008-2021 LibRaw LLC (info@libraw.org)
+ *
+ * LibRaw_batch: multi-file processing on a worker pool
+
+LibRaw is free software; you can redistribute it and/or modify
+it under the terms of the one of two licenses as you choose:
+
+1. GNU LESSER GENERAL PUBLIC LICENSE version 2.1
+   (See file LICENSE.LGPL provided in LibRaw distribution archive for details).
+
+2. COMMON DEVELOPMENT AND DISTRIBUTION LICENSE (CDDL) Version 1.0
+   (See file LICENSE.CDDL provided in LibRaw distribution archive for details).
+
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <new>
+#include <deque>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include "libraw/libraw.h"
+#ifndef LIBRAW_NOTHREADS
+#include <mutex>
+#include <thread>
+#endif
+
+namespace
+{
+#ifndef LIBRAW_NOTHREADS
+typedef std::mutex batch_mutex_t;
+typedef std::lock_guard<std::mutex> batch_lock_t;
+#else
+struct batch_mutex_t
+{
+};
+struct batch_lock_t
+{
+  batch_lock_t(batch_mutex_t &) {}
+};
+#endif
+
+/* Per-worker deques of job indices. The owner takes jobs from the front
+   (largest first), idle workers steal from the back of the longest queue */
+struct batch_sched_t
+{
+  std::vector<std::deque<int> > queues;
+  std::vector<batch_mutex_t> qlocks;
+  std::vector<LibRaw *> procs;
+  batch_mutex_t procs_lock, callback_lock;
+  int cancelled; /* guarded by procs_lock */
+  int budget, alive;
+
+  batch_sched_t() : cancelled(0), budget(1), alive(0) {}
+
+  void setup(int nworkers)
+  {
+    queues.assign(nworkers, std::deque<int>());
+    std::vector<batch_mutex_t>(nworkers).swap(qlocks);
+    procs.assign(nworkers, (LibRaw *)NULL);
+    alive = nworkers;
+  }
+
+  int next(int w)
+  {
+    {
+      batch_lock_t lk(qlocks[w]);
+      if (!queues[w].empty())
+      {
+        int idx = queues[w].front();
+        queues[w].pop_front();
+        return idx;
+      }
+    }
+    for (;;)
+    {
+      int victim = -1;
+      size_t len = 0;
+      for (int v = 0; v < (int)queues.size(); v++)
+      {
+        if (v == w)
+          continue;
+        batch_lock_t lk(qlocks[v]);
+        if (queues[v].size() > len)
+        {
+          len = queues[v].size();
+          victim = v;
+        }
+      }
+      if (victim < 0)
+        return -1;
+      batch_lock_t lk(qlocks[victim]);
+      if (!queues[victim].empty())
+      {
+        int idx = queues[victim].back();
+        queues[victim].pop_back();
+        return idx;
+      }
+      /* emptied by its owner meanwhile, rescan */
+    }
+  }
+
+  int is_cancelled()
+  {
+    batch_lock_t lk(procs_lock);
+    return cancelled;
+  }
+
+  int file_threads(unsigned pixels, unsigned small_image)
+  {
+    if (pixels < small_image)
+      return 1;
+    int a;
+    {
+      batch_lock_t lk(procs_lock);
+      a = alive;
+    }
+    return a > 1 ? std::max(1, budget / a) : budget;
+  }
+};
+
+struct batch_order_t
+{
+  const INT64 *fsizes;
+  bool operator()(int a, int b) const
+  {
+    return fsizes[a] != fsizes[b] ? fsizes[a] > fsizes[b] : a < b;
+  }
+};
+
+char *batch_strdup(const char *s)
+{
+  if (!s)
+    return NULL;
+  char *r = (char *)::malloc(strlen(s) + 1);
+  if (r)
+    strcpy(r, s);
+  return r;
+}
+} // namespace
+
+LibRaw_batch::LibRaw_batch(unsigned int _flags)
+    : stages(LIBRAW_BATCH_ALL), workers(0), threads(0),
+      small_image(4 * 1024 * 1024), results(NULL), fsizes(NULL), njobs(0),
+      maxjobs(0), flags(_flags), callback(NULL), callback_data(NULL),
+      sched(NULL)
+{
+  LibRaw *defaults = new LibRaw(flags);
+  params = defaults->imgdata.params;
+  rawparams = defaults->imgdata.rawparams;
+  delete defaults;
+  sched = new batch_sched_t;
+}
+
+LibRaw_batch::~LibRaw_batch()
+{
+  for (int i = 0; i < njobs; i++)
+  {
+    ::free((void *)results[i].input);
+    ::free((void *)results[i].output);
+  }
+  ::free(results);
+  ::free(fsizes);
+  delete static_cast<batch_sched_t *>(sched);
+}
+
+int LibRaw_batch::add(const char *input, const char *output)
+{
+  if (!input)
+    return EINVAL;
+  if (njobs >= maxjobs)
+  {
+    int nmax = maxjobs ? maxjobs * 2 : 64;
+    libraw_batch_result_t *r = (libraw_batch_result_t *)::realloc(
+        results, nmax * sizeof(libraw_batch_result_t));
+    if (!r)
+      return LIBRAW_UNSUFFICIENT_MEMORY;
+    results = r;
+    INT64 *f = (INT64 *)::realloc(fsizes, nmax * sizeof(INT64));
+    if (!f)
+      return LIBRAW_UNSUFFICIENT_MEMORY;
+    fsizes = f;
+    maxjobs = nmax;
+  }
+  libraw_batch_result_t &r = results[njobs];
+  memset(&r, 0, sizeof(r));
+  r.input = batch_strdup(input);
+  r.output = batch_strdup(output);
+  if (!r.input || (output && !r.output))
+  {
+    ::free((void *)r.input);
+    ::free((void *)r.output);
+    return LIBRAW_UNSUFFICIENT_MEMORY;
+  }
+  r.worker = -1;
+  struct stat st;
+  fsizes[njobs] = stat(input, &st) ? 0 : (INT64)st.st_size;
+  njobs++;
+  return LIBRAW_SUCCESS;
+}
+
+void LibRaw_batch::cancel()
+{
+  batch_sched_t *sc = static_cast<batch_sched_t *>(sched);
+  batch_lock_t lk(sc->procs_lock);
+  sc->cancelled = 1;
+  for (size_t i = 0; i < sc->procs.size(); i++)
+    if (sc->procs[i])
+      sc->procs[i]->setCancelFlag();
+}
+
+int LibRaw_batch::process_file(LibRaw *lr, int idx)
+{
+  libraw_batch_result_t &r = results[idx];
+  batch_sched_t *sc = static_cast<batch_sched_t *>(sched);
+
+  lr->imgdata.params = params;
+  lr->imgdata.rawparams = rawparams;
+  if ((r.open_ret = lr->open_file(r.input)) != LIBRAW_SUCCESS)
+    return r.open_ret;
+
+  unsigned pixels = (unsigned)lr->imgdata.sizes.raw_width *
+                    (unsigned)lr->imgdata.sizes.raw_height;
+  r.threads = sc->file_threads(pixels, small_image);
+  if (rawparams.max_threads > 0)
+    r.threads = std::min(r.threads, rawparams.max_threads);
+  lr->imgdata.rawparams.max_threads = r.threads;
+  lr->imgdata.params.max_threads =
+      params.max_threads > 0 ? std::min(r.threads, params.max_threads)
+                             : r.threads;
+
+  if ((stages & LIBRAW_BATCH_UNPACK) &&
+      (r.unpack_ret = lr->unpack()) != LIBRAW_SUCCESS)
+    return r.unpack_ret;
+  if ((stages & LIBRAW_BATCH_PROCESS) &&
+      (r.process_ret = lr->dcraw_process()) != LIBRAW_SUCCESS)
+    return r.process_ret;
+  if ((stages & LIBRAW_BATCH_WRITE) && r.output &&
+      (r.write_ret = lr->dcraw_ppm_tiff_writer(r.output)) != LIBRAW_SUCCESS)
+    return r.write_ret;
+  return LIBRAW_SUCCESS;
+}
+
+void LibRaw_batch::worker(int w)
+{
+  batch_sched_t *sc = static_cast<batch_sched_t *>(sched);
+  LibRaw *lr = NULL;
+  try
+  {
+    lr = create();
+  }
+  catch (...)
+  {
+    lr = NULL;
+  }
+  {
+    batch_lock_t lk(sc->procs_lock);
+    sc->procs[w] = lr;
+  }
+
+  int idx;
+  while (lr && !sc->is_cancelled() && (idx = sc->next(w)) >= 0)
+  {
+    libraw_batch_result_t &r = results[idx];
+    r.worker = w;
+    std::chrono::steady_clock::time_point t0 =
+        std::chrono::steady_clock::now();
+    r.status = process_file(lr, idx);
+    r.seconds = std::chrono::duration<double>(
+                    std::chrono::steady_clock::now() - t0)
+                    .count();
+    if (callback)
+    {
+      batch_lock_t lk(sc->callback_lock);
+      if ((*callback)(callback_data, &lr->imgdata, &r))
+        cancel();
+    }
+    lr->recycle();
+  }
+
+  {
+    batch_lock_t lk(sc->procs_lock);
+    sc->procs[w] = NULL;
+    sc->alive--;
+  }
+  delete lr;
+}
+
+int LibRaw_batch::run()
+{
+  batch_sched_t *sc = static_cast<batch_sched_t *>(sched);
+  if (!njobs)
+    return 0;
+
+  int budget = threads;
+  if (budget < 1)
+  {
+#ifdef LIBRAW_USE_OPENMP
+    budget = omp_get_max_threads();
+#elif !defined(LIBRAW_NOTHREADS)
+    budget = (int)std::thread::hardware_concurrency();
+#endif
+    if (budget < 1)
+      budget = 1;
+  }
+#ifdef LIBRAW_NOTHREADS
+  int nw = 1;
+#else
+  int nw = workers > 0 ? workers : budget;
+#endif
+  if (nw > njobs)
+    nw = njobs;
+
+  for (int i = 0; i < njobs; i++)
+  {
+    libraw_batch_result_t &r = results[i];
+    r.open_ret = r.unpack_ret = r.process_ret = r.write_ret = LIBRAW_SUCCESS;
+    r.status = LIBRAW_CANCELLED_BY_CALLBACK; /* until processed */
+    r.worker = -1;
+    r.threads = 0;
+    r.seconds = 0.0;
+  }
+
+  /* largest files first, dealt round-robin so every queue gets a share */
+  std::vector<int> order(njobs);
+  for (int i = 0; i < njobs; i++)
+    order[i] = i;
+  batch_order_t cmp = {fsizes};
+  std::sort(order.begin(), order.end(), cmp);
+
+  sc->setup(nw);
+  sc->budget = budget;
+  {
+    batch_lock_t lk(sc->procs_lock);
+    sc->cancelled = 0;
+  }
+  for (int i = 0; i < njobs; i++)
+    sc->queues[i % nw].push_back(order[i]);
+
+#ifndef LIBRAW_NOTHREADS
+  std::vector<std::thread> pool;
+  try
+  {
+    for (int w = 1; w < nw; w++)
+      pool.push_back(std::thread(&LibRaw_batch::worker, this, w));
+  }
+  catch (...)
+  {
+    /* fewer threads: the rest of the queued files are stolen */
+    batch_lock_t lk(sc->procs_lock);
+    sc->alive -= nw - 1 - (int)pool.size();
+  }
+  worker(0);
+  for (size_t i = 0; i < pool.size(); i++)
+    pool[i].join();
+#else
+  worker(0);
+#endif
+
+  int failed = 0;
+  for (int i = 0; i < njobs; i++)
+    if (results[i].status != LIBRAW_SUCCESS)
+      failed++;
+  return failed;
+}
@@ -14,6 +14,9 @@
  */
 
 #include "../../internal/libraw_cxx_defs.h"
+#ifndef LIBRAW_NOTHREADS
+#include <mutex>
+#endif
 
 static void cleargps(libraw_gps_info_t *q)
 {
@@ -25,28 +28,44 @@ static void cleargps(libraw_gps_info_t *q)
 
 LibRaw::LibRaw(unsigned int flags) : memmgr(1024)
 {
-  double aber[4] = {1, 1, 1, 1};
-  double gamm[6] = {0.45, 4.5, 0, 0, 0, 0};
-  unsigned greybox[4] = {0, 0, UINT_MAX, UINT_MAX};
-  unsigned cropbox[4] = {0, 0, UINT_MAX, UINT_MAX};
   ZERO(imgdata);
 
   cleargps(&imgdata.other.parsed_gps);
   ZERO(libraw_internal_data);
-  ZERO(callbacks);
 
+  /* RawSpeed camera metadata is parsed on first use in unpack() */
   _rawspeed_camerameta = _rawspeed_decoder = NULL;
+  render_cache = NULL;
   dnghost = NULL;
   dngnegative = NULL;
   dngimage = NULL;
   _x3f_data = NULL;
 
-#ifdef USE_RAWSPEED
-  CameraMetaDataLR *camerameta =
-      make_camera_metadata(); // May be NULL in case of exception in
-                              // make_camera_metadata()
-  _rawspeed_camerameta = static_cast<void *>(camerameta);
-#endif
+  init_default_params(flags);
+
+  imgdata.parent_class = this;
+  imgdata.progress_flags = 0;
+  imgdata.color.dng_levels.baseline_exposure = -999.f;
+  imgdata.color.dng_levels.LinearResponseLimit = 1.0f;
+  MN.hasselblad.nIFD_CM[0] =
+    MN.hasselblad.nIFD_CM[1] = -1;
+  MN.kodak.ISOCalibrationGain = 1.0f;
+  _exitflag = 0;
+  tls = new LibRaw_TLS;
+  tls->init();
+}
+
+void LibRaw::init_default_params(unsigned int flags)
+{
+  double aber[4] = {1, 1, 1, 1};
+  double gamm[6] = {0.45, 4.5, 0, 0, 0, 0};
+  unsigned greybox[4] = {0, 0, UINT_MAX, UINT_MAX};
+  unsigned cropbox[4] = {0, 0, UINT_MAX, UINT_MAX};
+
+  ZERO(imgdata.params);
+  ZERO(imgdata.rawparams);
+  ZERO(callbacks);
+
   callbacks.mem_cb = (flags & LIBRAW_OPIONS_NO_MEMERR_CALLBACK)
                          ? NULL
                          : &default_memory_callback;
@@ -93,16 +112,12 @@ LibRaw::LibRaw(unsigned int flags) : memmgr(1024)
   imgdata.params.green_matching = 0;
   imgdata.rawparams.custom_camera_strings = 0;
   imgdata.rawparams.coolscan_nef_gamma = 1.0f;
-  imgdata.parent_class = this;
-  imgdata.progress_flags = 0;
-  imgdata.color.dng_levels.baseline_exposure = -999.f;
-  imgdata.color.dng_levels.LinearResponseLimit = 1.0f;
-  MN.hasselblad.nIFD_CM[0] =
-    MN.hasselblad.nIFD_CM[1] = -1;
-  MN.kodak.ISOCalibrationGain = 1.0f;
-  _exitflag = 0;
-  tls = new LibRaw_TLS;
-  tls->init();
+}
+
+void LibRaw::reset(unsigned int flags)
+{
+  recycle();
+  init_default_params(flags);
 }
 
 LibRaw::~LibRaw()
@@ -125,6 +140,7 @@ void x3f_clear(void *);
 void LibRaw::recycle()
 {
   recycle_datastream();
+  end_render_session();
 #define FREE(a)                                                                \
   do                                                                           \
   {                                                                            \
@@ -145,6 +161,7 @@ void LibRaw::recycle()
   FREE(libraw_internal_data.internal_data.meta_data);
   FREE(libraw_internal_data.output_data.histogram);
   FREE(libraw_internal_data.output_data.oprof);
+  libraw_internal_data.output_data.outbuf = NULL;
   FREE(imgdata.color.profile);
   FREE(imgdata.rawdata.ph1_cblack);
   FREE(imgdata.rawdata.ph1_rblack);
@@ -164,6 +181,7 @@ void LibRaw::recycle()
   ZERO(imgdata.rawdata);
   ZERO(imgdata.shootinginfo);
   ZERO(imgdata.thumbnail);
+  ZERO(imgdata.thumbs_list);
   ZERO(MN);
   cleargps(&imgdata.other.parsed_gps);
   ZERO(libraw_internal_data);
@@ -317,3 +335,98 @@ void LibRaw::recycle()
 
   tls->init();
 }
+
+LibRaw_pool::LibRaw_pool(unsigned max_idle, unsigned int _flags)
+    : nidle(0), maxidle(max_idle), flags(_flags), mutex(NULL)
+{
+  idle = (LibRaw **)::calloc(maxidle ? maxidle : 1, sizeof(LibRaw *));
+  if (!idle)
+    maxidle = 0;
+#ifndef LIBRAW_NOTHREADS
+  mutex = new std::mutex;
+#endif
+}
+
+LibRaw_pool::~LibRaw_pool()
+{
+  for (unsigned i = 0; i < nidle; i++)
+    delete idle[i];
+  ::free(idle);
+#ifndef LIBRAW_NOTHREADS
+  delete static_cast<std::mutex *>(mutex);
+#endif
+}
+
+void LibRaw_pool::lock()
+{
+#ifndef LIBRAW_NOTHREADS
+  static_cast<std::mutex *>(mutex)->lock();
+#endif
+}
+
+void LibRaw_pool::unlock()
+{
+#ifndef LIBRAW_NOTHREADS
+  static_cast<std::mutex *>(mutex)->unlock();
+#endif
+}
+
+LibRaw *LibRaw_pool::acquire()
+{
+  LibRaw *lr = NULL;
+  lock();
+  if (nidle)
+    lr = idle[--nidle];
+  unlock();
+  return lr ? lr : create();
+}
+
+void LibRaw_pool::release(LibRaw *lr)
+{
+  if (!lr)
+    return;
+  lr->reset(flags);
+  lock();
+  if (nidle < maxidle)
+  {
+    idle[nidle++] = lr;
+    lr = NULL;
+  }
+  unlock();
+  delete lr;
+}
+
+void LibRaw_pool::reserve(unsigned count)
+{
+  if (count > maxidle)
+    count = maxidle;
+  for (;;)
+  {
+    lock();
+    int full = nidle >= count;
+    unlock();
+    if (full)
+      break;
+    LibRaw *lr = create();
+    lock();
+    if (nidle < maxidle)
+    {
+      idle[nidle++] = lr;
+      lr = NULL;
+    }
+    unlock();
+    if (lr)
+    {
+      delete lr;
+      break;
+    }
+  }
+}
+
+unsigned LibRaw_pool::idle_count()
+{
+  lock();
+  unsigned n = nidle;
+  unlock();
+  return n;
+}
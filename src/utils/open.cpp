@@ -441,6 +441,28 @@ struct foveon_data_t
 };
 const int foveon_count = sizeof(foveon_data) / sizeof(foveon_data[0]);
 
+/* Metadata-only open: input is switched to a block cache while parsing,
+   the original stream is restored when open_datastream() leaves its
+   try block, on success or exception */
+struct libraw_prefetch_guard
+{
+  LibRaw_abstract_datastream *&input;
+  LibRaw_abstract_datastream *parent;
+  LibRaw_prefetch_datastream *cache;
+  libraw_prefetch_guard(LibRaw_abstract_datastream *&in,
+                        LibRaw_abstract_datastream *stream, bool enable)
+      : input(in), parent(stream),
+        cache(enable ? new LibRaw_prefetch_datastream(stream) : 0)
+  {
+    input = cache ? (LibRaw_abstract_datastream *)cache : stream;
+  }
+  ~libraw_prefetch_guard()
+  {
+    input = parent;
+    delete cache;
+  }
+};
+
 int LibRaw::open_datastream(LibRaw_abstract_datastream *stream)
 {
 
@@ -458,7 +480,9 @@ int LibRaw::open_datastream(LibRaw_abstract_datastream *stream)
 
   try
   {
-	  ID.input = stream;
+	  ID.metadata_only =
+		  (imgdata.rawparams.options & LIBRAW_RAWOPTIONS_METADATA_ONLY) ? 1 : 0;
+	  libraw_prefetch_guard prefetch(ID.input, stream, ID.metadata_only != 0);
 	  SET_PROC_FLAG(LIBRAW_PROGRESS_OPEN);
 
 	  identify();
@@ -489,8 +513,8 @@ int LibRaw::open_datastream(LibRaw_abstract_datastream *stream)
           memset(imgdata.color.WBCT_Coeffs, 0, sizeof(imgdata.color.WBCT_Coeffs));
       }
 
-	  if (load_raw == &LibRaw::nikon_load_raw)
-		  nikon_read_curve();
+	  if (load_raw == &LibRaw::nikon_load_raw && !ID.metadata_only)
+		  nikon_read_curve(); // decoding curve, not needed for metadata
 
 	  if (load_raw == &LibRaw::lossless_jpeg_load_raw &&
 		  MN.canon.RecordMode && makeIs(LIBRAW_CAMERAMAKER_Kodak) &&
@@ -1039,6 +1063,8 @@ int LibRaw::open_datastream(LibRaw_abstract_datastream *stream)
         C.maximum=0xffff;
       }
 #endif
+    list_default_thumbnail();
+
     if (C.profile_length)
     {
       if (C.profile)
@@ -1066,6 +1092,13 @@ int LibRaw::open_datastream(LibRaw_abstract_datastream *stream)
 
 final:;
 
+#ifdef USE_X3FTOOLS
+  /* x3f object keeps the stream it was parsed from, the prefetch cache
+     is deleted by now */
+  if (_x3f_data)
+    x3f_set_input(ID.input);
+#endif
+
   if (P1.raw_count < 1)
     return LIBRAW_FILE_UNSUPPORTED;
 
@@ -1078,8 +1111,8 @@ final:;
   }
 
   IO.shrink =
-      P1.filters &&
-      (O.half_size || ((O.threshold || O.aber[0] != 1 || O.aber[2] != 1)));
+      P1.filters && (O.half_size || O.preview_scale > 1 ||
+                     ((O.threshold || O.aber[0] != 1 || O.aber[2] != 1)));
   if (IO.shrink && P1.filters >= 1000)
   {
     S.width &= 65534;
@@ -227,6 +227,146 @@ void LibRaw::kodak_thumb_loader()
   libraw_internal_data.unpacker_data.load_flags = s_flags;
 }
 
+int LibRaw::add_thumbnail(enum LibRaw_thumbnail_formats fmt, INT64 offset,
+                          unsigned length, ushort width, ushort height,
+                          unsigned misc)
+{
+  libraw_thumbnail_list_t &tl = imgdata.thumbs_list;
+  if (offset <= 0 || !ID.input || offset + INT64(length) > ID.input->size())
+    return -1;
+  for (int i = 0; i < tl.thumbcount; i++)
+    if (tl.thumblist[i].toffset == offset)
+      return i;
+  if (tl.thumbcount >= LIBRAW_THUMBNAIL_MAXCOUNT)
+    return -1;
+  libraw_thumbnail_item_t &t = tl.thumblist[tl.thumbcount];
+  t.tformat = fmt;
+  t.twidth = width;
+  t.theight = height;
+  t.tlength = length;
+  t.tmisc = misc;
+  t.toffset = offset;
+  return tl.thumbcount++;
+}
+
+/* TIFF IFD that passed apply_tiff() thumbnail checks; formats the
+   thumbnail loaders can't read without identify() state are not listed */
+void LibRaw::list_tiff_thumbnail(int ifd)
+{
+  enum LibRaw_thumbnail_formats fmt;
+  switch (tiff_ifd[ifd].comp)
+  {
+  case 0:
+    fmt = LIBRAW_THUMBNAIL_LAYER;
+    break;
+  case 1:
+    if (tiff_ifd[ifd].bps <= 8)
+      fmt = LIBRAW_THUMBNAIL_BITMAP;
+    else if (!strncmp(imgdata.idata.make, "Imacon", 6))
+      fmt = LIBRAW_THUMBNAIL_BITMAP16;
+    else
+      return;
+    break;
+  case 6:
+  case 7:
+    fmt = LIBRAW_THUMBNAIL_JPEG;
+    break;
+  default:
+    return;
+  }
+  add_thumbnail(fmt, tiff_ifd[ifd].offset, tiff_ifd[ifd].bytes,
+                tiff_ifd[ifd].t_width, tiff_ifd[ifd].t_height,
+                tiff_ifd[ifd].bps | tiff_ifd[ifd].samples << 5);
+}
+
+/* thumbnail selected by identify(), including makernote previews */
+void LibRaw::list_default_thumbnail()
+{
+  libraw_thumbnail_list_t &tl = imgdata.thumbs_list;
+  enum LibRaw_thumbnail_formats fmt = LIBRAW_THUMBNAIL_UNKNOWN;
+
+  default_write_thumb = write_thumb;
+  default_thumb_load_raw = thumb_load_raw;
+  ID.thumb_default = tl.thumbselected = -1;
+  ID.thumb_default_colors = T.tcolors;
+
+  if (thumb_load_raw)
+    fmt = LIBRAW_THUMBNAIL_BITMAP;
+  else if (write_thumb == &LibRaw::jpeg_thumb)
+    fmt = load_raw == &LibRaw::crxLoadRaw ? LIBRAW_THUMBNAIL_UNKNOWN // H.265?
+                                          : LIBRAW_THUMBNAIL_JPEG;
+  else if (write_thumb == &LibRaw::layer_thumb)
+    fmt = LIBRAW_THUMBNAIL_LAYER;
+  else if (write_thumb == &LibRaw::rollei_thumb)
+    fmt = LIBRAW_THUMBNAIL_ROLLEI;
+  else if (write_thumb == &LibRaw::ppm_thumb)
+    fmt = LIBRAW_THUMBNAIL_BITMAP;
+  else if (write_thumb == &LibRaw::ppm16_thumb)
+    fmt = LIBRAW_THUMBNAIL_BITMAP16;
+
+  int i = add_thumbnail(fmt, ID.toffset, T.tlength, T.twidth, T.theight,
+                        libraw_internal_data.unpacker_data.thumb_misc);
+  if (i < 0)
+  {
+    if (tl.thumbcount < LIBRAW_THUMBNAIL_MAXCOUNT || ID.toffset <= 0 ||
+        ID.toffset + INT64(T.tlength) > ID.input->size())
+      return;
+    i = LIBRAW_THUMBNAIL_MAXCOUNT - 1; /* list is full: replace last */
+  }
+  libraw_thumbnail_item_t &t = tl.thumblist[i];
+  t.tformat = fmt;
+  t.twidth = T.twidth;
+  t.theight = T.theight;
+  t.tlength = T.tlength;
+  t.tmisc = libraw_internal_data.unpacker_data.thumb_misc;
+  t.toffset = ID.toffset;
+  ID.thumb_default = tl.thumbselected = i;
+}
+
+/* make thumbs_list entry the one unpack_thumb() loads */
+int LibRaw::select_thumbnail(int idx)
+{
+  libraw_thumbnail_list_t &tl = imgdata.thumbs_list;
+  if (idx < 0 || idx >= tl.thumbcount)
+    return LIBRAW_REQUEST_FOR_NONEXISTENT_IMAGE;
+  libraw_thumbnail_item_t &t = tl.thumblist[idx];
+  if (idx == ID.thumb_default)
+  {
+    write_thumb = default_write_thumb;
+    thumb_load_raw = default_thumb_load_raw;
+    T.tcolors = ID.thumb_default_colors;
+  }
+  else
+  {
+    thumb_load_raw = 0;
+    switch (t.tformat)
+    {
+    case LIBRAW_THUMBNAIL_JPEG:
+      write_thumb = &LibRaw::jpeg_thumb;
+      break;
+    case LIBRAW_THUMBNAIL_LAYER:
+      write_thumb = &LibRaw::layer_thumb;
+      break;
+    case LIBRAW_THUMBNAIL_BITMAP:
+      write_thumb = &LibRaw::ppm_thumb;
+      break;
+    case LIBRAW_THUMBNAIL_BITMAP16:
+      write_thumb = &LibRaw::ppm16_thumb;
+      break;
+    default:
+      return LIBRAW_UNSUPPORTED_THUMBNAIL;
+    }
+    T.tcolors = 0;
+  }
+  ID.toffset = t.toffset;
+  T.tlength = t.tlength;
+  T.twidth = t.twidth;
+  T.theight = t.theight;
+  libraw_internal_data.unpacker_data.thumb_misc = t.tmisc;
+  tl.thumbselected = idx;
+  return LIBRAW_SUCCESS;
+}
+
 // ������� thumbnail �� �����, ������ thumb_format � ������������ � ��������
 
 int LibRaw::thumbOK(INT64 maxsz)
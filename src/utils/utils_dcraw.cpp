@@ -180,14 +180,15 @@ void LibRaw::remove_zeroes()
       }
   RUN_CALLBACK(LIBRAW_PROGRESS_REMOVE_ZEROES, 1, 2);
 }
-void LibRaw::crop_masked_pixels()
+/* fills in mask[] for decoders with fixed masked borders, once per unpack() */
+void LibRaw::set_masked_areas()
 {
-  int row, col;
-  unsigned c, m, zero, val;
-#define mblack imgdata.color.black_stat
+  if (libraw_internal_data.unpacker_data.masked_areas_set)
+    return;
+  libraw_internal_data.unpacker_data.masked_areas_set = 1;
 
   if (mask[0][3] > 0)
-    goto mask_set;
+    return;
   if (load_raw == &LibRaw::canon_load_raw ||
       load_raw == &LibRaw::lossless_jpeg_load_raw ||
       load_raw == &LibRaw::crxLoadRaw)
@@ -219,7 +220,15 @@ void LibRaw::crop_masked_pixels()
     mask[0][2] = top_margin;
     mask[0][3] = width;
   }
-mask_set:
+}
+
+void LibRaw::crop_masked_pixels()
+{
+  int row, col;
+  unsigned c, m, zero, val;
+#define mblack imgdata.color.black_stat
+
+  set_masked_areas();
   memset(mblack, 0, sizeof mblack);
   for (zero = m = 0; m < 8; m++)
     for (row = MAX(mask[m][0], 0); row < MIN(mask[m][2], raw_height); row++)
@@ -14,6 +14,9 @@
  */
 
 #include "../../internal/libraw_cxx_defs.h"
+#if !defined(LIBRAW_USE_OPENMP) && !defined(LIBRAW_NOTHREADS)
+#include <thread>
+#endif
 
 #ifdef __cplusplus
 extern "C"
@@ -55,6 +58,8 @@ extern "C"
       return "Unsupported thumbnail format";
     case LIBRAW_INPUT_CLOSED:
       return "No input stream, or input stream closed";
+    case LIBRAW_BAD_OUTPUT_BUFFER:
+      return "Bad output buffer or buffer too small";
     case LIBRAW_MEMPOOL_OVERFLOW:
       return "Libraw internal mempool overflowed";
     case LIBRAW_UNSUFFICIENT_MEMORY:
@@ -338,6 +343,83 @@ void LibRaw::checkCancel()
 #endif
 }
 
+int LibRaw::cancelRequested()
+{
+#ifdef _MSC_VER
+  return InterlockedCompareExchange(&_exitflag, 0, 0) != 0;
+#else
+  return __sync_fetch_and_add(&_exitflag, 0) != 0;
+#endif
+}
+
+static int libraw_thread_budget(int limit, int dflt)
+{
+#ifdef LIBRAW_USE_OPENMP
+  int n = omp_get_max_threads();
+  return (limit > 0 && limit < n) ? limit : n;
+#else
+  return limit > 0 ? limit : dflt;
+#endif
+}
+
+/* Without OpenMP there is nothing to serialize input access of parallel
+   decoder tasks (datastream lock() is a no-op), so raw decoding is serial */
+int LibRaw::raw_threads()
+{
+#ifdef LIBRAW_USE_OPENMP
+  return libraw_thread_budget(imgdata.rawparams.max_threads, 1);
+#else
+  return 1;
+#endif
+}
+
+int LibRaw::process_threads()
+{
+  return libraw_thread_budget(imgdata.params.max_threads, 0);
+}
+
+/* number of chunks (and per-chunk buffers) for count work items */
+int LibRaw::parallel_width(int count, int nthreads)
+{
+  if (count < 1)
+    return 1;
+  if (callbacks.executor_cb && nthreads != 1)
+  {
+    if (nthreads < 1) // no limit: executor runs one chunk per CPU at most
+    {
+#if !defined(LIBRAW_USE_OPENMP) && !defined(LIBRAW_NOTHREADS)
+      nthreads = (int)std::thread::hardware_concurrency();
+#else
+      nthreads = libraw_thread_budget(0, 1);
+#endif
+    }
+    return MAX(1, MIN(nthreads, count));
+  }
+#ifdef LIBRAW_USE_OPENMP
+  return MAX(1, MIN(nthreads, count));
+#else
+  return 1;
+#endif
+}
+
+void LibRaw::run_parallel(int count, int nthreads, libraw_task_function task,
+                          void *data)
+{
+  if (count < 1)
+    return;
+  if (callbacks.executor_cb && count > 1 && nthreads != 1)
+  {
+    (*callbacks.executor_cb)(callbacks.executor_data, count, MAX(nthreads, 0),
+                             task, data);
+    return;
+  }
+#ifdef LIBRAW_USE_OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(parallel_width(count, nthreads))
+#endif
+  for (int i = 0; i < count; i++)
+    (*task)(data, i);
+}
+
 int LibRaw::is_curve_linear()
 {
   for (int i = 0; i < 0x10000; i++)
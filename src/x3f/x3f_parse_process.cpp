@@ -104,6 +104,13 @@ static void *lr_memmem(const void *l, size_t l_len, const void *s, size_t s_len)
   return NULL;
 }
 
+void LibRaw::x3f_set_input(LibRaw_abstract_datastream *stream)
+{
+  x3f_t *x3f = (x3f_t *)_x3f_data;
+  if (x3f)
+    x3f->info.input.file = stream;
+}
+
 void LibRaw::parse_x3f()
 {
   x3f_t *x3f = x3f_new_from_file(libraw_internal_data.internal_data.input);